@@ -9331,3 +9331,27 @@ __kernel void gpu_memset (__global uint4 *buf, const u32 value, const u32 gid_ma
 
   buf[gid] = (uint4) (value);
 }
+
+__kernel void gpu_decompress (__global pw_idx_t *pws_idx, __global u32 *pws_comp, __global pw_t *pws_buf, const u32 gid_max)
+{
+  const u32 gid = get_global_id (0);
+
+  if (gid >= gid_max) return;
+
+  const u32 off = pws_idx[gid].off;
+  const u32 cnt = pws_idx[gid].cnt;
+  const u32 len = pws_idx[gid].len;
+
+  pw_t pw;
+
+  for (u32 i = 0; i < 16; i++) pw.i[i] = 0;
+
+  for (u32 i = 0, j = off; i < cnt; i++, j++)
+  {
+    pw.i[i] = pws_comp[j];
+  }
+
+  pw.pw_len = len;
+
+  pws_buf[gid] = pw;
+}
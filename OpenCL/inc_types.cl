@@ -1346,6 +1346,14 @@ typedef struct
 
 } pw_t;
 
+typedef struct
+{
+  u32 off;
+  u32 cnt;
+  u32 len;
+
+} pw_idx_t;
+
 typedef struct
 {
   u32 i;
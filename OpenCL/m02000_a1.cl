@@ -12,6 +12,26 @@ __kernel void gpu_memset (__global uint4 *buf, const uint value, const uint gid_
   buf[gid] = (uint4) (value);
 }
 
+__kernel void gpu_decompress (__global uint *pws_idx, __global uint *pws_comp, __global uint *pws_buf, const uint gid_max)
+{
+  const uint gid = get_global_id (0);
+
+  if (gid >= gid_max) return;
+
+  // same layout as pw_idx_t and pw_t in inc_types.cl, which this kernel does not include
+
+  const uint off = pws_idx[gid * 3 + 0];
+  const uint cnt = pws_idx[gid * 3 + 1];
+  const uint len = pws_idx[gid * 3 + 2];
+
+  for (uint i = 0; i < 16; i++)
+  {
+    pws_buf[gid * 20 + i] = (i < cnt) ? pws_comp[off + i] : 0;
+  }
+
+  pws_buf[gid * 20 + 16] = len;
+}
+
 __kernel void m02000_m04 (__global void *pws, __global void *rules_buf, __global void *combs_buf, __global void * words_buf_r, __global void *tmps, __global void *hooks, __global void *bitmaps_buf_s1_a, __global void *bitmaps_buf_s1_b, __global void *bitmaps_buf_s1_c, __global void *bitmaps_buf_s1_d, __global void *bitmaps_buf_s2_a, __global void *bitmaps_buf_s2_b, __global void *bitmaps_buf_s2_c, __global void *bitmaps_buf_s2_d, __global void *plains_buf, __global void *digests_buf, __global void *hashes_shown, __global void *salt_bufs, __global void *esalt_bufs, __global void *d_return_buf, __global void *d_scryptV0_buf, __global void *d_scryptV1_buf, __global void *d_scryptV2_buf, __global void *d_scryptV3_buf, const uint bitmap_mask, const uint bitmap_shift1, const uint bitmap_shift2, const uint salt_pos, const uint loop_pos, const uint loop_cnt, const uint il_cnt, const uint digests_cnt, const uint digests_offset, const uint combs_mode, const uint gid_max)
 {
 }
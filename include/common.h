@@ -39,6 +39,12 @@
 #include <dlfcn.h>
 #include <pwd.h>
 #include <limits.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 
 #ifdef __linux__
 #include <termios.h>
@@ -117,6 +123,19 @@ typedef uint32_t uint; // we need to get rid of this sooner or later, for consis
 #define SPEED_CACHE   128
 #define SPEED_MAXAGE  4096
 
+#define STAGE_WORDS   0 // wordlist read, host rules, pw_add
+#define STAGE_AMP     1 // amplifier preparation (mp kernels, rule/comb/bf buffer copies)
+#define STAGE_COPY    2 // run_copy
+#define STAGE_KERNEL  3 // choose_kernel
+#define STAGE_CHECK   4 // check_cracked
+#define STAGE_OUTPUT  5 // potfile, outfile and loopback writes
+#define STAGE_CNT     6
+
+#define BENCHMARK_REPEATS_MAX  100
+
+#define TRACE_TID_HOST    1 // host side of a device thread
+#define TRACE_TID_DEVICE  2 // kernel execution on the device
+
 #define HCBUFSIZ      0x50000 // general large space buffer size in case the size is unknown at compile-time
 
 #define EXPECTED_ITERATIONS 10000
@@ -173,13 +173,42 @@ static inline int  CPU_ISSET (int num, cpu_set_t *cs) { return (cs->count & (1 <
 #define SP_ROOT_CNT             (SP_PW_MAX * CHARSIZ)
 #define SP_MARKOV_CNT           (SP_PW_MAX * CHARSIZ * CHARSIZ)
 
+#define SP_HCSTAT2_MAGIC        0x0032544154534348ULL // "HCSTAT2\0"
+#define SP_HCSTAT2_VERSION      1
+#define SP_HCSTAT2_SECTIONS_MAX 3
+
+#define SP_SECTION_ROOT         1
+#define SP_SECTION_MARKOV       2
+#define SP_SECTION_MARKOV2      3
+
+#define SP_ENCODING_RAW         0
+#define SP_ENCODING_ZRLE        1
+#define SP_ENCODING_SPARSE      2
+
+#define SP_TRAIN_ORDER_MIN      1
+#define SP_TRAIN_ORDER_MAX      2
+#define SP_TRAIN_THREADS_MAX    8
+
 #define TUNING_DB_FILE          "hashcat.hctune"
+#define TUNING_DB_LEARNED_FILE  "hashcat.hctune.learned"
+#define TUNING_DB_LEARNED_SIGNATURE "# hashcat learned tuning-db v2"
+
+#define RULE_STATS_SIGNATURE    "# hashcat rule stats v1"
+
+#define WL_COMPILED_MAGIC       0x0000544349444348ULL // "HCDICT\0\0"
+#define WL_COMPILED_VERSION     1
+#define WL_COMPILED_BUFSIZ      HCBUFSIZ
 
 #define INDUCT_DIR              "induct"
 #define OUTFILES_DIR            "outfiles"
 
 #define LOOPBACK_FILE           "hashcat.loopback"
 
+#define BLOOM_HASHES            4
+
+#define NETNTLMV1_KEYS          0x10000
+#define NETNTLMV1_THREADS_MAX   32
+
 #define DICTSTAT_FILENAME       "hashcat.dictstat"
 #define POTFILE_FILENAME        "hashcat.pot"
 
@@ -216,6 +245,7 @@ extern const char *PROMPT;
 extern int SUPPRESS_OUTPUT;
 
 extern hc_thread_mutex_t mux_display;
+extern hc_thread_mutex_t mux_trace;
 
 /**
  * Strings
@@ -1318,6 +1348,14 @@ extern hc_thread_mutex_t mux_display;
 #define ST_0009 "Running (stop at checkpoint)"
 #define ST_0010 "Autotuning"
 
+/**
+ * autotune result source
+ */
+
+#define AUTOTUNE_FIXED            0
+#define AUTOTUNE_LEARNED          1
+#define AUTOTUNE_TUNED            2
+
 /**
  * kernel types
  */
@@ -1351,6 +1389,10 @@ u8  hex_to_u8   (const u8 hex[2]);
 u32 hex_to_u32  (const u8 hex[8]);
 u64 hex_to_u64  (const u8 hex[16]);
 
+int  is_valid_hex_string (const u8 *s, const int len);
+int  hex_decode          (const u8 *in_buf, const int in_len, u8 *out_buf);
+uint convert_from_hex    (char *line_buf, const uint line_len, const uint hex_wordlist);
+
 void dump_hex (const u8 *s, const int sz);
 
 void truecrypt_crc32 (const char *filename, u8 keytab[64]);
@@ -1363,6 +1405,17 @@ uint count_lines (FILE *fd);
 
 void *rulefind (const void *key, void *base, int nmemb, size_t size, int (*compar) (const void *, const void *));
 
+void bloom_init (bloom_t *bloom, const u64 size);
+void bloom_free (bloom_t *bloom);
+int  bloom_test (const bloom_t *bloom, const u8 *buf, const uint len);
+int  bloom_add  (bloom_t *bloom, const u8 *buf, const uint len);
+
+int  wl_compile         (const char *outfile, char **infiles, const int infiles_cnt, char *rule_buf, const int rule_len, const uint hex_wordlist);
+int  wl_compiled_open   (wl_compiled_t *wlc, FILE *fp, const uint len_min, const uint len_max);
+void wl_compiled_seek   (wl_compiled_t *wlc, u64 word_pos);
+int  wl_compiled_next   (wl_compiled_t *wlc, char **out_buf, uint *out_len);
+void wl_compiled_close  (wl_compiled_t *wlc);
+
 int sort_by_u32          (const void *p1, const void *p2);
 int sort_by_mtime        (const void *p1, const void *p2);
 int sort_by_cpu_rule     (const void *p1, const void *p2);
@@ -1393,6 +1446,12 @@ int sort_by_digest_p0p1  (const void *v1, const void *v2);
 // special version for hccap (last 2 uints should be skipped where the digest is located)
 int sort_by_hash_t_salt_hccap (const void *v1, const void *v2);
 
+// orders salt indices by ESSID (hccap), salts with the same ESSID share the same PMK
+int sort_by_salt_essid (const void *v1, const void *v2);
+
+// orders salt indices by uncracked digests per iteration, highest first
+int sort_by_salt_iter (const void *v1, const void *v2);
+
 void format_debug (char * debug_file, uint debug_mode, unsigned char *orig_plain_ptr, uint orig_plain_len, unsigned char *mod_plain_ptr, uint mod_plain_len, char *rule_buf, int rule_len);
 void format_plain (FILE *fp, unsigned char *plain_ptr, uint plain_len, uint outfile_autohex);
 void format_output (FILE *out_fp, char *out_buf, unsigned char *plain_ptr, const uint plain_len, const u64 crackpos, unsigned char *username, const uint user_len);
@@ -1437,6 +1496,12 @@ char *logfile_generate_topid ();
 char *logfile_generate_subid ();
 void logfile_append (const char *fmt, ...);
 
+int trace_open (const char *trace_file);
+void trace_close ();
+double trace_now_us ();
+void trace_span (const uint device_id, const uint tid, const char *name, const double ts_us, const double dur_us);
+void trace_device_names ();
+
 #if F_SETLKW
 void lock_file (FILE *fp);
 void unlock_file (FILE *fp);
@@ -1489,7 +1554,13 @@ void hm_device_val_to_str (char *target_buf, int max_buf_size, char *suffix, int
 void myabort ();
 void myquit ();
 
+void SuspendThreads ();
+void ResumeThreads ();
+void bypass ();
+void stop_at_checkpoint ();
+
 void set_cpu_affinity (char *cpu_affinity);
+uint get_cpu_cnt ();
 
 void usage_mini_print (const char *progname);
 void usage_big_print  (const char *progname);
@@ -1502,20 +1573,35 @@ u64 mp_get_sum (uint css_cnt, cs_t *css);
 void mp_setup_sys (cs_t *mp_sys);
 void mp_setup_usr (cs_t *mp_sys, cs_t *mp_usr, char *buf, uint index);
 void mp_reset_usr (cs_t *mp_usr, uint index);
+char *mp_parse_mask_line (char *mask, cs_t *mp_sys, cs_t *mp_usr);
 char *mp_get_truncated_mask (char *mask_buf, size_t mask_len, uint len);
 
 u64 sp_get_sum (uint start, uint stop, cs_t *root_css_buf);
+u64 sp_get_sum_css (uint start, uint stop, cs_t *css_buf, uint threshold);
 void sp_exec (u64 ctx, char *pw_buf, cs_t *root_css_buf, cs_t *markov_css_buf, uint start, uint stop);
 int sp_comp_val (const void *p1, const void *p2);
 void sp_setup_tbl (const char *install_dir, char *hcstat, uint disable, uint classic, hcstat_table_t *root_table_buf, hcstat_table_t *markov_table_buf);
 void sp_tbl_to_css (hcstat_table_t *root_table_buf, hcstat_table_t *markov_table_buf, cs_t *root_css_buf, cs_t *markov_css_buf, uint threshold, uint uniq_tbls[SP_PW_MAX][CHARSIZ]);
 void sp_stretch_markov (hcstat_table_t *in, hcstat_table_t *out);
 void sp_stretch_root (hcstat_table_t *in, hcstat_table_t *out);
+int sp_train (const char *hcstat, char **train_files, const uint train_files_cnt, const uint order, const uint potfile, const char separator);
 
 void tuning_db_destroy (tuning_db_t *tuning_db);
 tuning_db_t *tuning_db_alloc (FILE *fp);
 tuning_db_t *tuning_db_init (const char *tuning_db_file);
 tuning_db_entry_t *tuning_db_search (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type);
+void tuning_db_learned_load (tuning_db_t *tuning_db, const char *learned_file, const uint max_age);
+int  tuning_db_learned_save (tuning_db_t *tuning_db, const char *learned_file);
+tuning_db_learned_t *tuning_db_learned_search (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type, int workload_profile);
+tuning_db_learned_t *tuning_db_learned_search_plan (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type, int workload_profile, const u64 mem_item, const int mem_tmto);
+void tuning_db_learned_update (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type, int workload_profile, const double exec_ms);
+void tuning_db_learned_export (tuning_db_t *tuning_db, FILE *fp);
+
+void rule_stats_load (rule_stats_t *rule_stats, const char *rule_stats_file);
+int  rule_stats_save (rule_stats_t *rule_stats, const char *rule_stats_file);
+void rule_stats_update (rule_stats_t *rule_stats, kernel_rule_t *kernel_rules_buf, const uint kernel_rules_cnt, u64 *rule_hits, u64 *rule_tested);
+void rule_stats_print (rule_stats_t *rule_stats, FILE *fp, const uint top);
+void rule_stats_destroy (rule_stats_t *rule_stats);
 
 int bcrypt_parse_hash             (char *input_buf, uint input_len, hash_t *hash_buf);
 int cisco4_parse_hash             (char *input_buf, uint input_len, hash_t *hash_buf);
@@ -699,6 +699,96 @@ typedef struct
 
 } hcstat_table_t;
 
+typedef struct
+{
+  u32  type;
+  u32  encoding;
+  u64  offset;
+  u64  length;
+  u64  count;
+
+} hcstat2_section_t;
+
+typedef struct
+{
+  u64  magic;
+  u32  version;
+  u32  order;
+  u32  pw_max;
+  u32  charsiz;
+  u32  sections_cnt;
+  u32  reserved;
+  u64  words_cnt;
+
+  hcstat2_section_t sections[SP_HCSTAT2_SECTIONS_MAX];
+
+} hcstat2_header_t;
+
+typedef struct
+{
+  u32 *keys;
+  u64 *vals;
+  u64  size;
+  u64  cnt;
+
+} sp_ctx2_t;
+
+typedef struct
+{
+  char *file;
+  u64   start;
+  u64   stop;
+
+  uint  order;
+  uint  potfile;
+  char  separator;
+
+  u64  *root_stats_buf;
+  u64  *markov_stats_buf;
+
+  sp_ctx2_t ctx2;
+
+  u64   words_cnt;
+
+} sp_train_t;
+
+typedef struct
+{
+  uint  maskpos;
+  uint  dictpos;
+  u64   words_base;
+  u64   bfs_cnt;
+  u64   skip;
+  u64   limit;
+  char *mask;
+
+} kp_plan_t;
+
+typedef struct
+{
+  u64 *bits;
+  u64  bits_mask;
+  u64  added;
+  u64  dupes;
+
+} bloom_t;
+
+typedef struct
+{
+  const u32 *ks_buf;
+  const u32 *chall;
+  const u32 *ct;
+
+  u32   *ct_buf;
+
+  uint   key_start;
+  uint   key_stop;
+  uint   key_pos;
+
+  volatile uint *key_found;
+
+} netntlmv1_worker_t;
+
 typedef struct
 {
   uint cs_buf[0x100];
@@ -781,6 +871,16 @@ typedef struct
 
 } pw_t;
 
+typedef struct
+{
+  u32 off;    // in u32 words, into the packed candidate words
+  u32 cnt;    // number of u32 words
+  u32 len;    // pw_len
+
+} pw_idx_t;
+
+typedef void (*hook_func_t) (void *hook, const salt_t *salt, const void *esalt);
+
 typedef struct
 {
   uint i;
@@ -809,6 +909,7 @@ typedef struct
 
   u32  dictpos;
   u32  maskpos;
+  u32  shardpos;
 
   u64  words_cur;
 
@@ -903,20 +1004,113 @@ typedef struct
 
 typedef struct
 {
-  tuning_db_alias_t *alias_buf;
-  int                alias_cnt;
+  char   device_name_chksum[16];
+  char  *device_name;
+  int    attack_mode;
+  int    hash_type;
+  int    vector_width;
+  int    workload_profile;
+  u64    mem_item;
+  int    mem_tmto;
+  int    kernel_accel;
+  int    kernel_loops;
+  double exec_ms;
+  u64    speed;
+  u64    timestamp;
+
+} tuning_db_learned_t;
+
+typedef struct
+{
+  tuning_db_alias_t   *alias_buf;
+  int                  alias_cnt;
 
-  tuning_db_entry_t *entry_buf;
-  int                entry_cnt;
+  tuning_db_entry_t   *entry_buf;
+  int                  entry_cnt;
+
+  tuning_db_learned_t *learned_buf;
+  int                  learned_cnt;
 
 } tuning_db_t;
 
+typedef struct
+{
+  uint    device_id;
+  uint    hash_mode;
+  char   *device_name;
+  char   *driver_version;
+  uint    samples_cnt;
+  double  mean;
+  double  stddev;
+
+} benchmark_result_t;
+
+typedef struct
+{
+  char *rule_buf;
+  u64   hits;
+  u64   tested;
+
+} rule_stat_t;
+
+typedef struct
+{
+  rule_stat_t *stat_buf;
+  uint         stat_cnt;
+
+} rule_stats_t;
+
 #define RULES_MAX   256
 #define PW_MIN      0
 #define PW_MAX      54
 #define PW_MAX1     (PW_MAX + 1)
 #define PW_DICTMAX  31
 #define PW_DICTMAX1 (PW_DICTMAX + 1)
+
+#define PW_SORT_LEN_MAX 64 // sizeof (pw_t.i), longer pw_len are sorted together
+
+typedef struct
+{
+  u64  magic;
+  u32  version;
+  u32  pw_max;
+  u64  words_cnt;
+  u64  len_cnt[PW_MAX1];
+
+} wl_compiled_header_t;
+
+typedef struct
+{
+  FILE *fp;
+
+  wl_compiled_header_t header;
+
+  u64   len_off[PW_MAX1];
+
+  uint  len_min;
+  uint  len_max;
+  uint  len_cur;
+  u64   len_left;
+
+  u64   words_cnt;
+
+  char *buf;
+  u64   buf_pos;
+  u64   buf_cnt;
+
+} wl_compiled_t;
+
+typedef struct
+{
+  char *buf;
+  u64   cnt;
+  u64   avail;
+
+  u32  *table;
+  u64   table_size;
+
+} wl_compile_group_t;
+
 #define PARAMCNT    64
 
 struct __hc_device_param
@@ -951,7 +1145,18 @@ struct __hc_device_param
   uint    kernel_power;
   uint    hardware_power;
 
+  uint    scrypt_tmto_final;
+  u64     mem_item;
+
+  uint    kernel_accel_learned;
+  uint    kernel_loops_learned;
+  double  exec_ms_learned;
+  double  exec_ms_autotune;
+  uint    autotune_source;
+
   size_t  size_pws;
+  size_t  size_pws_comp;
+  size_t  size_pws_idx;
   size_t  size_tmps;
   size_t  size_hooks;
   size_t  size_bfs;
@@ -966,13 +1171,19 @@ struct __hc_device_param
   size_t  size_results;
   size_t  size_plains;
 
-  FILE   *combs_fp;
   comb_t *combs_buf;
 
+  char   *stdout_buf;
+
   void   *hooks_buf;
 
-  pw_t   *pws_buf;
-  uint    pws_cnt;
+  u32      *pws_comp;          // candidates packed back-to-back, unpacked into d_pws_buf by gpu_decompress
+  u32       pws_comp_cnt;      // u32 words used in pws_comp
+  pw_idx_t *pws_comp_idx;
+  uint      pws_cnt;
+
+  pw_idx_t *pws_comp_idx_sort; // swapped with pws_comp_idx by pw_sort_by_len ()
+  u32      *pws_idx;           // position in the batch before sorting, for the crack position
 
   u64     words_off;
   u64     words_done;
@@ -983,6 +1194,8 @@ struct __hc_device_param
   uint    innerloop_pos;
   uint    innerloop_left;
 
+  uint    tmps_reuse;
+
   uint    exec_pos;
   double  exec_ms[EXEC_CACHE];
 
@@ -1000,6 +1213,22 @@ struct __hc_device_param
 
   hc_timer_t timer_speed;
 
+  // cumulative per-stage timers of the host pipeline, idle is the time between two kernel runs
+
+  u64     stage_cnt[STAGE_CNT];
+  double  stage_ms[STAGE_CNT];
+
+  double  stage_idle_ms;
+  double  stage_output_ms; // check_hash () time of the current batch
+
+  hc_timer_t timer_stage_idle;
+  uint    timer_stage_idle_set;
+
+  // one speed sample (H/s) per benchmark repeat
+
+  double  benchmark_speed[BENCHMARK_REPEATS_MAX];
+  uint    benchmark_speed_cnt;
+
   // device specific attributes starting
 
   char   *device_name;
@@ -1029,6 +1258,7 @@ struct __hc_device_param
   cl_kernel  kernel_tm;
   cl_kernel  kernel_weak;
   cl_kernel  kernel_memset;
+  cl_kernel  kernel_decompress;
 
   cl_context context;
 
@@ -1040,6 +1270,8 @@ struct __hc_device_param
 
   cl_mem  d_pws_buf;
   cl_mem  d_pws_amp_buf;
+  cl_mem  d_pws_comp_buf;
+  cl_mem  d_pws_idx;
   cl_mem  d_words_buf_l;
   cl_mem  d_words_buf_r;
   cl_mem  d_rules;
@@ -1080,6 +1312,7 @@ struct __hc_device_param
   void   *kernel_params_amp[PARAMCNT];
   void   *kernel_params_tm[PARAMCNT];
   void   *kernel_params_memset[PARAMCNT];
+  void   *kernel_params_decompress[PARAMCNT];
 
   u32     kernel_params_buf32[PARAMCNT];
 
@@ -1094,6 +1327,7 @@ struct __hc_device_param
 
   u32     kernel_params_amp_buf32[PARAMCNT];
   u32     kernel_params_memset_buf32[PARAMCNT];
+  u32     kernel_params_decompress_buf32[PARAMCNT];
 };
 
 typedef struct __hc_device_param hc_device_param_t;
@@ -1156,6 +1390,10 @@ typedef struct
   uint    combs_mode;
   uint    combs_cnt;
 
+  comb_t *combs_pack_buf;
+  uint    combs_pack_cnt;
+  uint    combs_pack_rejected;
+
   uint    bfs_cnt;
 
   uint    css_cnt;
@@ -1199,16 +1437,27 @@ typedef struct
   uint   *digests_shown;
   uint   *digests_shown_tmp;
 
+  uint    shards_cnt;
+  uint   *shards_offset;
+  uint    shard_pos;
+  uint    shard_offset;
+  uint    shard_digests_cnt;
+  uint    shard_digests_max;
+
   uint    salts_cnt;
   uint    salts_done;
 
   salt_t *salts_buf;
   uint   *salts_shown;
+  uint   *salts_order;
+  uint   *salts_tmps_shared;
+  uint   *salts_tier;
+  uint    salt_tiers_cnt;
+  uint    salt_tier_pos;
 
   void   *esalts_buf;
 
   uint    scrypt_tmp_size;
-  uint    scrypt_tmto_final;
 
   /**
    * logging
@@ -1249,26 +1498,46 @@ typedef struct
   uint    outfile_format;
   uint    outfile_autohex;
   uint    outfile_check_timer;
+  uint    stdout_threads;
+  uint    stdout_ordered;
+  FILE   *stdout_fp;
   char   *eff_restore_file;
   char   *new_restore_file;
   char   *induction_directory;
   char   *outfile_check_directory;
   uint    loopback;
   char   *loopback_file;
+  bloom_t loopback_bloom;
+  bloom_t loopback_words_bloom;
   uint    restore;
   uint    restore_timer;
   uint    restore_disable;
   uint    status;
   uint    status_timer;
   uint    machine_readable;
+  char   *metrics_listen;
+  int     metrics_fd;
+  FILE   *trace_fp;
+  hc_timer_t timer_trace;
+  u64     trace_cnt;
   uint    quiet;
   uint    force;
   uint    benchmark;
+  uint    benchmark_repeats;
+  char   *benchmark_save;
+  char   *benchmark_compare;
+  benchmark_result_t *benchmark_results;
+  uint    benchmark_results_cnt;
+  benchmark_result_t *benchmark_baseline;
+  uint    benchmark_baseline_cnt;
   uint    runtime;
   uint    remove;
   uint    remove_timer;
   uint    debug_mode;
   char   *debug_file;
+  char   *rule_stats;
+  u64    *rule_hits;
+  u64    *rule_tested;
   uint    hex_charset;
   uint    hex_salt;
   uint    hex_wordlist;
@@ -1277,10 +1546,12 @@ typedef struct
   uint    powertune_enable;
   uint    scrypt_tmto;
   uint    segment_size;
+  uint    length_sort;
   char   *truecrypt_keyfiles;
   char   *veracrypt_keyfiles;
   uint    veracrypt_pim;
   uint    workload_profile;
+  uint    autotune_cache;
   char   *custom_charset_1;
   char   *custom_charset_2;
   char   *custom_charset_3;
@@ -1292,6 +1563,12 @@ typedef struct
   uint    opts_type;
   uint    salt_type;
   uint    esalt_size;
+  uint    hook_size;
+  uint    hook_threads;
+
+  hook_func_t hook12_func;
+  hook_func_t hook23_func;
+
   uint    isSalted;
   uint    dgst_size;
   uint    opti_type;
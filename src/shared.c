@@ -280,29 +280,29 @@ u8 int_to_itoa64 (const u8 c)
   return tbl[c];
 }
 
+static const u8 itoa64_to_int_tbl[0x100] =
+{
+  0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21,
+  0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31,
+  0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01,
+  0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+  0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a,
+  0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x20, 0x21, 0x22, 0x23, 0x24,
+  0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34,
+  0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01, 0x02, 0x03, 0x04,
+  0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14,
+  0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24,
+  0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34,
+  0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01, 0x02, 0x03, 0x04,
+  0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14,
+  0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24,
+  0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34,
+  0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01, 0x02, 0x03, 0x04,
+};
+
 u8 itoa64_to_int (const u8 c)
 {
-  static const u8 tbl[0x100] =
-  {
-    0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21,
-    0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31,
-    0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01,
-    0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
-    0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a,
-    0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x20, 0x21, 0x22, 0x23, 0x24,
-    0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34,
-    0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01, 0x02, 0x03, 0x04,
-    0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14,
-    0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24,
-    0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34,
-    0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01, 0x02, 0x03, 0x04,
-    0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14,
-    0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24,
-    0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34,
-    0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x01, 0x02, 0x03, 0x04,
-  };
-
-  return tbl[c];
+  return itoa64_to_int_tbl[c];
 }
 
 u8 int_to_base64 (const u8 c)
@@ -318,29 +318,29 @@ u8 int_to_base64 (const u8 c)
   return tbl[c];
 }
 
+static const u8 base64_to_int_tbl[0x100] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00, 0x3f,
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+  0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
 u8 base64_to_int (const u8 c)
 {
-  static const u8 tbl[0x100] =
-  {
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00, 0x3f,
-    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
-    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
-    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  };
-
-  return tbl[c];
+  return base64_to_int_tbl[c];
 }
 
 u8 int_to_bf64 (const u8 c)
@@ -356,29 +356,29 @@ u8 int_to_bf64 (const u8 c)
   return tbl[c];
 }
 
+static const u8 bf64_to_int_tbl[0x100] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+  0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+  0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a,
+  0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
 u8 bf64_to_int (const u8 c)
 {
-  static const u8 tbl[0x100] =
-  {
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
-    0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x3e, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
-    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a,
-    0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-  };
-
-  return tbl[c];
+  return bf64_to_int_tbl[c];
 }
 
 u8 int_to_lotus64 (const u8 c)
@@ -491,28 +491,53 @@ int base64_decode (u8 (*f) (const u8), const u8 *in_buf, int in_len, u8 *out_buf
 
   u8 *out_ptr = out_buf;
 
-  for (int i = 0; i < in_len; i += 4)
+  // the table based alphabets are looked up directly, that saves the indirect call for every character
+
+  const u8 *tbl = NULL;
+
+  if      (f == base64_to_int) tbl = base64_to_int_tbl;
+  else if (f == itoa64_to_int) tbl = itoa64_to_int_tbl;
+  else if (f == bf64_to_int)   tbl = bf64_to_int_tbl;
+
+  if (tbl)
   {
-    const u8 out_val0 = f (in_ptr[0] & 0x7f);
-    const u8 out_val1 = f (in_ptr[1] & 0x7f);
-    const u8 out_val2 = f (in_ptr[2] & 0x7f);
-    const u8 out_val3 = f (in_ptr[3] & 0x7f);
+    for (int i = 0; i < in_len; i += 4)
+    {
+      const u32 v = ((u32) tbl[in_ptr[0] & 0x7f] << 18)
+                  | ((u32) tbl[in_ptr[1] & 0x7f] << 12)
+                  | ((u32) tbl[in_ptr[2] & 0x7f] <<  6)
+                  | ((u32) tbl[in_ptr[3] & 0x7f] <<  0);
 
-    out_ptr[0] = ((out_val0 << 2) & 0xfc) | ((out_val1 >> 4) & 0x03);
-    out_ptr[1] = ((out_val1 << 4) & 0xf0) | ((out_val2 >> 2) & 0x0f);
-    out_ptr[2] = ((out_val2 << 6) & 0xc0) | ((out_val3 >> 0) & 0x3f);
+      out_ptr[0] = (v >> 16) & 0xff;
+      out_ptr[1] = (v >>  8) & 0xff;
+      out_ptr[2] = (v >>  0) & 0xff;
 
-    in_ptr  += 4;
-    out_ptr += 3;
+      in_ptr  += 4;
+      out_ptr += 3;
+    }
   }
-
-  for (int i = 0; i < in_len; i++)
+  else
   {
-    if (in_buf[i] != '=') continue;
+    for (int i = 0; i < in_len; i += 4)
+    {
+      const u8 out_val0 = f (in_ptr[0] & 0x7f);
+      const u8 out_val1 = f (in_ptr[1] & 0x7f);
+      const u8 out_val2 = f (in_ptr[2] & 0x7f);
+      const u8 out_val3 = f (in_ptr[3] & 0x7f);
 
-    in_len = i;
+      out_ptr[0] = ((out_val0 << 2) & 0xfc) | ((out_val1 >> 4) & 0x03);
+      out_ptr[1] = ((out_val1 << 4) & 0xf0) | ((out_val2 >> 2) & 0x0f);
+      out_ptr[2] = ((out_val2 << 6) & 0xc0) | ((out_val3 >> 0) & 0x3f);
+
+      in_ptr  += 4;
+      out_ptr += 3;
+    }
   }
 
+  const u8 *pad = (const u8 *) memchr (in_buf, '=', in_len);
+
+  if (pad) in_len = pad - in_buf;
+
   int out_len = (in_len * 6) / 8;
 
   return out_len;
@@ -561,6 +586,132 @@ int is_valid_hex_char (const u8 c)
   return 0;
 }
 
+/**
+ * the hex helpers below work on 8 characters in a u64 at a time (SWAR), the first character is the lowest byte
+ * like everywhere else on the host side this expects a little endian cpu
+ */
+
+#define HEX_ONES 0x0101010101010101ULL
+#define HEX_HIGH 0x8080808080808080ULL
+
+static u64 hex_load_u64 (const u8 *hex)
+{
+  u64 v;
+
+  memcpy (&v, hex, sizeof (v));
+
+  return v;
+}
+
+static int hex_valid_u64 (const u64 v)
+{
+  // per byte: c + (0x80 - lo) has the high bit set if c >= lo, c + (0x7f - hi) has it set if c > hi
+  // no byte can carry into the next one as long as all of them are below 0x80
+
+  if (v & HEX_HIGH) return 0;
+
+  const u64 l = v | (HEX_ONES * 0x20);
+
+  const u64 digit = (v + HEX_ONES * (0x80 - '0')) & ~(v + HEX_ONES * (0x7f - '9'));
+  const u64 alpha = (l + HEX_ONES * (0x80 - 'a')) & ~(l + HEX_ONES * (0x7f - 'f'));
+
+  return ((digit | alpha) & HEX_HIGH) == HEX_HIGH;
+}
+
+static u32 hex_convert_u64 (const u64 v)
+{
+  // same as hex_convert () for all 8 characters, then pair the nibbles up into bytes
+  // result is the decoded 4 bytes in memory order
+
+  u64 t = (v & (HEX_ONES * 0x0f)) + ((v >> 6) & HEX_ONES) * 9;
+
+  t = ((t & 0x00ff00ff00ff00ffULL) << 4) | ((t >> 8) & 0x00ff00ff00ff00ffULL);
+  t = (t | (t >>  8)) & 0x0000ffff0000ffffULL;
+  t = (t | (t >> 16)) & 0x00000000ffffffffULL;
+
+  return (u32) t;
+}
+
+int is_valid_hex_string (const u8 *s, const int len)
+{
+  int i = 0;
+
+  for ( ; i + 8 <= len; i += 8)
+  {
+    if (hex_valid_u64 (hex_load_u64 (s + i)) == 0) return 0;
+  }
+
+  for ( ; i < len; i++)
+  {
+    if (is_valid_hex_char (s[i]) == 0) return 0;
+  }
+
+  return 1;
+}
+
+int hex_decode (const u8 *in_buf, const int in_len, u8 *out_buf)
+{
+  // in_buf and out_buf may be the same buffer, each step reads its 16 characters before it writes the 8 bytes
+
+  const int out_len = in_len / 2;
+
+  int i = 0;
+
+  for ( ; i + 8 <= out_len; i += 8)
+  {
+    const u64 v0 = hex_load_u64 (in_buf + i * 2 + 0);
+    const u64 v1 = hex_load_u64 (in_buf + i * 2 + 8);
+
+    const u32 out[2] = { hex_convert_u64 (v0), hex_convert_u64 (v1) };
+
+    memcpy (out_buf + i, out, sizeof (out));
+  }
+
+  for ( ; i < out_len; i++)
+  {
+    out_buf[i] = hex_to_u8 (in_buf + i * 2);
+  }
+
+  return out_len;
+}
+
+uint convert_from_hex (char *line_buf, const uint line_len, const uint hex_wordlist)
+{
+  // --hex-wordlist and $HEX[] decoding of a wordlist line, used by the wordlist readers and by wl_compile ()
+
+  if (line_len & 1) return (line_len); // not in hex
+
+  if (hex_wordlist == 1)
+  {
+    const uint i = hex_decode ((const u8 *) line_buf, line_len, (u8 *) line_buf);
+
+    memset (line_buf + i, 0, line_len - i);
+
+    return (i);
+  }
+  else if (line_len >= 6) // $HEX[] = 6
+  {
+    if (line_buf[0]            != '$') return (line_len);
+    if (line_buf[1]            != 'H') return (line_len);
+    if (line_buf[2]            != 'E') return (line_len);
+    if (line_buf[3]            != 'X') return (line_len);
+    if (line_buf[4]            != '[') return (line_len);
+    if (line_buf[line_len - 1] != ']') return (line_len);
+
+    // a word which only looks like $HEX[] is taken as it is
+
+    if (is_valid_hex_string ((const u8 *) line_buf + 5, line_len - 6) == 0) return (line_len);
+
+    const uint i = hex_decode ((const u8 *) line_buf + 5, line_len - 6, (u8 *) line_buf);
+
+    memset (line_buf + i, 0, line_len - i);
+
+    return (i);
+  }
+
+  return (line_len);
+}
+
 u8 hex_convert (const u8 c)
 {
   return (c & 15) + (c >> 6) * 9;
@@ -578,40 +729,19 @@ u8 hex_to_u8 (const u8 hex[2])
 
 u32 hex_to_u32 (const u8 hex[8])
 {
-  u32 v = 0;
+  // the first character is the most significant nibble
 
-  v |= ((u32) hex_convert (hex[7])) <<  0;
-  v |= ((u32) hex_convert (hex[6])) <<  4;
-  v |= ((u32) hex_convert (hex[5])) <<  8;
-  v |= ((u32) hex_convert (hex[4])) << 12;
-  v |= ((u32) hex_convert (hex[3])) << 16;
-  v |= ((u32) hex_convert (hex[2])) << 20;
-  v |= ((u32) hex_convert (hex[1])) << 24;
-  v |= ((u32) hex_convert (hex[0])) << 28;
+  const u32 v = hex_convert_u64 (hex_load_u64 (hex));
 
-  return (v);
+  return byte_swap_32 (v);
 }
 
 u64 hex_to_u64 (const u8 hex[16])
 {
   u64 v = 0;
 
-  v |= ((u64) hex_convert (hex[15]) <<  0);
-  v |= ((u64) hex_convert (hex[14]) <<  4);
-  v |= ((u64) hex_convert (hex[13]) <<  8);
-  v |= ((u64) hex_convert (hex[12]) << 12);
-  v |= ((u64) hex_convert (hex[11]) << 16);
-  v |= ((u64) hex_convert (hex[10]) << 20);
-  v |= ((u64) hex_convert (hex[ 9]) << 24);
-  v |= ((u64) hex_convert (hex[ 8]) << 28);
-  v |= ((u64) hex_convert (hex[ 7]) << 32);
-  v |= ((u64) hex_convert (hex[ 6]) << 36);
-  v |= ((u64) hex_convert (hex[ 5]) << 40);
-  v |= ((u64) hex_convert (hex[ 4]) << 44);
-  v |= ((u64) hex_convert (hex[ 3]) << 48);
-  v |= ((u64) hex_convert (hex[ 2]) << 52);
-  v |= ((u64) hex_convert (hex[ 1]) << 56);
-  v |= ((u64) hex_convert (hex[ 0]) << 60);
+  v |= ((u64) hex_to_u32 (hex + 8)) <<  0;
+  v |= ((u64) hex_to_u32 (hex + 0)) << 32;
 
   return (v);
 }
@@ -2642,6 +2772,101 @@ char *logfile_generate_subid ()
   return subid;
 }
 
+/**
+ * trace
+ */
+
+int trace_open (const char *trace_file)
+{
+  FILE *fp = fopen (trace_file, "wb");
+
+  if (fp == NULL) return -1;
+
+  // JSON Array Format, as understood by chrome://tracing and Perfetto
+
+  fputs ("[\n", fp);
+
+  data.trace_fp  = fp;
+  data.trace_cnt = 0;
+
+  hc_timer_set (&data.timer_trace);
+
+  return 0;
+}
+
+void trace_close ()
+{
+  if (data.trace_fp == NULL) return;
+
+  fputs ("\n]\n", data.trace_fp);
+
+  fclose (data.trace_fp);
+
+  data.trace_fp = NULL;
+}
+
+double trace_now_us ()
+{
+  double ms;
+
+  hc_timer_get (data.timer_trace, ms);
+
+  return ms * 1000;
+}
+
+static void trace_event (const char *fmt, ...)
+{
+  hc_thread_mutex_lock (mux_trace);
+
+  if (data.trace_cnt > 0) fputs (",\n", data.trace_fp);
+
+  va_list ap;
+
+  va_start (ap, fmt);
+
+  vfprintf (data.trace_fp, fmt, ap);
+
+  va_end (ap);
+
+  data.trace_cnt++;
+
+  hc_thread_mutex_unlock (mux_trace);
+}
+
+void trace_span (const uint device_id, const uint tid, const char *name, const double ts_us, const double dur_us)
+{
+  if (data.trace_fp == NULL) return;
+
+  trace_event ("{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u}", name, ts_us, dur_us, device_id + 1, tid);
+}
+
+void trace_device_names ()
+{
+  if (data.trace_fp == NULL) return;
+
+  for (uint device_id = 0; device_id < data.devices_cnt; device_id++)
+  {
+    hc_device_param_t *device_param = &data.devices_param[device_id];
+
+    if (device_param->skipped) continue;
+
+    char name[256] = { 0 };
+
+    snprintf (name, sizeof (name) - 1, "Device #%u: %s", device_id + 1, device_param->device_name);
+
+    // the device name comes from the driver, keep it valid inside a JSON string
+
+    for (char *p = name; *p; p++)
+    {
+      if ((*p == '"') || (*p == '\\') || (*p < 0x20)) *p = ' ';
+    }
+
+    trace_event ("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"%s\"}}", device_id + 1, name);
+    trace_event ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"host\"}}",   device_id + 1, TRACE_TID_HOST);
+    trace_event ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"device\"}}", device_id + 1, TRACE_TID_DEVICE);
+  }
+}
+
 /**
  * system
  */
@@ -3896,6 +4121,90 @@ void mp_reset_usr (cs_t *mp_usr, uint index)
   memset (mp_usr[index].cs_buf, 0, sizeof (mp_usr[index].cs_buf));
 }
 
+char *mp_parse_mask_line (char *mask, cs_t *mp_sys, cs_t *mp_usr)
+{
+  /**
+   * a line of a .hcmask file is "[cs1,][cs2,][cs3,][cs4,]mask", the custom charsets are setup and the mask is returned
+   * note: the line is modified in-place
+   */
+
+  if (mask[0] == '\\' && mask[1] == '#') mask++; // escaped comment sign (sharp) "\#"
+
+  char *str_ptr;
+  uint  str_pos;
+
+  uint mask_offset = 0;
+
+  uint separator_cnt;
+
+  for (separator_cnt = 0; separator_cnt < 4; separator_cnt++)
+  {
+    str_ptr = strstr (mask + mask_offset, ",");
+
+    if (str_ptr == NULL) break;
+
+    str_pos = str_ptr - mask;
+
+    // escaped separator, i.e. "\,"
+
+    if (str_pos > 0)
+    {
+      if (mask[str_pos - 1] == '\\')
+      {
+        separator_cnt --;
+
+        mask_offset = str_pos + 1;
+
+        continue;
+      }
+    }
+
+    // reset the offset
+
+    mask_offset = 0;
+
+    mask[str_pos] = '\0';
+
+    mp_reset_usr (mp_usr, separator_cnt);
+
+    mp_setup_usr (mp_sys, mp_usr, mask, separator_cnt);
+
+    mask = mask + str_pos + 1;
+  }
+
+  /**
+   * What follows is a very special case where "\," is within the mask field of a line in a .hcmask file only because otherwise (without the "\")
+   * it would be interpreted as a custom charset definition.
+   *
+   * We need to replace all "\," with just "," within the mask (but allow the special case "\\," which means "\" followed by ",")
+   * Note: "\\" is not needed to replace all "\" within the mask! The meaning of "\\" within a line containing the string "\\," is just to allow "\" followed by ","
+   */
+
+  uint mask_len_cur = strlen (mask);
+
+  uint mask_out_pos = 0;
+  char mask_prev = 0;
+
+  for (uint mask_iter = 0; mask_iter < mask_len_cur; mask_iter++, mask_out_pos++)
+  {
+    if (mask[mask_iter] == ',')
+    {
+      if (mask_prev == '\\')
+      {
+        mask_out_pos -= 1; // this means: skip the previous "\"
+      }
+    }
+
+    mask_prev = mask[mask_iter];
+
+    mask[mask_out_pos] = mask[mask_iter];
+  }
+
+  mask[mask_out_pos] = '\0';
+
+  return (mask);
+}
+
 char *mp_get_truncated_mask (char *mask_buf, size_t mask_len, uint len)
 {
   char *new_mask_buf = (char *) mymalloc (256);
@@ -3974,6 +4283,38 @@ u64 sp_get_sum (uint start, uint stop, cs_t *root_css_buf)
   return (sum);
 }
 
+u64 sp_get_sum_css (uint start, uint stop, cs_t *css_buf, uint threshold)
+{
+  /**
+   * same as sp_get_sum () on the root_css_buf sp_tbl_to_css () generates from css_buf
+   * the hcstat tables only decide the order of the chars, not how many of them are used
+   */
+
+  u64 sum = 1;
+
+  for (uint css_pos = start; css_pos < stop; css_pos++)
+  {
+    uint uniq_tbl[CHARSIZ] = { 0 };
+
+    uint uniq_cnt = 0;
+
+    for (uint cs_pos = 0; cs_pos < css_buf[css_pos].cs_len; cs_pos++)
+    {
+      uint c = css_buf[css_pos].cs_buf[cs_pos] & 0xff;
+
+      if (uniq_tbl[c] == 1) continue;
+
+      uniq_tbl[c] = 1;
+
+      uniq_cnt++;
+    }
+
+    sum *= MIN (uniq_cnt, threshold);
+  }
+
+  return (sum);
+}
+
 void sp_exec (u64 ctx, char *pw_buf, cs_t *root_css_buf, cs_t *markov_css_buf, uint start, uint stop)
 {
   u64 v = ctx;
@@ -3997,38 +4338,253 @@ void sp_exec (u64 ctx, char *pw_buf, cs_t *root_css_buf, cs_t *markov_css_buf, u
   }
 }
 
-int sp_comp_val (const void *p1, const void *p2)
-{
-  hcstat_table_t *b1 = (hcstat_table_t *) p1;
-  hcstat_table_t *b2 = (hcstat_table_t *) p2;
-
-  return b2->val - b1->val;
-}
+/**
+ * hcstat v2: a header followed by 8-byte aligned sections. A section is either
+ * stored raw (a plain u64 array which can be mapped and used in-place), zero-run
+ * compressed or as sorted sparse key/value pairs. The root and markov sections
+ * hold exactly the counters of the classic hcstat file, the optional markov2
+ * section holds counters for a context of the two previous characters.
+ */
 
-void sp_setup_tbl (const char *shared_dir, char *hcstat, uint disable, uint classic, hcstat_table_t *root_table_buf, hcstat_table_t *markov_table_buf)
+static size_t sp_varint_put (u8 *buf, u64 val)
 {
-  uint i;
-  uint j;
-  uint k;
+  size_t len = 0;
 
-  /**
-   * Initialize hcstats
-   */
+  while (val >= 0x80)
+  {
+    buf[len++] = (u8) (val | 0x80);
 
-  u64 *root_stats_buf = (u64 *) mycalloc (SP_ROOT_CNT, sizeof (u64));
+    val >>= 7;
+  }
 
-  u64 *root_stats_ptr = root_stats_buf;
+  buf[len++] = (u8) val;
 
-  u64 *root_stats_buf_by_pos[SP_PW_MAX];
+  return len;
+}
 
-  for (i = 0; i < SP_PW_MAX; i++)
+static size_t sp_varint_get (const u8 *buf, const size_t buf_len, u64 *val)
+{
+  u64 v = 0;
+
+  for (size_t len = 0; (len < buf_len) && (len < 10); len++)
   {
-    root_stats_buf_by_pos[i] = root_stats_ptr;
+    v |= (u64) (buf[len] & 0x7f) << (7 * len);
 
-    root_stats_ptr += CHARSIZ;
+    if ((buf[len] & 0x80) == 0)
+    {
+      *val = v;
+
+      return len + 1;
+    }
   }
 
-  u64 *markov_stats_buf = (u64 *) mycalloc (SP_MARKOV_CNT, sizeof (u64));
+  return 0;
+}
+
+static int sp_zrle_encode (const u64 *in, const u64 cnt, u8 *out, const size_t out_max, size_t *out_len)
+{
+  // pairs of (number of zero counters skipped, non-zero counter), trailing zeros are implicit
+
+  size_t len = 0;
+
+  u64 zeros = 0;
+
+  for (u64 i = 0; i < cnt; i++)
+  {
+    if (in[i] == 0)
+    {
+      zeros++;
+
+      continue;
+    }
+
+    if ((len + 20) > out_max) return -1;
+
+    len += sp_varint_put (out + len, zeros);
+    len += sp_varint_put (out + len, in[i]);
+
+    zeros = 0;
+  }
+
+  *out_len = len;
+
+  return 0;
+}
+
+static int sp_zrle_decode (const u8 *in, const size_t in_len, u64 *out, const u64 cnt)
+{
+  memset (out, 0, cnt * sizeof (u64));
+
+  u64 pos = 0;
+
+  size_t off = 0;
+
+  while (off < in_len)
+  {
+    u64 zeros = 0;
+    u64 val   = 0;
+
+    size_t len;
+
+    if ((len = sp_varint_get (in + off, in_len - off, &zeros)) == 0) return -1;
+
+    off += len;
+
+    if ((len = sp_varint_get (in + off, in_len - off, &val)) == 0) return -1;
+
+    off += len;
+
+    if (zeros >= (cnt - pos)) return -1;
+
+    pos += zeros;
+
+    out[pos++] = val;
+  }
+
+  return 0;
+}
+
+static int sp_hcstat2_read (FILE *fd, const char *hcstat, u64 *root_stats_buf, u64 *markov_stats_buf)
+{
+  hcstat2_header_t header;
+
+  rewind (fd);
+
+  if (fread (&header, sizeof (hcstat2_header_t), 1, fd) != 1)
+  {
+    log_error ("%s: Could not load data", hcstat);
+
+    return -1;
+  }
+
+  if (header.version > SP_HCSTAT2_VERSION)
+  {
+    log_error ("%s: Unsupported hcstat version %u", hcstat, header.version);
+
+    return -1;
+  }
+
+  if ((header.pw_max != SP_PW_MAX) || (header.charsiz != CHARSIZ) || (header.sections_cnt > SP_HCSTAT2_SECTIONS_MAX))
+  {
+    log_error ("%s: Incompatible hcstat layout", hcstat);
+
+    return -1;
+  }
+
+  uint sections_found = 0;
+
+  for (uint i = 0; i < header.sections_cnt; i++)
+  {
+    hcstat2_section_t *section = &header.sections[i];
+
+    u64 *stats_buf = NULL;
+    u64  stats_cnt = 0;
+
+    if (section->type == SP_SECTION_ROOT)
+    {
+      stats_buf = root_stats_buf;
+      stats_cnt = SP_ROOT_CNT;
+    }
+    else if (section->type == SP_SECTION_MARKOV)
+    {
+      stats_buf = markov_stats_buf;
+      stats_cnt = SP_MARKOV_CNT;
+    }
+    else
+    {
+      // the markov2 section is for external consumers only, the mask engine uses a single character context
+
+      continue;
+    }
+
+    if ((section->count != stats_cnt) || (section->length > (stats_cnt * sizeof (u64))))
+    {
+      log_error ("%s: Corrupted hcstat section %u", hcstat, i);
+
+      return -1;
+    }
+
+    u8 *section_buf = (u8 *) mymalloc (section->length + 1);
+
+    if ((fseek (fd, section->offset, SEEK_SET) != 0) || (fread (section_buf, 1, section->length, fd) != section->length))
+    {
+      log_error ("%s: Could not load data", hcstat);
+
+      myfree (section_buf);
+
+      return -1;
+    }
+
+    int rc = -1;
+
+    if (section->encoding == SP_ENCODING_RAW)
+    {
+      if (section->length == (stats_cnt * sizeof (u64)))
+      {
+        memcpy (stats_buf, section_buf, section->length);
+
+        rc = 0;
+      }
+    }
+    else if (section->encoding == SP_ENCODING_ZRLE)
+    {
+      rc = sp_zrle_decode (section_buf, section->length, stats_buf, stats_cnt);
+    }
+
+    myfree (section_buf);
+
+    if (rc == -1)
+    {
+      log_error ("%s: Corrupted hcstat section %u", hcstat, i);
+
+      return -1;
+    }
+
+    sections_found |= 1u << section->type;
+  }
+
+  if (sections_found != ((1u << SP_SECTION_ROOT) | (1u << SP_SECTION_MARKOV)))
+  {
+    log_error ("%s: Missing hcstat sections", hcstat);
+
+    return -1;
+  }
+
+  return 0;
+}
+
+int sp_comp_val (const void *p1, const void *p2)
+{
+  hcstat_table_t *b1 = (hcstat_table_t *) p1;
+  hcstat_table_t *b2 = (hcstat_table_t *) p2;
+
+  return b2->val - b1->val;
+}
+
+void sp_setup_tbl (const char *shared_dir, char *hcstat, uint disable, uint classic, hcstat_table_t *root_table_buf, hcstat_table_t *markov_table_buf)
+{
+  uint i;
+  uint j;
+  uint k;
+
+  /**
+   * Initialize hcstats
+   */
+
+  u64 *root_stats_buf = (u64 *) mycalloc (SP_ROOT_CNT, sizeof (u64));
+
+  u64 *root_stats_ptr = root_stats_buf;
+
+  u64 *root_stats_buf_by_pos[SP_PW_MAX];
+
+  for (i = 0; i < SP_PW_MAX; i++)
+  {
+    root_stats_buf_by_pos[i] = root_stats_ptr;
+
+    root_stats_ptr += CHARSIZ;
+  }
+
+  u64 *markov_stats_buf = (u64 *) mycalloc (SP_MARKOV_CNT, sizeof (u64));
 
   u64 *markov_stats_ptr = markov_stats_buf;
 
@@ -4066,7 +4622,9 @@ void sp_setup_tbl (const char *shared_dir, char *hcstat, uint disable, uint clas
     exit (-1);
   }
 
-  if (fread (root_stats_buf, sizeof (u64), SP_ROOT_CNT, fd) != SP_ROOT_CNT)
+  u64 magic = 0;
+
+  if (fread (&magic, sizeof (u64), 1, fd) != 1)
   {
     log_error ("%s: Could not load data", hcstat);
 
@@ -4075,13 +4633,36 @@ void sp_setup_tbl (const char *shared_dir, char *hcstat, uint disable, uint clas
     exit (-1);
   }
 
-  if (fread (markov_stats_buf, sizeof (u64), SP_MARKOV_CNT, fd) != SP_MARKOV_CNT)
+  if (magic == SP_HCSTAT2_MAGIC)
   {
-    log_error ("%s: Could not load data", hcstat);
+    if (sp_hcstat2_read (fd, hcstat, root_stats_buf, markov_stats_buf) == -1)
+    {
+      fclose (fd);
 
-    fclose (fd);
+      exit (-1);
+    }
+  }
+  else
+  {
+    rewind (fd);
 
-    exit (-1);
+    if (fread (root_stats_buf, sizeof (u64), SP_ROOT_CNT, fd) != SP_ROOT_CNT)
+    {
+      log_error ("%s: Could not load data", hcstat);
+
+      fclose (fd);
+
+      exit (-1);
+    }
+
+    if (fread (markov_stats_buf, sizeof (u64), SP_MARKOV_CNT, fd) != SP_MARKOV_CNT)
+    {
+      log_error ("%s: Could not load data", hcstat);
+
+      fclose (fd);
+
+      exit (-1);
+    }
   }
 
   fclose (fd);
@@ -4324,1856 +4905,2961 @@ void sp_stretch_markov (hcstat_table_t *in, hcstat_table_t *out)
 }
 
 /**
- * mixed shared functions
+ * hcstat training
  */
 
-void dump_hex (const u8 *s, const int sz)
+#define SP_CTX2_EMPTY 0xffffffff
+
+static u64 sp_ctx2_hash (u32 key)
 {
-  for (int i = 0; i < sz; i++)
-  {
-    log_info_nn ("%02x ", s[i]);
-  }
+  key ^= key >> 16;
+  key *= 0x85ebca6b;
+  key ^= key >> 13;
+  key *= 0xc2b2ae35;
+  key ^= key >> 16;
 
-  log_info ("");
+  return key;
 }
 
-void usage_mini_print (const char *progname)
+static void sp_ctx2_init (sp_ctx2_t *ctx2, const u64 size)
 {
-  for (uint i = 0; USAGE_MINI[i] != NULL; i++) log_info (USAGE_MINI[i], progname);
-}
+  ctx2->keys = (u32 *) mymalloc (size * sizeof (u32));
+  ctx2->vals = (u64 *) mycalloc (size,  sizeof (u64));
+  ctx2->size = size;
+  ctx2->cnt  = 0;
 
-void usage_big_print (const char *progname)
-{
-  for (uint i = 0; USAGE_BIG[i] != NULL; i++) log_info (USAGE_BIG[i], progname);
+  memset (ctx2->keys, 0xff, size * sizeof (u32));
 }
 
-char *get_exec_path ()
+static void sp_ctx2_free (sp_ctx2_t *ctx2)
 {
-  int exec_path_len = 1024;
-
-  char *exec_path = (char *) mymalloc (exec_path_len);
+  myfree (ctx2->keys);
+  myfree (ctx2->vals);
 
-  #ifdef __linux__
+  memset (ctx2, 0, sizeof (sp_ctx2_t));
+}
 
-  char tmp[32] = { 0 };
+static void sp_ctx2_add (sp_ctx2_t *ctx2, const u32 key, const u64 val);
 
-  snprintf (tmp, sizeof (tmp) - 1, "/proc/%d/exe", getpid ());
+static void sp_ctx2_grow (sp_ctx2_t *ctx2)
+{
+  sp_ctx2_t old = *ctx2;
 
-  const int len = readlink (tmp, exec_path, exec_path_len - 1);
+  sp_ctx2_init (ctx2, old.size * 2);
 
-  #elif WIN
+  for (u64 i = 0; i < old.size; i++)
+  {
+    if (old.keys[i] == SP_CTX2_EMPTY) continue;
 
-  const int len = GetModuleFileName (NULL, exec_path, exec_path_len - 1);
+    sp_ctx2_add (ctx2, old.keys[i], old.vals[i]);
+  }
 
-  #elif __APPLE__
+  sp_ctx2_free (&old);
+}
 
-  uint size = exec_path_len;
+static void sp_ctx2_add (sp_ctx2_t *ctx2, const u32 key, const u64 val)
+{
+  if ((ctx2->cnt * 2) >= ctx2->size) sp_ctx2_grow (ctx2);
 
-  if (_NSGetExecutablePath (exec_path, &size) != 0)
-  {
-    log_error("! executable path buffer too small\n");
+  const u64 mask = ctx2->size - 1;
 
-    exit (-1);
-  }
+  u64 pos = sp_ctx2_hash (key) & mask;
 
-  const int len = strlen (exec_path);
+  while (ctx2->keys[pos] != SP_CTX2_EMPTY)
+  {
+    if (ctx2->keys[pos] == key)
+    {
+      ctx2->vals[pos] += val;
 
-  #elif __FreeBSD__
+      return;
+    }
 
-  #include <sys/sysctl.h>
+    pos = (pos + 1) & mask;
+  }
 
-  int mib[4];
-  mib[0] = CTL_KERN;
-  mib[1] = KERN_PROC;
-  mib[2] = KERN_PROC_PATHNAME;
-  mib[3] = -1;
+  ctx2->keys[pos] = key;
+  ctx2->vals[pos] = val;
 
-  char tmp[32] = { 0 };
+  ctx2->cnt++;
+}
 
-  size_t size = exec_path_len;
-  sysctl(mib, 4, exec_path, &size, NULL, 0);
+static u64 sp_ctx2_get (const sp_ctx2_t *ctx2, const u32 key)
+{
+  const u64 mask = ctx2->size - 1;
 
-  const int len = readlink (tmp, exec_path, exec_path_len - 1);
+  u64 pos = sp_ctx2_hash (key) & mask;
 
-  #else
-  #error Your Operating System is not supported or detected
-  #endif
+  while (ctx2->keys[pos] != SP_CTX2_EMPTY)
+  {
+    if (ctx2->keys[pos] == key) return ctx2->vals[pos];
 
-  exec_path[len] = 0;
+    pos = (pos + 1) & mask;
+  }
 
-  return exec_path;
+  return 0;
 }
 
-char *get_install_dir (const char *progname)
+static void sp_train_word (sp_train_t *sp_train, const u8 *pw_buf, const uint pw_len)
 {
-  char *install_dir = mystrdup (progname);
-  char *last_slash  = NULL;
+  const uint len = MIN (pw_len, SP_PW_MAX);
 
-  if ((last_slash = strrchr (install_dir, '/')) != NULL)
+  u64 *root_stats_buf   = sp_train->root_stats_buf;
+  u64 *markov_stats_buf = sp_train->markov_stats_buf;
+
+  for (uint i = 0; i < len; i++)
   {
-    *last_slash = 0;
+    root_stats_buf[(i * CHARSIZ) + pw_buf[i]]++;
   }
-  else if ((last_slash = strrchr (install_dir, '\\')) != NULL)
+
+  for (uint i = 1; i < len; i++)
   {
-    *last_slash = 0;
+    markov_stats_buf[(((i - 1) * CHARSIZ) + pw_buf[i - 1]) * CHARSIZ + pw_buf[i]]++;
   }
-  else
+
+  if (sp_train->order >= 2)
   {
-    install_dir[0] = '.';
-    install_dir[1] = 0;
+    for (uint i = 2; i < len; i++)
+    {
+      const u32 key = (i << 24) | (pw_buf[i - 2] << 16) | (pw_buf[i - 1] << 8) | pw_buf[i];
+
+      sp_ctx2_add (&sp_train->ctx2, key, 1);
+    }
   }
 
-  return (install_dir);
+  sp_train->words_cnt++;
 }
 
-char *get_profile_dir (const char *homedir)
+static void sp_train_line (sp_train_t *sp_train, char *line_buf, uint line_len)
 {
-  #define DOT_HASHCAT ".hashcat"
+  if ((line_len > 0) && (line_buf[line_len - 1] == '\r')) line_len--;
 
-  size_t len = strlen (homedir) + 1 + strlen (DOT_HASHCAT) + 1;
+  if (sp_train->potfile == 1)
+  {
+    // the plain is everything after the first separator, so plains containing the separator stay intact
+    // there is no hash-type here to tell where a salted hash ends, hash:salt:plain lines train on salt:plain
 
-  char *profile_dir = (char *) mymalloc (len + 1);
+    char *sep_ptr = (char *) memchr (line_buf, sp_train->separator, line_len);
 
-  snprintf (profile_dir, len, "%s/%s", homedir, DOT_HASHCAT);
+    if (sep_ptr == NULL) return;
 
-  return profile_dir;
-}
+    const uint sep_pos = sep_ptr - line_buf + 1;
 
-char *get_session_dir (const char *profile_dir)
-{
-  #define SESSIONS_FOLDER "sessions"
+    line_buf += sep_pos;
+    line_len -= sep_pos;
+  }
 
-  size_t len = strlen (profile_dir) + 1 + strlen (SESSIONS_FOLDER) + 1;
+  if ((line_len >= 6) && ((line_len & 1) == 0) && (memcmp (line_buf, "$HEX[", 5) == 0) && (line_buf[line_len - 1] == ']'))
+  {
+    uint i;
+    uint j;
 
-  char *session_dir = (char *) mymalloc (len + 1);
+    for (i = 0, j = 5; j < line_len - 1; i += 1, j += 2)
+    {
+      line_buf[i] = hex_to_u8 ((const u8 *) &line_buf[j]);
+    }
 
-  snprintf (session_dir, len, "%s/%s", profile_dir, SESSIONS_FOLDER);
+    line_len = i;
+  }
 
-  return session_dir;
+  if (line_len == 0) return;
+
+  sp_train_word (sp_train, (const u8 *) line_buf, line_len);
 }
 
-uint count_lines (FILE *fd)
+static void *sp_train_thread (void *p)
 {
-  uint cnt = 0;
+  sp_train_t *sp_train = (sp_train_t *) p;
 
-  char *buf = (char *) mymalloc (HCBUFSIZ + 1);
+  FILE *fp = fopen (sp_train->file, "rb");
 
-  char prev = '\n';
+  if (fp == NULL) return NULL;
 
-  while (!feof (fd))
-  {
-    size_t nread = fread (buf, sizeof (char), HCBUFSIZ, fd);
+  // a line belongs to the range in which its first byte is located
 
-    if (nread < 1) continue;
+  u64 pos = sp_train->start;
 
-    size_t i;
+  uint skip = 0;
 
-    for (i = 0; i < nread; i++)
-    {
-      if (prev == '\n') cnt++;
+  if (pos > 0)
+  {
+    pos--;
 
-      prev = buf[i];
-    }
+    skip = 1;
   }
 
-  myfree (buf);
-
-  return cnt;
-}
+  #ifdef _WIN
+  _fseeki64 (fp, pos, SEEK_SET);
+  #else
+  fseeko (fp, pos, SEEK_SET);
+  #endif
 
-void truecrypt_crc32 (const char *filename, u8 keytab[64])
-{
-  uint crc = ~0;
+  char *buf      = (char *) mymalloc (HCBUFSIZ);
+  char *line_buf = (char *) mymalloc (HCBUFSIZ);
 
-  FILE *fd = fopen (filename, "rb");
+  uint line_len = 0;
+  uint in_line  = 0;
+  uint done     = 0;
 
-  if (fd == NULL)
+  while (done == 0)
   {
-    log_error ("%s: %s", filename, strerror (errno));
+    const size_t nread = fread (buf, 1, HCBUFSIZ, fp);
 
-    exit (-1);
-  }
+    if (nread == 0) break;
 
-  #define MAX_KEY_SIZE (1024 * 1024)
+    for (size_t i = 0; i < nread; i++, pos++)
+    {
+      const char c = buf[i];
 
-  u8 *buf = (u8 *) mymalloc (MAX_KEY_SIZE + 1);
+      if (skip == 1)
+      {
+        if (c == '\n') skip = 0;
 
-  int nread = fread (buf, sizeof (u8), MAX_KEY_SIZE, fd);
+        continue;
+      }
 
-  fclose (fd);
+      if (in_line == 0)
+      {
+        if (pos >= sp_train->stop)
+        {
+          done = 1;
 
-  int kpos = 0;
+          break;
+        }
 
-  for (int fpos = 0; fpos < nread; fpos++)
-  {
-    crc = crc32tab[(crc ^ buf[fpos]) & 0xff] ^ (crc >> 8);
+        in_line  = 1;
+        line_len = 0;
+      }
 
-    keytab[kpos++] += (crc >> 24) & 0xff;
-    keytab[kpos++] += (crc >> 16) & 0xff;
-    keytab[kpos++] += (crc >>  8) & 0xff;
-    keytab[kpos++] += (crc >>  0) & 0xff;
+      if (c == '\n')
+      {
+        sp_train_line (sp_train, line_buf, line_len);
 
-    if (kpos >= 64) kpos = 0;
+        in_line = 0;
+
+        continue;
+      }
+
+      if (line_len < HCBUFSIZ) line_buf[line_len++] = c;
+    }
   }
 
+  if (in_line == 1) sp_train_line (sp_train, line_buf, line_len);
+
+  myfree (line_buf);
   myfree (buf);
+
+  fclose (fp);
+
+  return NULL;
 }
 
-#ifdef __APPLE__
-int pthread_setaffinity_np (pthread_t thread, size_t cpu_size, cpu_set_t *cpu_set)
+static int sp_hcstat2_write (const char *hcstat, const uint order, const u64 words_cnt, const u64 *root_stats_buf, const u64 *markov_stats_buf, const u32 *ctx2_keys, const u64 *ctx2_vals, const u64 ctx2_cnt)
 {
-  int core;
+  hcstat2_header_t header;
 
-  for (core = 0; core < (8 * (int)cpu_size); core++)
-    if (CPU_ISSET(core, cpu_set)) break;
+  memset (&header, 0, sizeof (hcstat2_header_t));
 
-  thread_affinity_policy_data_t policy = { core };
+  header.magic     = SP_HCSTAT2_MAGIC;
+  header.version   = SP_HCSTAT2_VERSION;
+  header.order     = order;
+  header.pw_max    = SP_PW_MAX;
+  header.charsiz   = CHARSIZ;
+  header.words_cnt = words_cnt;
 
-  const int rc = thread_policy_set (pthread_mach_thread_np (thread), THREAD_AFFINITY_POLICY, (thread_policy_t) &policy, 1);
+  u8 *section_bufs[SP_HCSTAT2_SECTIONS_MAX] = { NULL };
 
-  if (data.quiet == 0)
+  const u64 *stats_bufs[2] = { root_stats_buf,  markov_stats_buf  };
+  const u64  stats_cnts[2] = { SP_ROOT_CNT,     SP_MARKOV_CNT     };
+  const u32  stats_type[2] = { SP_SECTION_ROOT, SP_SECTION_MARKOV };
+
+  u64 offset = sizeof (hcstat2_header_t);
+
+  for (uint i = 0; i < 2; i++)
   {
-    if (rc != KERN_SUCCESS)
-    {
-      log_error ("ERROR: %s : %d", "thread_policy_set()", rc);
-    }
-  }
+    hcstat2_section_t *section = &header.sections[header.sections_cnt];
 
-  return rc;
-}
-#endif
+    const size_t raw_len = stats_cnts[i] * sizeof (u64);
 
-void set_cpu_affinity (char *cpu_affinity)
-{
-  #ifdef _WIN
-  DWORD_PTR aff_mask = 0;
-  #elif __FreeBSD__
-  cpuset_t cpuset;
-  CPU_ZERO (&cpuset);
-  #elif _POSIX
-  cpu_set_t cpuset;
-  CPU_ZERO (&cpuset);
-  #endif
+    u8 *section_buf = (u8 *) mymalloc (raw_len);
 
-  if (cpu_affinity)
-  {
-    char *devices = strdup (cpu_affinity);
+    size_t section_len = 0;
 
-    char *next = strtok (devices, ",");
+    // keep the section raw if compression does not pay off
+    // sections stay 8-byte aligned, but the loader reads and decodes them, nothing is mapped in-place
 
-    do
+    if (sp_zrle_encode (stats_bufs[i], stats_cnts[i], section_buf, raw_len, &section_len) == 0)
     {
-      uint cpu_id = atoi (next);
-
-      if (cpu_id == 0)
-      {
-        #ifdef _WIN
-        aff_mask = 0;
-        #elif _POSIX
-        CPU_ZERO (&cpuset);
-        #endif
+      section->encoding = SP_ENCODING_ZRLE;
+    }
+    else
+    {
+      memcpy (section_buf, stats_bufs[i], raw_len);
 
-        break;
-      }
+      section->encoding = SP_ENCODING_RAW;
 
-      if (cpu_id > 32)
-      {
-        log_error ("ERROR: Invalid cpu_id %u specified", cpu_id);
+      section_len = raw_len;
+    }
 
-        exit (-1);
-      }
+    offset = (offset + 7) & ~7ull;
 
-      #ifdef _WIN
-      aff_mask |= 1u << (cpu_id - 1);
-      #elif _POSIX
-      CPU_SET ((cpu_id - 1), &cpuset);
-      #endif
+    section->type   = stats_type[i];
+    section->offset = offset;
+    section->length = section_len;
+    section->count  = stats_cnts[i];
 
-    } while ((next = strtok (NULL, ",")) != NULL);
+    section_bufs[header.sections_cnt++] = section_buf;
 
-    free (devices);
+    offset += section_len;
   }
 
-  #ifdef _WIN
-  SetProcessAffinityMask (GetCurrentProcess (), aff_mask);
-  SetThreadAffinityMask (GetCurrentThread (), aff_mask);
-  #elif __FreeBSD__
-  pthread_t thread = pthread_self ();
-  pthread_setaffinity_np (thread, sizeof (cpuset_t), &cpuset);
-  #elif _POSIX
-  pthread_t thread = pthread_self ();
-  pthread_setaffinity_np (thread, sizeof (cpu_set_t), &cpuset);
-  #endif
-}
+  if (order >= 2)
+  {
+    hcstat2_section_t *section = &header.sections[header.sections_cnt];
 
-void *rulefind (const void *key, void *base, int nmemb, size_t size, int (*compar) (const void *, const void *))
-{
-  char *element, *end;
+    // sorted (pos << 24 | c2 << 16 | c1 << 8 | c) keys, stored as key delta and counter
 
-  end = (char *) base + nmemb * size;
+    u8 *section_buf = (u8 *) mymalloc ((ctx2_cnt * 20) + 1);
 
-  for (element = (char *) base; element < end; element += size)
-    if (!compar (element, key))
-      return element;
+    size_t section_len = 0;
 
-  return NULL;
-}
+    u32 key_prev = 0;
 
-int sort_by_u32 (const void *v1, const void *v2)
-{
-  const u32 *s1 = (const u32 *) v1;
-  const u32 *s2 = (const u32 *) v2;
+    for (u64 i = 0; i < ctx2_cnt; i++)
+    {
+      section_len += sp_varint_put (section_buf + section_len, ctx2_keys[i] - key_prev);
+      section_len += sp_varint_put (section_buf + section_len, ctx2_vals[i]);
 
-  return *s1 - *s2;
-}
+      key_prev = ctx2_keys[i];
+    }
 
-int sort_by_salt (const void *v1, const void *v2)
-{
-  const salt_t *s1 = (const salt_t *) v1;
-  const salt_t *s2 = (const salt_t *) v2;
+    offset = (offset + 7) & ~7ull;
 
-  const int res1 = s1->salt_len - s2->salt_len;
+    section->type     = SP_SECTION_MARKOV2;
+    section->encoding = SP_ENCODING_SPARSE;
+    section->offset   = offset;
+    section->length   = section_len;
+    section->count    = ctx2_cnt;
 
-  if (res1 != 0) return (res1);
+    section_bufs[header.sections_cnt++] = section_buf;
 
-  const int res2 = s1->salt_iter - s2->salt_iter;
+    offset += section_len;
+  }
 
-  if (res2 != 0) return (res2);
+  FILE *fp = fopen (hcstat, "wb");
 
-  uint n;
+  if (fp == NULL)
+  {
+    log_error ("ERROR: %s: %s", hcstat, strerror (errno));
 
-  n = 16;
+    for (uint i = 0; i < header.sections_cnt; i++) myfree (section_bufs[i]);
 
-  while (n--)
-  {
-    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
-    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
+    return -1;
   }
 
-  n = 8;
+  int rc = 0;
 
-  while (n--)
+  if (fwrite (&header, sizeof (hcstat2_header_t), 1, fp) != 1) rc = -1;
+
+  u64 pos = sizeof (hcstat2_header_t);
+
+  for (uint i = 0; i < header.sections_cnt; i++)
   {
-    if (s1->salt_buf_pc[n] > s2->salt_buf_pc[n]) return ( 1);
-    if (s1->salt_buf_pc[n] < s2->salt_buf_pc[n]) return -1;
-  }
+    hcstat2_section_t *section = &header.sections[i];
 
-  return 0;
-}
+    const u8 pad[8] = { 0 };
 
-int sort_by_salt_buf (const void *v1, const void *v2)
-{
-  const pot_t *p1 = (const pot_t *) v1;
-  const pot_t *p2 = (const pot_t *) v2;
+    if (fwrite (pad, 1, section->offset - pos, fp) != (section->offset - pos)) rc = -1;
 
-  const hash_t *h1 = &p1->hash;
-  const hash_t *h2 = &p2->hash;
+    if (fwrite (section_bufs[i], 1, section->length, fp) != section->length) rc = -1;
 
-  const salt_t *s1 = h1->salt;
-  const salt_t *s2 = h2->salt;
+    pos = section->offset + section->length;
 
-  uint n = 16;
+    myfree (section_bufs[i]);
+  }
 
-  while (n--)
+  if (fclose (fp) != 0) rc = -1;
+
+  if (rc == -1)
   {
-    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
-    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
+    log_error ("ERROR: %s: Could not write data", hcstat);
   }
 
-  return 0;
+  return rc;
 }
 
-int sort_by_hash_t_salt (const void *v1, const void *v2)
+int sp_train (const char *hcstat, char **train_files, const uint train_files_cnt, const uint order, const uint potfile, const char separator)
 {
-  const hash_t *h1 = (const hash_t *) v1;
-  const hash_t *h2 = (const hash_t *) v2;
-
-  const salt_t *s1 = h1->salt;
-  const salt_t *s2 = h2->salt;
+  const uint threads_cnt = MIN (get_cpu_cnt (), SP_TRAIN_THREADS_MAX);
 
-  // testphase: this should work
-  uint n = 16;
+  sp_train_t *sp_trains = (sp_train_t *) mycalloc (threads_cnt, sizeof (sp_train_t));
 
-  while (n--)
+  for (uint thread_id = 0; thread_id < threads_cnt; thread_id++)
   {
-    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
-    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
+    sp_train_t *sp_train = &sp_trains[thread_id];
+
+    sp_train->order     = order;
+    sp_train->potfile   = potfile;
+    sp_train->separator = separator;
+
+    sp_train->root_stats_buf   = (u64 *) mycalloc (SP_ROOT_CNT,   sizeof (u64));
+    sp_train->markov_stats_buf = (u64 *) mycalloc (SP_MARKOV_CNT, sizeof (u64));
+
+    if (order >= 2) sp_ctx2_init (&sp_train->ctx2, 1u << 16);
   }
 
-  /* original code, seems buggy since salt_len can be very big (had a case with 131 len)
-     also it thinks salt_buf[x] is a char but its a uint so salt_len should be / 4
-  if (s1->salt_len > s2->salt_len) return ( 1);
-  if (s1->salt_len < s2->salt_len) return -1;
+  hc_thread_t *threads = (hc_thread_t *) mycalloc (threads_cnt, sizeof (hc_thread_t));
 
-  uint n = s1->salt_len;
+  int rc = 0;
 
-  while (n--)
+  u64 words_cnt = 0;
+
+  for (uint file_pos = 0; file_pos < train_files_cnt; file_pos++)
   {
-    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
-    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
-  }
-  */
+    char *train_file = train_files[file_pos];
 
-  return 0;
-}
+    struct stat st;
 
-int sort_by_hash_t_salt_hccap (const void *v1, const void *v2)
-{
-  const hash_t *h1 = (const hash_t *) v1;
-  const hash_t *h2 = (const hash_t *) v2;
+    if (stat (train_file, &st) == -1)
+    {
+      log_error ("ERROR: %s: %s", train_file, strerror (errno));
 
-  const salt_t *s1 = h1->salt;
-  const salt_t *s2 = h2->salt;
+      rc = -1;
 
-  // last 2: salt_buf[10] and salt_buf[11] contain the digest (skip them)
+      break;
+    }
 
-  uint n = 9; // 9 * 4 = 36 bytes (max length of ESSID)
+    if (S_ISDIR (st.st_mode))
+    {
+      log_error ("ERROR: %s: Is a directory", train_file);
 
-  while (n--)
-  {
-    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
-    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
-  }
+      rc = -1;
 
-  return 0;
-}
+      break;
+    }
 
-int sort_by_hash_no_salt (const void *v1, const void *v2)
-{
-  const hash_t *h1 = (const hash_t *) v1;
-  const hash_t *h2 = (const hash_t *) v2;
+    FILE *fp = fopen (train_file, "rb");
 
-  const void *d1 = h1->digest;
-  const void *d2 = h2->digest;
+    if (fp == NULL)
+    {
+      log_error ("ERROR: %s: %s", train_file, strerror (errno));
 
-  return data.sort_by_digest (d1, d2);
-}
+      rc = -1;
 
-int sort_by_hash (const void *v1, const void *v2)
-{
-  const hash_t *h1 = (const hash_t *) v1;
-  const hash_t *h2 = (const hash_t *) v2;
+      break;
+    }
 
-  if (data.isSalted)
-  {
-    const salt_t *s1 = h1->salt;
-    const salt_t *s2 = h2->salt;
+    fclose (fp);
 
-    int res = sort_by_salt (s1, s2);
+    const u64 file_size = st.st_size;
 
-    if (res != 0) return (res);
-  }
+    // small files are not worth splitting
 
-  const void *d1 = h1->digest;
-  const void *d2 = h2->digest;
+    const uint file_threads_cnt = (file_size < (1024 * 1024)) ? 1 : threads_cnt;
 
-  return data.sort_by_digest (d1, d2);
-}
+    for (uint thread_id = 0; thread_id < file_threads_cnt; thread_id++)
+    {
+      sp_train_t *sp_train = &sp_trains[thread_id];
 
-int sort_by_pot (const void *v1, const void *v2)
-{
-  const pot_t *p1 = (const pot_t *) v1;
-  const pot_t *p2 = (const pot_t *) v2;
+      sp_train->file  = train_file;
+      sp_train->start = (file_size / file_threads_cnt) * thread_id;
+      sp_train->stop  = (thread_id == (file_threads_cnt - 1)) ? file_size : (file_size / file_threads_cnt) * (thread_id + 1);
 
-  const hash_t *h1 = &p1->hash;
-  const hash_t *h2 = &p2->hash;
+      hc_thread_create (threads[thread_id], sp_train_thread, sp_train);
+    }
 
-  return sort_by_hash (h1, h2);
-}
+    hc_thread_wait (file_threads_cnt, threads);
 
-int sort_by_mtime (const void *p1, const void *p2)
-{
-  const char **f1 = (const char **) p1;
-  const char **f2 = (const char **) p2;
+    u64 words_cnt_new = 0;
 
-  struct stat s1; stat (*f1, &s1);
-  struct stat s2; stat (*f2, &s2);
+    for (uint thread_id = 0; thread_id < threads_cnt; thread_id++) words_cnt_new += sp_trains[thread_id].words_cnt;
 
-  return s2.st_mtime - s1.st_mtime;
-}
+    if (data.quiet == 0) log_info ("%s: %llu words", train_file, (unsigned long long int) (words_cnt_new - words_cnt));
 
-int sort_by_cpu_rule (const void *p1, const void *p2)
-{
-  const cpu_rule_t *r1 = (const cpu_rule_t *) p1;
-  const cpu_rule_t *r2 = (const cpu_rule_t *) p2;
+    words_cnt = words_cnt_new;
+  }
 
-  return memcmp (r1, r2, sizeof (cpu_rule_t));
-}
+  myfree (threads);
 
-int sort_by_kernel_rule (const void *p1, const void *p2)
-{
-  const kernel_rule_t *r1 = (const kernel_rule_t *) p1;
-  const kernel_rule_t *r2 = (const kernel_rule_t *) p2;
+  if (rc == 0)
+  {
+    /**
+     * merge per-thread counters into the first thread
+     */
 
-  return memcmp (r1, r2, sizeof (kernel_rule_t));
-}
+    sp_train_t *sp_train = &sp_trains[0];
 
-int sort_by_stringptr (const void *p1, const void *p2)
-{
-  const char **s1 = (const char **) p1;
-  const char **s2 = (const char **) p2;
+    for (uint thread_id = 1; thread_id < threads_cnt; thread_id++)
+    {
+      sp_train_t *sp_train_merge = &sp_trains[thread_id];
 
-  return strcmp (*s1, *s2);
-}
+      for (uint i = 0; i < SP_ROOT_CNT;   i++) sp_train->root_stats_buf[i]   += sp_train_merge->root_stats_buf[i];
+      for (uint i = 0; i < SP_MARKOV_CNT; i++) sp_train->markov_stats_buf[i] += sp_train_merge->markov_stats_buf[i];
 
-int sort_by_dictstat (const void *s1, const void *s2)
-{
-  dictstat_t *d1 = (dictstat_t *) s1;
-  dictstat_t *d2 = (dictstat_t *) s2;
+      if (order < 2) continue;
 
-  #ifdef __linux__
-  d2->stat.st_atim = d1->stat.st_atim;
-  #else
-  d2->stat.st_atime = d1->stat.st_atime;
-  #endif
+      for (u64 i = 0; i < sp_train_merge->ctx2.size; i++)
+      {
+        if (sp_train_merge->ctx2.keys[i] == SP_CTX2_EMPTY) continue;
 
-  return memcmp (&d1->stat, &d2->stat, sizeof (struct stat));
-}
+        sp_ctx2_add (&sp_train->ctx2, sp_train_merge->ctx2.keys[i], sp_train_merge->ctx2.vals[i]);
+      }
 
-int sort_by_bitmap (const void *p1, const void *p2)
-{
-  const bitmap_result_t *b1 = (const bitmap_result_t *) p1;
-  const bitmap_result_t *b2 = (const bitmap_result_t *) p2;
+      sp_ctx2_free (&sp_train_merge->ctx2);
+    }
 
-  return b1->collisions - b2->collisions;
-}
+    u32 *ctx2_keys = NULL;
+    u64 *ctx2_vals = NULL;
+    u64  ctx2_cnt  = 0;
 
-int sort_by_digest_4_2 (const void *v1, const void *v2)
-{
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+    if (order >= 2)
+    {
+      ctx2_keys = (u32 *) mycalloc (sp_train->ctx2.cnt + 1, sizeof (u32));
+      ctx2_vals = (u64 *) mycalloc (sp_train->ctx2.cnt + 1, sizeof (u64));
 
-  uint n = 2;
+      for (u64 i = 0; i < sp_train->ctx2.size; i++)
+      {
+        if (sp_train->ctx2.keys[i] == SP_CTX2_EMPTY) continue;
 
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
-  }
+        ctx2_keys[ctx2_cnt++] = sp_train->ctx2.keys[i];
+      }
 
-  return 0;
-}
+      qsort (ctx2_keys, ctx2_cnt, sizeof (u32), sort_by_u32);
 
-int sort_by_digest_4_4 (const void *v1, const void *v2)
-{
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+      for (u64 i = 0; i < ctx2_cnt; i++) ctx2_vals[i] = sp_ctx2_get (&sp_train->ctx2, ctx2_keys[i]);
+    }
 
-  uint n = 4;
+    rc = sp_hcstat2_write (hcstat, order, words_cnt, sp_train->root_stats_buf, sp_train->markov_stats_buf, ctx2_keys, ctx2_vals, ctx2_cnt);
 
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
-  }
+    if ((rc == 0) && (data.quiet == 0)) log_info ("%s: hcstat v2 (revision %u), order %u, %llu words", hcstat, SP_HCSTAT2_VERSION, order, (unsigned long long int) words_cnt);
 
-  return 0;
-}
+    myfree (ctx2_keys);
+    myfree (ctx2_vals);
+  }
 
-int sort_by_digest_4_5 (const void *v1, const void *v2)
-{
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+  for (uint thread_id = 0; thread_id < threads_cnt; thread_id++)
+  {
+    sp_train_t *sp_train = &sp_trains[thread_id];
 
-  uint n = 5;
+    myfree (sp_train->root_stats_buf);
+    myfree (sp_train->markov_stats_buf);
 
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
+    sp_ctx2_free (&sp_train->ctx2);
   }
 
-  return 0;
-}
+  myfree (sp_trains);
 
-int sort_by_digest_4_6 (const void *v1, const void *v2)
-{
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+  return rc;
+}
 
-  uint n = 6;
+/**
+ * mixed shared functions
+ */
 
-  while (n--)
+void dump_hex (const u8 *s, const int sz)
+{
+  for (int i = 0; i < sz; i++)
   {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
+    log_info_nn ("%02x ", s[i]);
   }
 
-  return 0;
+  log_info ("");
 }
 
-int sort_by_digest_4_8 (const void *v1, const void *v2)
+void usage_mini_print (const char *progname)
 {
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
-
-  uint n = 8;
-
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
-  }
+  for (uint i = 0; USAGE_MINI[i] != NULL; i++) log_info (USAGE_MINI[i], progname);
+}
 
-  return 0;
+void usage_big_print (const char *progname)
+{
+  for (uint i = 0; USAGE_BIG[i] != NULL; i++) log_info (USAGE_BIG[i], progname);
 }
 
-int sort_by_digest_4_16 (const void *v1, const void *v2)
+char *get_exec_path ()
 {
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+  int exec_path_len = 1024;
 
-  uint n = 16;
+  char *exec_path = (char *) mymalloc (exec_path_len);
 
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
-  }
+  #ifdef __linux__
 
-  return 0;
-}
+  char tmp[32] = { 0 };
 
-int sort_by_digest_4_32 (const void *v1, const void *v2)
-{
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+  snprintf (tmp, sizeof (tmp) - 1, "/proc/%d/exe", getpid ());
 
-  uint n = 32;
+  const int len = readlink (tmp, exec_path, exec_path_len - 1);
 
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
-  }
+  #elif WIN
 
-  return 0;
-}
+  const int len = GetModuleFileName (NULL, exec_path, exec_path_len - 1);
 
-int sort_by_digest_4_64 (const void *v1, const void *v2)
-{
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+  #elif __APPLE__
 
-  uint n = 64;
+  uint size = exec_path_len;
 
-  while (n--)
+  if (_NSGetExecutablePath (exec_path, &size) != 0)
   {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
+    log_error("! executable path buffer too small\n");
+
+    exit (-1);
   }
 
-  return 0;
-}
+  const int len = strlen (exec_path);
 
-int sort_by_digest_8_8 (const void *v1, const void *v2)
-{
-  const u64 *d1 = (const u64 *) v1;
-  const u64 *d2 = (const u64 *) v2;
+  #elif __FreeBSD__
 
-  uint n = 8;
+  #include <sys/sysctl.h>
 
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
-  }
+  int mib[4];
+  mib[0] = CTL_KERN;
+  mib[1] = KERN_PROC;
+  mib[2] = KERN_PROC_PATHNAME;
+  mib[3] = -1;
 
-  return 0;
-}
+  char tmp[32] = { 0 };
 
-int sort_by_digest_8_16 (const void *v1, const void *v2)
-{
-  const u64 *d1 = (const u64 *) v1;
-  const u64 *d2 = (const u64 *) v2;
+  size_t size = exec_path_len;
+  sysctl(mib, 4, exec_path, &size, NULL, 0);
 
-  uint n = 16;
+  const int len = readlink (tmp, exec_path, exec_path_len - 1);
 
-  while (n--)
-  {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
-  }
+  #else
+  #error Your Operating System is not supported or detected
+  #endif
 
-  return 0;
+  exec_path[len] = 0;
+
+  return exec_path;
 }
 
-int sort_by_digest_8_25 (const void *v1, const void *v2)
+char *get_install_dir (const char *progname)
 {
-  const u64 *d1 = (const u64 *) v1;
-  const u64 *d2 = (const u64 *) v2;
-
-  uint n = 25;
+  char *install_dir = mystrdup (progname);
+  char *last_slash  = NULL;
 
-  while (n--)
+  if ((last_slash = strrchr (install_dir, '/')) != NULL)
   {
-    if (d1[n] > d2[n]) return ( 1);
-    if (d1[n] < d2[n]) return -1;
+    *last_slash = 0;
+  }
+  else if ((last_slash = strrchr (install_dir, '\\')) != NULL)
+  {
+    *last_slash = 0;
+  }
+  else
+  {
+    install_dir[0] = '.';
+    install_dir[1] = 0;
   }
 
-  return 0;
+  return (install_dir);
 }
 
-int sort_by_digest_p0p1 (const void *v1, const void *v2)
+char *get_profile_dir (const char *homedir)
 {
-  const u32 *d1 = (const u32 *) v1;
-  const u32 *d2 = (const u32 *) v2;
+  #define DOT_HASHCAT ".hashcat"
 
-  const uint dgst_pos0 = data.dgst_pos0;
-  const uint dgst_pos1 = data.dgst_pos1;
-  const uint dgst_pos2 = data.dgst_pos2;
-  const uint dgst_pos3 = data.dgst_pos3;
+  size_t len = strlen (homedir) + 1 + strlen (DOT_HASHCAT) + 1;
 
-  if (d1[dgst_pos3] > d2[dgst_pos3]) return ( 1);
-  if (d1[dgst_pos3] < d2[dgst_pos3]) return -1;
-  if (d1[dgst_pos2] > d2[dgst_pos2]) return ( 1);
-  if (d1[dgst_pos2] < d2[dgst_pos2]) return -1;
-  if (d1[dgst_pos1] > d2[dgst_pos1]) return ( 1);
-  if (d1[dgst_pos1] < d2[dgst_pos1]) return -1;
-  if (d1[dgst_pos0] > d2[dgst_pos0]) return ( 1);
-  if (d1[dgst_pos0] < d2[dgst_pos0]) return -1;
+  char *profile_dir = (char *) mymalloc (len + 1);
 
-  return 0;
+  snprintf (profile_dir, len, "%s/%s", homedir, DOT_HASHCAT);
+
+  return profile_dir;
 }
 
-int sort_by_tuning_db_alias (const void *v1, const void *v2)
+char *get_session_dir (const char *profile_dir)
 {
-  const tuning_db_alias_t *t1 = (const tuning_db_alias_t *) v1;
-  const tuning_db_alias_t *t2 = (const tuning_db_alias_t *) v2;
+  #define SESSIONS_FOLDER "sessions"
 
-  const int res1 = strcmp (t1->device_name, t2->device_name);
+  size_t len = strlen (profile_dir) + 1 + strlen (SESSIONS_FOLDER) + 1;
 
-  if (res1 != 0) return (res1);
+  char *session_dir = (char *) mymalloc (len + 1);
 
-  return 0;
+  snprintf (session_dir, len, "%s/%s", profile_dir, SESSIONS_FOLDER);
+
+  return session_dir;
 }
 
-int sort_by_tuning_db_entry (const void *v1, const void *v2)
+uint count_lines (FILE *fd)
 {
-  const tuning_db_entry_t *t1 = (const tuning_db_entry_t *) v1;
-  const tuning_db_entry_t *t2 = (const tuning_db_entry_t *) v2;
+  uint cnt = 0;
 
-  const int res1 = strcmp (t1->device_name, t2->device_name);
+  char *buf = (char *) mymalloc (HCBUFSIZ + 1);
 
-  if (res1 != 0) return (res1);
+  char prev = '\n';
 
-  const int res2 = t1->attack_mode
-                 - t2->attack_mode;
+  while (!feof (fd))
+  {
+    size_t nread = fread (buf, sizeof (char), HCBUFSIZ, fd);
 
-  if (res2 != 0) return (res2);
+    if (nread < 1) continue;
 
-  const int res3 = t1->hash_type
-                 - t2->hash_type;
+    size_t i;
 
-  if (res3 != 0) return (res3);
+    for (i = 0; i < nread; i++)
+    {
+      if (prev == '\n') cnt++;
 
-  return 0;
+      prev = buf[i];
+    }
+  }
+
+  myfree (buf);
+
+  return cnt;
 }
 
-void format_debug (char *debug_file, uint debug_mode, unsigned char *orig_plain_ptr, uint orig_plain_len, unsigned char *mod_plain_ptr, uint mod_plain_len, char *rule_buf, int rule_len)
+void truecrypt_crc32 (const char *filename, u8 keytab[64])
 {
-  uint outfile_autohex = data.outfile_autohex;
-
-  unsigned char *rule_ptr = (unsigned char *) rule_buf;
+  uint crc = ~0;
 
-  FILE *debug_fp = NULL;
+  FILE *fd = fopen (filename, "rb");
 
-  if (debug_file != NULL)
+  if (fd == NULL)
   {
-    debug_fp = fopen (debug_file, "ab");
+    log_error ("%s: %s", filename, strerror (errno));
 
-    lock_file (debug_fp);
-  }
-  else
-  {
-    debug_fp = stderr;
+    exit (-1);
   }
 
-  if (debug_fp == NULL)
+  #define MAX_KEY_SIZE (1024 * 1024)
+
+  u8 *buf = (u8 *) mymalloc (MAX_KEY_SIZE + 1);
+
+  int nread = fread (buf, sizeof (u8), MAX_KEY_SIZE, fd);
+
+  fclose (fd);
+
+  int kpos = 0;
+
+  for (int fpos = 0; fpos < nread; fpos++)
   {
-    log_info ("WARNING: Could not open debug-file for writing");
+    crc = crc32tab[(crc ^ buf[fpos]) & 0xff] ^ (crc >> 8);
+
+    keytab[kpos++] += (crc >> 24) & 0xff;
+    keytab[kpos++] += (crc >> 16) & 0xff;
+    keytab[kpos++] += (crc >>  8) & 0xff;
+    keytab[kpos++] += (crc >>  0) & 0xff;
+
+    if (kpos >= 64) kpos = 0;
   }
-  else
-  {
-    if ((debug_mode == 2) || (debug_mode == 3) || (debug_mode == 4))
-    {
-      format_plain (debug_fp, orig_plain_ptr, orig_plain_len, outfile_autohex);
 
-      if ((debug_mode == 3) || (debug_mode == 4)) fputc (':', debug_fp);
-    }
+  myfree (buf);
+}
 
-    fwrite (rule_ptr, rule_len, 1, debug_fp);
+#ifdef __APPLE__
+int pthread_setaffinity_np (pthread_t thread, size_t cpu_size, cpu_set_t *cpu_set)
+{
+  int core;
 
-    if (debug_mode == 4)
-    {
-      fputc (':', debug_fp);
+  for (core = 0; core < (8 * (int)cpu_size); core++)
+    if (CPU_ISSET(core, cpu_set)) break;
 
-      format_plain (debug_fp, mod_plain_ptr, mod_plain_len, outfile_autohex);
-    }
+  thread_affinity_policy_data_t policy = { core };
 
-    fputc  ('\n', debug_fp);
+  const int rc = thread_policy_set (pthread_mach_thread_np (thread), THREAD_AFFINITY_POLICY, (thread_policy_t) &policy, 1);
 
-    if (debug_file != NULL) fclose (debug_fp);
+  if (data.quiet == 0)
+  {
+    if (rc != KERN_SUCCESS)
+    {
+      log_error ("ERROR: %s : %d", "thread_policy_set()", rc);
+    }
   }
+
+  return rc;
 }
+#endif
 
-void format_plain (FILE *fp, unsigned char *plain_ptr, uint plain_len, uint outfile_autohex)
+void set_cpu_affinity (char *cpu_affinity)
 {
-  int needs_hexify = 0;
+  #ifdef _WIN
+  DWORD_PTR aff_mask = 0;
+  #elif __FreeBSD__
+  cpuset_t cpuset;
+  CPU_ZERO (&cpuset);
+  #elif _POSIX
+  cpu_set_t cpuset;
+  CPU_ZERO (&cpuset);
+  #endif
 
-  if (outfile_autohex == 1)
+  if (cpu_affinity)
   {
-    for (uint i = 0; i < plain_len; i++)
+    char *devices = strdup (cpu_affinity);
+
+    char *next = strtok (devices, ",");
+
+    do
     {
-      if (plain_ptr[i] < 0x20)
+      uint cpu_id = atoi (next);
+
+      if (cpu_id == 0)
       {
-        needs_hexify = 1;
+        #ifdef _WIN
+        aff_mask = 0;
+        #elif _POSIX
+        CPU_ZERO (&cpuset);
+        #endif
 
         break;
       }
 
-      if (plain_ptr[i] > 0x7f)
+      if (cpu_id > 32)
       {
-        needs_hexify = 1;
+        log_error ("ERROR: Invalid cpu_id %u specified", cpu_id);
 
-        break;
+        exit (-1);
       }
-    }
-  }
 
-  if (needs_hexify == 1)
-  {
-    fprintf (fp, "$HEX[");
+      #ifdef _WIN
+      aff_mask |= 1u << (cpu_id - 1);
+      #elif _POSIX
+      CPU_SET ((cpu_id - 1), &cpuset);
+      #endif
 
-    for (uint i = 0; i < plain_len; i++)
-    {
-      fprintf (fp, "%02x", plain_ptr[i]);
-    }
+    } while ((next = strtok (NULL, ",")) != NULL);
 
-    fprintf (fp, "]");
-  }
-  else
-  {
-    fwrite (plain_ptr, plain_len, 1, fp);
+    free (devices);
   }
+
+  #ifdef _WIN
+  SetProcessAffinityMask (GetCurrentProcess (), aff_mask);
+  SetThreadAffinityMask (GetCurrentThread (), aff_mask);
+  #elif __FreeBSD__
+  pthread_t thread = pthread_self ();
+  pthread_setaffinity_np (thread, sizeof (cpuset_t), &cpuset);
+  #elif _POSIX
+  pthread_t thread = pthread_self ();
+  pthread_setaffinity_np (thread, sizeof (cpu_set_t), &cpuset);
+  #endif
 }
 
-void format_output (FILE *out_fp, char *out_buf, unsigned char *plain_ptr, const uint plain_len, const u64 crackpos, unsigned char *username, const uint user_len)
+uint get_cpu_cnt ()
 {
-  uint outfile_format = data.outfile_format;
+  #ifdef _WIN
+  SYSTEM_INFO info;
 
-  char separator = data.separator;
+  GetSystemInfo (&info);
 
-  if (outfile_format & OUTFILE_FMT_HASH)
-  {
-    fprintf (out_fp, "%s", out_buf);
+  return info.dwNumberOfProcessors;
+  #elif _POSIX
+  const long cnt = sysconf (_SC_NPROCESSORS_ONLN);
 
-    if (outfile_format & (OUTFILE_FMT_PLAIN | OUTFILE_FMT_HEXPLAIN | OUTFILE_FMT_CRACKPOS))
-    {
-      fputc (separator, out_fp);
-    }
-  }
-  else if (data.username)
-  {
-    if (username != NULL)
-    {
-      for (uint i = 0; i < user_len; i++)
-      {
-        fprintf (out_fp, "%c", username[i]);
-      }
+  return (cnt < 1) ? 1 : (uint) cnt;
+  #endif
+}
 
-      if (outfile_format & (OUTFILE_FMT_PLAIN | OUTFILE_FMT_HEXPLAIN | OUTFILE_FMT_CRACKPOS))
-      {
-        fputc (separator, out_fp);
-      }
-    }
-  }
+/**
+ * bloom filter
+ */
 
-  if (outfile_format & OUTFILE_FMT_PLAIN)
+static u64 bloom_hash (const u8 *buf, const uint len)
+{
+  u64 h = 0xcbf29ce484222325ULL;
+
+  for (uint i = 0; i < len; i++)
   {
-    format_plain (out_fp, plain_ptr, plain_len, data.outfile_autohex);
+    h ^= buf[i];
+    h *= 0x100000001b3ULL;
+  }
 
-    if (outfile_format & (OUTFILE_FMT_HEXPLAIN | OUTFILE_FMT_CRACKPOS))
-    {
-      fputc (separator, out_fp);
-    }
-  }
+  // final avalanche so that the low bits used for indexing depend on all input bytes
 
-  if (outfile_format & OUTFILE_FMT_HEXPLAIN)
-  {
-    for (uint i = 0; i < plain_len; i++)
-    {
-      fprintf (out_fp, "%02x", plain_ptr[i]);
-    }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
 
-    if (outfile_format & (OUTFILE_FMT_CRACKPOS))
-    {
-      fputc (separator, out_fp);
-    }
-  }
+  return h;
+}
 
-  if (outfile_format & OUTFILE_FMT_CRACKPOS)
+void bloom_init (bloom_t *bloom, const u64 size)
+{
+  // round down to a power of two number of bits so we can mask instead of mod
+
+  u64 bits_cnt = 64;
+
+  while ((bits_cnt * 2) <= (size * 8)) bits_cnt *= 2;
+
+  bloom->bits      = (u64 *) mycalloc (bits_cnt / 64, sizeof (u64));
+  bloom->bits_mask = bits_cnt - 1;
+  bloom->added     = 0;
+  bloom->dupes     = 0;
+}
+
+void bloom_free (bloom_t *bloom)
+{
+  myfree (bloom->bits);
+
+  bloom->bits      = NULL;
+  bloom->bits_mask = 0;
+}
+
+int bloom_test (const bloom_t *bloom, const u8 *buf, const uint len)
+{
+  if (bloom->bits == NULL) return 0;
+
+  const u64 h = bloom_hash (buf, len);
+
+  const u64 h1 = h;
+  const u64 h2 = (h >> 32) | 1;
+
+  for (uint i = 0; i < BLOOM_HASHES; i++)
   {
-    #ifdef _WIN
-    __mingw_fprintf (out_fp, "%llu", crackpos);
-    #endif
+    const u64 bit = (h1 + i * h2) & bloom->bits_mask;
 
-    #ifdef _POSIX
-    #ifdef __x86_64__
-    fprintf (out_fp, "%lu", (unsigned long) crackpos);
-    #else
-    fprintf (out_fp, "%llu", crackpos);
-    #endif
-    #endif
+    if ((bloom->bits[bit / 64] & (1ULL << (bit % 64))) == 0) return 0;
   }
 
-  fputs (EOL, out_fp);
+  return 1;
 }
 
-void handle_show_request (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hashes_buf, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
+int bloom_add (bloom_t *bloom, const u8 *buf, const uint len)
 {
-  pot_t pot_key;
+  if (bloom->bits == NULL) return 0;
 
-  pot_key.hash.salt   = hashes_buf->salt;
-  pot_key.hash.digest = hashes_buf->digest;
+  const u64 h = bloom_hash (buf, len);
 
-  pot_t *pot_ptr = (pot_t *) bsearch (&pot_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+  const u64 h1 = h;
+  const u64 h2 = (h >> 32) | 1;
 
-  if (pot_ptr)
-  {
-    log_info_nn ("");
+  int found = 1;
 
-    input_buf[input_len] = 0;
+  for (uint i = 0; i < BLOOM_HASHES; i++)
+  {
+    const u64 bit = (h1 + i * h2) & bloom->bits_mask;
 
-    // user
-    unsigned char *username = NULL;
-    uint user_len = 0;
+    const u64 val = 1ULL << (bit % 64);
 
-    if (data.username)
-    {
-      user_t *user = hashes_buf->hash_info->user;
+    if (bloom->bits[bit / 64] & val) continue;
 
-      if (user)
-      {
-        username = (unsigned char *) (user->user_name);
+    bloom->bits[bit / 64] |= val;
 
-        user_len = user->user_len;
-      }
-    }
+    found = 0;
+  }
 
-    // do output the line
-    format_output (out_fp, input_buf, (unsigned char *) pot_ptr->plain_buf, pot_ptr->plain_len, 0, username, user_len);
+  if (found)
+  {
+    bloom->dupes++;
+  }
+  else
+  {
+    bloom->added++;
   }
+
+  return found;
 }
 
-#define LM_WEAK_HASH    "\x4e\xcf\x0d\x0c\x0a\xe2\xfb\xc1"
-#define LM_MASKED_PLAIN "[notfound]"
+/**
+ * compiled wordlists: a header holding the number of words per length, followed by the words without line
+ * separators, grouped by length in ascending order, so every group is an array of fixed size records
+ * the words are hex decoded, rule processed, length filtered and deduplicated when the file is compiled
+ */
 
-void handle_show_request_lm (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hash_left, hash_t *hash_right, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
+static int wl_compile_add (wl_compile_group_t *group, const char *pw_buf, const uint pw_len)
 {
-  // left
+  if (pw_len == 0)
+  {
+    if (group->cnt) return 0;
 
-  pot_t pot_left_key;
+    group->cnt = 1;
 
-  pot_left_key.hash.salt   = hash_left->salt;
-  pot_left_key.hash.digest = hash_left->digest;
+    return 1;
+  }
 
-  pot_t *pot_left_ptr = (pot_t *) bsearch (&pot_left_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+  // keep the load factor of the open addressing table below 1/2
 
-  // right
+  if (((group->cnt + 1) * 2) > group->table_size)
+  {
+    const u64 table_size = (group->table_size) ? group->table_size * 2 : 1024;
 
-  uint weak_hash_found = 0;
+    u32 *table = (u32 *) mycalloc (table_size, sizeof (u32));
 
-  pot_t pot_right_key;
+    for (u64 i = 0; i < group->cnt; i++)
+    {
+      u64 pos = bloom_hash ((const u8 *) group->buf + (i * pw_len), pw_len) & (table_size - 1);
 
-  pot_right_key.hash.salt   = hash_right->salt;
-  pot_right_key.hash.digest = hash_right->digest;
+      while (table[pos]) pos = (pos + 1) & (table_size - 1);
 
-  pot_t *pot_right_ptr = (pot_t *) bsearch (&pot_right_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+      table[pos] = (u32) (i + 1);
+    }
 
-  if (pot_right_ptr == NULL)
-  {
-    // special case, if "weak hash"
+    myfree (group->table);
 
-    if (memcmp (hash_right->digest, LM_WEAK_HASH, 8) == 0)
-    {
-      weak_hash_found = 1;
+    group->table      = table;
+    group->table_size = table_size;
+  }
 
-      pot_right_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+  u64 pos = bloom_hash ((const u8 *) pw_buf, pw_len) & (group->table_size - 1);
 
-      // in theory this is not needed, but we are paranoia:
+  while (group->table[pos])
+  {
+    const u64 idx = group->table[pos] - 1;
 
-      memset (pot_right_ptr->plain_buf, 0, sizeof (pot_right_ptr->plain_buf));
-      pot_right_ptr->plain_len = 0;
-    }
+    if (memcmp (group->buf + (idx * pw_len), pw_buf, pw_len) == 0) return 0;
+
+    pos = (pos + 1) & (group->table_size - 1);
   }
 
-  if ((pot_left_ptr == NULL) && (pot_right_ptr == NULL))
+  if (((group->cnt + 1) * pw_len) > group->avail)
   {
-    if (weak_hash_found == 1) myfree (pot_right_ptr); // this shouldn't happen at all: if weak_hash_found == 1, than pot_right_ptr is not NULL for sure
+    const u64 add = (group->avail) ? group->avail : (u64) pw_len * 1024;
 
-    return;
+    group->buf = (char *) myrealloc (group->buf, group->avail, add);
+
+    group->avail += add;
   }
 
-  // at least one half was found:
+  memcpy (group->buf + (group->cnt * pw_len), pw_buf, pw_len);
 
-  log_info_nn ("");
+  group->cnt++;
 
-  input_buf[input_len] = 0;
+  group->table[pos] = (u32) group->cnt;
 
-  // user
+  return 1;
+}
 
-  unsigned char *username = NULL;
-  uint user_len = 0;
+int wl_compile (const char *outfile, char **infiles, const int infiles_cnt, char *rule_buf, const int rule_len, const uint hex_wordlist)
+{
+  const int rule_engine = (rule_len > 1) || ((rule_len == 1) && (rule_buf[0] != RULE_OP_MANGLE_NOOP));
 
-  if (data.username)
+  wl_compile_group_t *groups = (wl_compile_group_t *) mycalloc (PW_MAX1, sizeof (wl_compile_group_t));
+
+  char *line_buf = (char *) mymalloc (HCBUFSIZ);
+
+  u64 words_read     = 0;
+  u64 words_rejected = 0;
+  u64 words_dupes    = 0;
+
+  int rc = 0;
+
+  for (int i = 0; i < infiles_cnt; i++)
   {
-    user_t *user = hash_left->hash_info->user;
+    FILE *fp = fopen (infiles[i], "rb");
 
-    if (user)
+    if (fp == NULL)
     {
-      username = (unsigned char *) (user->user_name);
+      log_error ("ERROR: %s: %s", infiles[i], strerror (errno));
 
-      user_len = user->user_len;
+      rc = -1;
+
+      break;
     }
-  }
 
-  // mask the part which was not found
+    wl_compiled_t wlc;
 
-  uint left_part_masked  = 0;
-  uint right_part_masked = 0;
+    const int rc_compiled = wl_compiled_open (&wlc, fp, 0, PW_MAX);
 
-  uint mask_plain_len = strlen (LM_MASKED_PLAIN);
+    if (rc_compiled == -1)
+    {
+      fclose (fp);
 
-  if (pot_left_ptr == NULL)
-  {
-    left_part_masked = 1;
+      rc = -1;
 
-    pot_left_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+      break;
+    }
 
-    memset (pot_left_ptr->plain_buf, 0, sizeof (pot_left_ptr->plain_buf));
+    if (rc_compiled == 1)
+    {
+      // merging compiled wordlists, their words went through the rule and filters already
 
-    memcpy (pot_left_ptr->plain_buf, LM_MASKED_PLAIN, mask_plain_len);
-    pot_left_ptr->plain_len = mask_plain_len;
-  }
+      char *pw_buf;
+      uint  pw_len;
 
-  if (pot_right_ptr == NULL)
-  {
-    right_part_masked = 1;
+      while (wl_compiled_next (&wlc, &pw_buf, &pw_len) == 0)
+      {
+        words_read++;
 
-    pot_right_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+        if (wl_compile_add (&groups[pw_len], pw_buf, pw_len) == 0) words_dupes++;
+      }
 
-    memset (pot_right_ptr->plain_buf, 0, sizeof (pot_right_ptr->plain_buf));
+      wl_compiled_close (&wlc);
 
-    memcpy (pot_right_ptr->plain_buf, LM_MASKED_PLAIN, mask_plain_len);
-    pot_right_ptr->plain_len = mask_plain_len;
-  }
+      fclose (fp);
 
-  // create the pot_ptr out of pot_left_ptr and pot_right_ptr
+      continue;
+    }
 
-  pot_t pot_ptr;
+    while (!feof (fp))
+    {
+      int line_len = fgetl (fp, line_buf);
 
-  pot_ptr.plain_len = pot_left_ptr->plain_len + pot_right_ptr->plain_len;
+      if ((line_len == 0) && feof (fp)) break;
 
-  memcpy (pot_ptr.plain_buf, pot_left_ptr->plain_buf, pot_left_ptr->plain_len);
+      words_read++;
 
-  memcpy (pot_ptr.plain_buf + pot_left_ptr->plain_len, pot_right_ptr->plain_buf, pot_right_ptr->plain_len);
+      line_len = convert_from_hex (line_buf, line_len, hex_wordlist);
 
-  // do output the line
+      char *pw_buf = line_buf;
 
-  format_output (out_fp, input_buf, (unsigned char *) pot_ptr.plain_buf, pot_ptr.plain_len, 0, username, user_len);
+      char rule_buf_out[BLOCK_SIZE] = { 0 };
 
-  if (weak_hash_found == 1) myfree (pot_right_ptr);
+      if (rule_engine)
+      {
+        int rule_len_out = -1;
 
-  if (left_part_masked  == 1) myfree (pot_left_ptr);
-  if (right_part_masked == 1) myfree (pot_right_ptr);
-}
+        if (line_len < BLOCK_SIZE)
+        {
+          rule_len_out = _old_apply_rule (rule_buf, rule_len, line_buf, line_len, rule_buf_out);
+        }
 
-void handle_left_request (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hashes_buf, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
-{
-  pot_t pot_key;
+        if (rule_len_out < 0)
+        {
+          words_rejected++;
 
-  memcpy (&pot_key.hash, hashes_buf, sizeof (hash_t));
+          continue;
+        }
 
-  pot_t *pot_ptr = (pot_t *) bsearch (&pot_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+        pw_buf   = rule_buf_out;
+        line_len = rule_len_out;
+      }
 
-  if (pot_ptr == NULL)
-  {
-    log_info_nn ("");
+      if (line_len > PW_MAX)
+      {
+        words_rejected++;
 
-    input_buf[input_len] = 0;
+        continue;
+      }
 
-    format_output (out_fp, input_buf, NULL, 0, 0, NULL, 0);
+      if (wl_compile_add (&groups[line_len], pw_buf, line_len) == 0) words_dupes++;
+    }
+
+    fclose (fp);
   }
-}
 
-void handle_left_request_lm (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hash_left, hash_t *hash_right, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
-{
-  // left
+  myfree (line_buf);
 
-  pot_t pot_left_key;
+  wl_compiled_header_t header;
 
-  memcpy (&pot_left_key.hash, hash_left, sizeof (hash_t));
+  memset (&header, 0, sizeof (wl_compiled_header_t));
 
-  pot_t *pot_left_ptr = (pot_t *) bsearch (&pot_left_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+  header.magic   = WL_COMPILED_MAGIC;
+  header.version = WL_COMPILED_VERSION;
+  header.pw_max  = PW_MAX;
 
-  // right
+  for (uint pw_len = 0; pw_len <= PW_MAX; pw_len++)
+  {
+    header.len_cnt[pw_len] = groups[pw_len].cnt;
 
-  pot_t pot_right_key;
+    header.words_cnt += groups[pw_len].cnt;
+  }
 
-  memcpy (&pot_right_key.hash, hash_right, sizeof (hash_t));
+  if (rc == 0)
+  {
+    FILE *fp = fopen (outfile, "wb");
 
-  pot_t *pot_right_ptr = (pot_t *) bsearch (&pot_right_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+    if (fp == NULL)
+    {
+      log_error ("ERROR: %s: %s", outfile, strerror (errno));
 
-  uint weak_hash_found = 0;
+      rc = -1;
+    }
+    else
+    {
+      size_t nwritten = fwrite (&header, sizeof (wl_compiled_header_t), 1, fp);
 
-  if (pot_right_ptr == NULL)
-  {
-    // special case, if "weak hash"
+      for (uint pw_len = 1; pw_len <= PW_MAX; pw_len++)
+      {
+        if (groups[pw_len].cnt == 0) continue;
 
-    if (memcmp (hash_right->digest, LM_WEAK_HASH, 8) == 0)
-    {
-      weak_hash_found = 1;
+        nwritten += fwrite (groups[pw_len].buf, pw_len, groups[pw_len].cnt, fp);
+      }
 
-      // we just need that pot_right_ptr is not a NULL pointer
+      if ((fclose (fp) != 0) || (nwritten != (1 + header.words_cnt - header.len_cnt[0])))
+      {
+        log_error ("ERROR: %s: %s", outfile, strerror (errno));
 
-      pot_right_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+        rc = -1;
+      }
     }
   }
 
-  if ((pot_left_ptr != NULL) && (pot_right_ptr != NULL))
+  for (uint pw_len = 0; pw_len <= PW_MAX; pw_len++)
   {
-    if (weak_hash_found == 1) myfree (pot_right_ptr);
-
-    return;
+    myfree (groups[pw_len].buf);
+    myfree (groups[pw_len].table);
   }
 
-  // ... at least one part was not cracked
-
-  log_info_nn ("");
+  myfree (groups);
 
-  input_buf[input_len] = 0;
+  if (rc == -1) return -1;
 
-  // only show the hash part which is still not cracked
+  if (data.quiet == 0) log_info ("Compiled %s: %llu words read, %llu rejected, %llu duplicates, %llu words written", outfile, (unsigned long long int) words_read, (unsigned long long int) words_rejected, (unsigned long long int) words_dupes, (unsigned long long int) header.words_cnt);
 
-  uint user_len = input_len - 32;
+  return 0;
+}
 
-  char *hash_output = (char *) mymalloc (33);
+int wl_compiled_open (wl_compiled_t *wlc, FILE *fp, const uint len_min, const uint len_max)
+{
+  // returns 0 and rewinds fp for plain wordlists
 
-  memcpy (hash_output, input_buf, input_len);
+  memset (wlc, 0, sizeof (wl_compiled_t));
 
-  if (pot_left_ptr != NULL)
+  if (fread (&wlc->header, sizeof (wl_compiled_header_t), 1, fp) != 1 || (wlc->header.magic != WL_COMPILED_MAGIC))
   {
-    // only show right part (because left part was already found)
-
-    memcpy (hash_output + user_len, input_buf + user_len + 16, 16);
+    rewind (fp);
 
-    hash_output[user_len + 16] = 0;
+    return 0;
   }
 
-  if (pot_right_ptr != NULL)
+  if ((wlc->header.version != WL_COMPILED_VERSION) || (wlc->header.pw_max != PW_MAX))
   {
-    // only show left part (because right part was already found)
-
-    memcpy (hash_output + user_len, input_buf + user_len, 16);
+    log_error ("ERROR: Compiled wordlist was built by an incompatible version, please recompile it");
 
-    hash_output[user_len + 16] = 0;
+    return -1;
   }
 
-  format_output (out_fp, hash_output, NULL, 0, 0, NULL, 0);
+  u64 offset = sizeof (wl_compiled_header_t);
 
-  myfree (hash_output);
-
-  if (weak_hash_found == 1) myfree (pot_right_ptr);
-}
-
-uint setup_opencl_platforms_filter (char *opencl_platforms)
-{
-  uint opencl_platforms_filter = 0;
-
-  if (opencl_platforms)
+  for (uint pw_len = 0; pw_len <= PW_MAX; pw_len++)
   {
-    char *platforms = strdup (opencl_platforms);
+    wlc->len_off[pw_len] = offset;
 
-    char *next = strtok (platforms, ",");
+    offset += wlc->header.len_cnt[pw_len] * pw_len;
+  }
 
-    do
-    {
-      int platform = atoi (next);
+  #ifdef _POSIX
+  struct stat st;
 
-      if (platform < 1 || platform > 32)
-      {
-        log_error ("ERROR: Invalid OpenCL platform %u specified", platform);
+  fstat (fileno (fp), &st);
+  #endif
 
-        exit (-1);
-      }
+  #ifdef _WIN
+  struct __stat64 st;
 
-      opencl_platforms_filter |= 1u << (platform - 1);
+  _fstat64 (fileno (fp), &st);
+  #endif
 
-    } while ((next = strtok (NULL, ",")) != NULL);
+  if ((u64) st.st_size != offset)
+  {
+    log_error ("ERROR: Compiled wordlist is truncated, please recompile it");
 
-    free (platforms);
+    return -1;
   }
-  else
+
+  wlc->fp      = fp;
+  wlc->len_min = len_min;
+  wlc->len_max = MIN (len_max, PW_MAX);
+
+  for (uint pw_len = wlc->len_min; pw_len <= wlc->len_max; pw_len++)
   {
-    opencl_platforms_filter = -1;
+    wlc->words_cnt += wlc->header.len_cnt[pw_len];
   }
 
-  return opencl_platforms_filter;
+  wlc->buf = (char *) mymalloc (WL_COMPILED_BUFSIZ);
+
+  wl_compiled_seek (wlc, 0);
+
+  return 1;
 }
 
-u32 setup_devices_filter (char *opencl_devices)
+void wl_compiled_seek (wl_compiled_t *wlc, u64 word_pos)
 {
-  u32 devices_filter = 0;
+  // word_pos counts the words inside the length range only, which makes restore points O(1) to reach
 
-  if (opencl_devices)
-  {
-    char *devices = strdup (opencl_devices);
+  uint pw_len;
 
-    char *next = strtok (devices, ",");
+  for (pw_len = wlc->len_min; pw_len <= wlc->len_max; pw_len++)
+  {
+    if (word_pos < wlc->header.len_cnt[pw_len]) break;
 
-    do
-    {
-      int device_id = atoi (next);
+    word_pos -= wlc->header.len_cnt[pw_len];
+  }
 
-      if (device_id < 1 || device_id > 32)
-      {
-        log_error ("ERROR: Invalid device_id %u specified", device_id);
+  wlc->buf_pos = 0;
+  wlc->buf_cnt = 0;
 
-        exit (-1);
-      }
+  if (pw_len > wlc->len_max)
+  {
+    wlc->len_cur  = wlc->len_max;
+    wlc->len_left = 0;
 
-      devices_filter |= 1u << (device_id - 1);
+    return;
+  }
 
-    } while ((next = strtok (NULL, ",")) != NULL);
+  wlc->len_cur  = pw_len;
+  wlc->len_left = wlc->header.len_cnt[pw_len] - word_pos;
 
-    free (devices);
-  }
-  else
-  {
-    devices_filter = -1;
-  }
+  const u64 offset = wlc->len_off[pw_len] + (word_pos * pw_len);
 
-  return devices_filter;
+  #ifdef _WIN
+  _fseeki64 (wlc->fp, offset, SEEK_SET);
+  #else
+  fseeko (wlc->fp, offset, SEEK_SET);
+  #endif
 }
 
-cl_device_type setup_device_types_filter (char *opencl_device_types)
+int wl_compiled_next (wl_compiled_t *wlc, char **out_buf, uint *out_len)
 {
-  cl_device_type device_types_filter = 0;
+  // the groups are stored back to back, so moving on to the next length never needs a seek
 
-  if (opencl_device_types)
+  while (wlc->len_left == 0)
   {
-    char *device_types = strdup (opencl_device_types);
+    if (wlc->len_cur >= wlc->len_max) return -1;
 
-    char *next = strtok (device_types, ",");
+    wlc->len_cur++;
 
-    do
-    {
-      int device_type = atoi (next);
+    wlc->len_left = wlc->header.len_cnt[wlc->len_cur];
+  }
 
-      if (device_type < 1 || device_type > 3)
-      {
-        log_error ("ERROR: Invalid device_type %u specified", device_type);
+  const uint pw_len = wlc->len_cur;
 
-        exit (-1);
-      }
+  if (pw_len > 0)
+  {
+    if (wlc->buf_pos == wlc->buf_cnt)
+    {
+      const u64 records = MIN (wlc->len_left, WL_COMPILED_BUFSIZ / pw_len);
 
-      device_types_filter |= 1u << device_type;
+      wlc->buf_cnt = fread (wlc->buf, pw_len, records, wlc->fp) * pw_len;
+      wlc->buf_pos = 0;
 
-    } while ((next = strtok (NULL, ",")) != NULL);
+      if (wlc->buf_cnt == 0) return -1;
+    }
 
-    free (device_types);
+    *out_buf = wlc->buf + wlc->buf_pos;
+
+    wlc->buf_pos += pw_len;
   }
   else
   {
-    // Do not use CPU by default, this often reduces GPU performance because
-    // the CPU is too busy to handle GPU synchronization
-
-    device_types_filter = CL_DEVICE_TYPE_ALL & ~CL_DEVICE_TYPE_CPU;
+    *out_buf = wlc->buf;
   }
 
-  return device_types_filter;
+  *out_len = pw_len;
+
+  wlc->len_left--;
+
+  return 0;
 }
 
-u32 get_random_num (const u32 min, const u32 max)
+void wl_compiled_close (wl_compiled_t *wlc)
 {
-  if (min == max) return (min);
+  myfree (wlc->buf);
 
-  return ((rand () % (max - min)) + min);
+  wlc->buf = NULL;
 }
 
-u32 mydivc32 (const u32 dividend, const u32 divisor)
+void *rulefind (const void *key, void *base, int nmemb, size_t size, int (*compar) (const void *, const void *))
 {
-  u32 quotient = dividend / divisor;
+  char *element, *end;
 
-  if (dividend % divisor) quotient++;
+  end = (char *) base + nmemb * size;
 
-  return quotient;
+  for (element = (char *) base; element < end; element += size)
+    if (!compar (element, key))
+      return element;
+
+  return NULL;
 }
 
-u64 mydivc64 (const u64 dividend, const u64 divisor)
+int sort_by_u32 (const void *v1, const void *v2)
 {
-  u64 quotient = dividend / divisor;
-
-  if (dividend % divisor) quotient++;
+  const u32 *s1 = (const u32 *) v1;
+  const u32 *s2 = (const u32 *) v2;
 
-  return quotient;
+  return *s1 - *s2;
 }
 
-void format_timer_display (struct tm *tm, char *buf, size_t len)
+int sort_by_salt (const void *v1, const void *v2)
 {
-  const char *time_entities_s[] = { "year",  "day",  "hour",  "min",  "sec"  };
-  const char *time_entities_m[] = { "years", "days", "hours", "mins", "secs" };
+  const salt_t *s1 = (const salt_t *) v1;
+  const salt_t *s2 = (const salt_t *) v2;
 
-  if (tm->tm_year - 70)
-  {
-    char *time_entity1 = ((tm->tm_year - 70) == 1) ? (char *) time_entities_s[0] : (char *) time_entities_m[0];
-    char *time_entity2 = ( tm->tm_yday       == 1) ? (char *) time_entities_s[1] : (char *) time_entities_m[1];
+  const int res1 = s1->salt_len - s2->salt_len;
 
-    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_year - 70, time_entity1, tm->tm_yday, time_entity2);
-  }
-  else if (tm->tm_yday)
-  {
-    char *time_entity1 = (tm->tm_yday == 1) ? (char *) time_entities_s[1] : (char *) time_entities_m[1];
-    char *time_entity2 = (tm->tm_hour == 1) ? (char *) time_entities_s[2] : (char *) time_entities_m[2];
+  if (res1 != 0) return (res1);
 
-    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_yday, time_entity1, tm->tm_hour, time_entity2);
-  }
-  else if (tm->tm_hour)
-  {
-    char *time_entity1 = (tm->tm_hour == 1) ? (char *) time_entities_s[2] : (char *) time_entities_m[2];
-    char *time_entity2 = (tm->tm_min  == 1) ? (char *) time_entities_s[3] : (char *) time_entities_m[3];
+  const int res2 = s1->salt_iter - s2->salt_iter;
 
-    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_hour, time_entity1, tm->tm_min, time_entity2);
-  }
-  else if (tm->tm_min)
-  {
-    char *time_entity1 = (tm->tm_min == 1) ? (char *) time_entities_s[3] : (char *) time_entities_m[3];
-    char *time_entity2 = (tm->tm_sec == 1) ? (char *) time_entities_s[4] : (char *) time_entities_m[4];
+  if (res2 != 0) return (res2);
 
-    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_min, time_entity1, tm->tm_sec, time_entity2);
-  }
-  else
-  {
-    char *time_entity1 = (tm->tm_sec == 1) ? (char *) time_entities_s[4] : (char *) time_entities_m[4];
+  uint n;
 
-    snprintf (buf, len - 1, "%d %s", tm->tm_sec, time_entity1);
-  }
-}
+  n = 16;
 
-void format_speed_display (float val, char *buf, size_t len)
-{
-  if (val <= 0)
+  while (n--)
   {
-    buf[0] = '0';
-    buf[1] = ' ';
-    buf[2] = 0;
-
-    return;
+    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
+    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
   }
 
-  char units[7] = { ' ', 'k', 'M', 'G', 'T', 'P', 'E' };
-
-  uint level = 0;
+  n = 8;
 
-  while (val > 99999)
+  while (n--)
   {
-    val /= 1000;
-
-    level++;
+    if (s1->salt_buf_pc[n] > s2->salt_buf_pc[n]) return ( 1);
+    if (s1->salt_buf_pc[n] < s2->salt_buf_pc[n]) return -1;
   }
 
-  /* generate output */
-
-  if (level == 0)
-  {
-    snprintf (buf, len - 1, "%.0f ", val);
-  }
-  else
-  {
-    snprintf (buf, len - 1, "%.1f %c", val, units[level]);
-  }
+  return 0;
 }
 
-void lowercase (u8 *buf, int len)
+int sort_by_salt_buf (const void *v1, const void *v2)
 {
-  for (int i = 0; i < len; i++) buf[i] = tolower (buf[i]);
-}
+  const pot_t *p1 = (const pot_t *) v1;
+  const pot_t *p2 = (const pot_t *) v2;
 
-void uppercase (u8 *buf, int len)
-{
-  for (int i = 0; i < len; i++) buf[i] = toupper (buf[i]);
-}
+  const hash_t *h1 = &p1->hash;
+  const hash_t *h2 = &p2->hash;
 
-int fgetl (FILE *fp, char *line_buf)
-{
-  int line_len = 0;
+  const salt_t *s1 = h1->salt;
+  const salt_t *s2 = h2->salt;
 
-  while (!feof (fp))
+  uint n = 16;
+
+  while (n--)
   {
-    const int c = fgetc (fp);
+    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
+    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
+  }
 
-    if (c == EOF) break;
+  return 0;
+}
 
-    line_buf[line_len] = (char) c;
+int sort_by_hash_t_salt (const void *v1, const void *v2)
+{
+  const hash_t *h1 = (const hash_t *) v1;
+  const hash_t *h2 = (const hash_t *) v2;
 
-    line_len++;
+  const salt_t *s1 = h1->salt;
+  const salt_t *s2 = h2->salt;
 
-    if (line_len == HCBUFSIZ) line_len--;
+  // testphase: this should work
+  uint n = 16;
 
-    if (c == '\n') break;
+  while (n--)
+  {
+    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
+    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
   }
 
-  if (line_len == 0) return 0;
+  /* original code, seems buggy since salt_len can be very big (had a case with 131 len)
+     also it thinks salt_buf[x] is a char but its a uint so salt_len should be / 4
+  if (s1->salt_len > s2->salt_len) return ( 1);
+  if (s1->salt_len < s2->salt_len) return -1;
 
-  if (line_buf[line_len - 1] == '\n')
-  {
-    line_len--;
+  uint n = s1->salt_len;
 
-    line_buf[line_len] = 0;
+  while (n--)
+  {
+    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
+    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
   }
+  */
 
-  if (line_len == 0) return 0;
+  return 0;
+}
 
-  if (line_buf[line_len - 1] == '\r')
-  {
-    line_len--;
+int sort_by_hash_t_salt_hccap (const void *v1, const void *v2)
+{
+  const hash_t *h1 = (const hash_t *) v1;
+  const hash_t *h2 = (const hash_t *) v2;
 
-    line_buf[line_len] = 0;
-  }
+  const salt_t *s1 = h1->salt;
+  const salt_t *s2 = h2->salt;
 
-  return (line_len);
-}
+  // last 2: salt_buf[10] and salt_buf[11] contain the digest (skip them)
 
-int in_superchop (char *buf)
-{
-  int len = strlen (buf);
+  uint n = 9; // 9 * 4 = 36 bytes (max length of ESSID)
 
-  while (len)
+  while (n--)
   {
-    if (buf[len - 1] == '\n')
-    {
-      len--;
+    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
+    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
+  }
 
-      continue;
-    }
+  return 0;
+}
 
-    if (buf[len - 1] == '\r')
-    {
-      len--;
+int sort_by_salt_essid (const void *v1, const void *v2)
+{
+  const uint p1 = *((const uint *) v1);
+  const uint p2 = *((const uint *) v2);
 
-      continue;
-    }
+  const salt_t *s1 = &data.salts_buf[p1];
+  const salt_t *s2 = &data.salts_buf[p2];
 
-    break;
+  if (s1->salt_len > s2->salt_len) return ( 1);
+  if (s1->salt_len < s2->salt_len) return -1;
+
+  for (uint n = 0; n < 9; n++) // 9 * 4 = 36 bytes (max length of ESSID)
+  {
+    if (s1->salt_buf[n] > s2->salt_buf[n]) return ( 1);
+    if (s1->salt_buf[n] < s2->salt_buf[n]) return -1;
   }
 
-  buf[len] = 0;
+  // keep the original salt order within one ESSID
 
-  return len;
+  if (p1 > p2) return ( 1);
+  if (p1 < p2) return -1;
+
+  return 0;
 }
 
-char **scan_directory (const char *path)
+int sort_by_salt_iter (const void *v1, const void *v2)
 {
-  char *tmp_path = mystrdup (path);
+  const uint p1 = *((const uint *) v1);
+  const uint p2 = *((const uint *) v2);
 
-  size_t tmp_path_len = strlen (tmp_path);
+  const salt_t *s1 = &data.salts_buf[p1];
+  const salt_t *s2 = &data.salts_buf[p2];
 
-  while (tmp_path[tmp_path_len - 1] == '/' || tmp_path[tmp_path_len - 1] == '\\')
-  {
-    tmp_path[tmp_path_len - 1] = 0;
+  // digests left / (salt_iter + 1) compared without a division
 
-    tmp_path_len = strlen (tmp_path);
-  }
+  const u64 w1 = (u64) (s1->digests_cnt - s1->digests_done) * ((u64) s2->salt_iter + 1);
+  const u64 w2 = (u64) (s2->digests_cnt - s2->digests_done) * ((u64) s1->salt_iter + 1);
 
-  char **files = NULL;
+  if (w1 < w2) return ( 1);
+  if (w1 > w2) return -1;
 
-  int num_files = 0;
+  // same iteration count next to each other, then the original salt order
 
-  DIR *d = NULL;
+  if (s1->salt_iter > s2->salt_iter) return ( 1);
+  if (s1->salt_iter < s2->salt_iter) return -1;
 
-  if ((d = opendir (tmp_path)) != NULL)
-  {
-    #ifdef __APPLE__
+  if (p1 > p2) return ( 1);
+  if (p1 < p2) return -1;
 
-    struct dirent e;
+  return 0;
+}
 
-    for (;;)
-    {
-      memset (&e, 0, sizeof (e));
+int sort_by_hash_no_salt (const void *v1, const void *v2)
+{
+  const hash_t *h1 = (const hash_t *) v1;
+  const hash_t *h2 = (const hash_t *) v2;
 
-      struct dirent *de = NULL;
+  const void *d1 = h1->digest;
+  const void *d2 = h2->digest;
 
-      if (readdir_r (d, &e, &de) != 0)
-      {
-        log_error ("ERROR: readdir_r() failed");
+  return data.sort_by_digest (d1, d2);
+}
 
-        break;
-      }
+int sort_by_hash (const void *v1, const void *v2)
+{
+  const hash_t *h1 = (const hash_t *) v1;
+  const hash_t *h2 = (const hash_t *) v2;
 
-      if (de == NULL) break;
+  if (data.isSalted)
+  {
+    const salt_t *s1 = h1->salt;
+    const salt_t *s2 = h2->salt;
 
-    #else
+    int res = sort_by_salt (s1, s2);
 
-    struct dirent *de;
+    if (res != 0) return (res);
+  }
 
-    while ((de = readdir (d)) != NULL)
-    {
+  const void *d1 = h1->digest;
+  const void *d2 = h2->digest;
 
-    #endif
+  return data.sort_by_digest (d1, d2);
+}
 
-      if ((strcmp (de->d_name, ".") == 0) || (strcmp (de->d_name, "..") == 0)) continue;
+int sort_by_pot (const void *v1, const void *v2)
+{
+  const pot_t *p1 = (const pot_t *) v1;
+  const pot_t *p2 = (const pot_t *) v2;
 
-      int path_size = strlen (tmp_path) + 1 + strlen (de->d_name);
+  const hash_t *h1 = &p1->hash;
+  const hash_t *h2 = &p2->hash;
 
-      char *path_file = (char *) mymalloc (path_size + 1);
+  return sort_by_hash (h1, h2);
+}
 
-      snprintf (path_file, path_size + 1, "%s/%s", tmp_path, de->d_name);
+int sort_by_mtime (const void *p1, const void *p2)
+{
+  const char **f1 = (const char **) p1;
+  const char **f2 = (const char **) p2;
 
-      path_file[path_size] = 0;
+  struct stat s1; stat (*f1, &s1);
+  struct stat s2; stat (*f2, &s2);
 
-      DIR *d_test;
+  return s2.st_mtime - s1.st_mtime;
+}
 
-      if ((d_test = opendir (path_file)) != NULL)
-      {
-        closedir (d_test);
+int sort_by_cpu_rule (const void *p1, const void *p2)
+{
+  const cpu_rule_t *r1 = (const cpu_rule_t *) p1;
+  const cpu_rule_t *r2 = (const cpu_rule_t *) p2;
 
-        myfree (path_file);
-      }
-      else
-      {
-        files = (char **) myrealloc (files, num_files * sizeof (char *), sizeof (char *));
+  return memcmp (r1, r2, sizeof (cpu_rule_t));
+}
 
-        num_files++;
+int sort_by_kernel_rule (const void *p1, const void *p2)
+{
+  const kernel_rule_t *r1 = (const kernel_rule_t *) p1;
+  const kernel_rule_t *r2 = (const kernel_rule_t *) p2;
 
-        files[num_files - 1] = path_file;
-      }
-    }
+  return memcmp (r1, r2, sizeof (kernel_rule_t));
+}
 
-    closedir (d);
-  }
-  else if (errno == ENOTDIR)
-  {
-    files = (char **) myrealloc (files, num_files * sizeof (char *), sizeof (char *));
+int sort_by_stringptr (const void *p1, const void *p2)
+{
+  const char **s1 = (const char **) p1;
+  const char **s2 = (const char **) p2;
 
-    num_files++;
+  return strcmp (*s1, *s2);
+}
 
-    files[num_files - 1] = mystrdup (path);
-  }
+int sort_by_dictstat (const void *s1, const void *s2)
+{
+  dictstat_t *d1 = (dictstat_t *) s1;
+  dictstat_t *d2 = (dictstat_t *) s2;
 
-  files = (char **) myrealloc (files, num_files * sizeof (char *), sizeof (char *));
+  #ifdef __linux__
+  d2->stat.st_atim = d1->stat.st_atim;
+  #else
+  d2->stat.st_atime = d1->stat.st_atime;
+  #endif
 
-  num_files++;
+  return memcmp (&d1->stat, &d2->stat, sizeof (struct stat));
+}
 
-  files[num_files - 1] = NULL;
+int sort_by_bitmap (const void *p1, const void *p2)
+{
+  const bitmap_result_t *b1 = (const bitmap_result_t *) p1;
+  const bitmap_result_t *b2 = (const bitmap_result_t *) p2;
 
-  myfree (tmp_path);
+  return b1->collisions - b2->collisions;
+}
 
-  return (files);
+int sort_by_digest_4_2 (const void *v1, const void *v2)
+{
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  uint n = 2;
+
+  while (n--)
+  {
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
+  }
+
+  return 0;
 }
 
-int count_dictionaries (char **dictionary_files)
+int sort_by_digest_4_4 (const void *v1, const void *v2)
 {
-  if (dictionary_files == NULL) return 0;
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
 
-  int cnt = 0;
+  uint n = 4;
 
-  for (int d = 0; dictionary_files[d] != NULL; d++)
+  while (n--)
   {
-    cnt++;
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
   }
 
-  return (cnt);
+  return 0;
 }
 
-char *stroptitype (const uint opti_type)
+int sort_by_digest_4_5 (const void *v1, const void *v2)
 {
-  switch (opti_type)
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  uint n = 5;
+
+  while (n--)
   {
-    case OPTI_TYPE_ZERO_BYTE:         return ((char *) OPTI_STR_ZERO_BYTE);         break;
-    case OPTI_TYPE_PRECOMPUTE_INIT:   return ((char *) OPTI_STR_PRECOMPUTE_INIT);   break;
-    case OPTI_TYPE_PRECOMPUTE_MERKLE: return ((char *) OPTI_STR_PRECOMPUTE_MERKLE); break;
-    case OPTI_TYPE_PRECOMPUTE_PERMUT: return ((char *) OPTI_STR_PRECOMPUTE_PERMUT); break;
-    case OPTI_TYPE_MEET_IN_MIDDLE:    return ((char *) OPTI_STR_MEET_IN_MIDDLE);    break;
-    case OPTI_TYPE_EARLY_SKIP:        return ((char *) OPTI_STR_EARLY_SKIP);        break;
-    case OPTI_TYPE_NOT_SALTED:        return ((char *) OPTI_STR_NOT_SALTED);        break;
-    case OPTI_TYPE_NOT_ITERATED:      return ((char *) OPTI_STR_NOT_ITERATED);      break;
-    case OPTI_TYPE_PREPENDED_SALT:    return ((char *) OPTI_STR_PREPENDED_SALT);    break;
-    case OPTI_TYPE_APPENDED_SALT:     return ((char *) OPTI_STR_APPENDED_SALT);     break;
-    case OPTI_TYPE_SINGLE_HASH:       return ((char *) OPTI_STR_SINGLE_HASH);       break;
-    case OPTI_TYPE_SINGLE_SALT:       return ((char *) OPTI_STR_SINGLE_SALT);       break;
-    case OPTI_TYPE_BRUTE_FORCE:       return ((char *) OPTI_STR_BRUTE_FORCE);       break;
-    case OPTI_TYPE_RAW_HASH:          return ((char *) OPTI_STR_RAW_HASH);          break;
-    case OPTI_TYPE_SLOW_HASH_SIMD:    return ((char *) OPTI_STR_SLOW_HASH_SIMD);    break;
-    case OPTI_TYPE_USES_BITS_8:       return ((char *) OPTI_STR_USES_BITS_8);       break;
-    case OPTI_TYPE_USES_BITS_16:      return ((char *) OPTI_STR_USES_BITS_16);      break;
-    case OPTI_TYPE_USES_BITS_32:      return ((char *) OPTI_STR_USES_BITS_32);      break;
-    case OPTI_TYPE_USES_BITS_64:      return ((char *) OPTI_STR_USES_BITS_64);      break;
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
   }
 
-  return (NULL);
+  return 0;
 }
 
-char *strparser (const uint parser_status)
+int sort_by_digest_4_6 (const void *v1, const void *v2)
 {
-  switch (parser_status)
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  uint n = 6;
+
+  while (n--)
   {
-    case PARSER_OK:                   return ((char *) PA_000); break;
-    case PARSER_COMMENT:              return ((char *) PA_001); break;
-    case PARSER_GLOBAL_ZERO:          return ((char *) PA_002); break;
-    case PARSER_GLOBAL_LENGTH:        return ((char *) PA_003); break;
-    case PARSER_HASH_LENGTH:          return ((char *) PA_004); break;
-    case PARSER_HASH_VALUE:           return ((char *) PA_005); break;
-    case PARSER_SALT_LENGTH:          return ((char *) PA_006); break;
-    case PARSER_SALT_VALUE:           return ((char *) PA_007); break;
-    case PARSER_SALT_ITERATION:       return ((char *) PA_008); break;
-    case PARSER_SEPARATOR_UNMATCHED:  return ((char *) PA_009); break;
-    case PARSER_SIGNATURE_UNMATCHED:  return ((char *) PA_010); break;
-    case PARSER_HCCAP_FILE_SIZE:      return ((char *) PA_011); break;
-    case PARSER_HCCAP_EAPOL_SIZE:     return ((char *) PA_012); break;
-    case PARSER_PSAFE2_FILE_SIZE:     return ((char *) PA_013); break;
-    case PARSER_PSAFE3_FILE_SIZE:     return ((char *) PA_014); break;
-    case PARSER_TC_FILE_SIZE:         return ((char *) PA_015); break;
-    case PARSER_SIP_AUTH_DIRECTIVE:   return ((char *) PA_016); break;
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
   }
 
-  return ((char *) PA_255);
+  return 0;
 }
 
-char *strhashtype (const uint hash_mode)
+int sort_by_digest_4_8 (const void *v1, const void *v2)
 {
-  switch (hash_mode)
-  {
-    case     0: return ((char *) HT_00000); break;
-    case    10: return ((char *) HT_00010); break;
-    case    11: return ((char *) HT_00011); break;
-    case    12: return ((char *) HT_00012); break;
-    case    20: return ((char *) HT_00020); break;
-    case    21: return ((char *) HT_00021); break;
-    case    22: return ((char *) HT_00022); break;
-    case    23: return ((char *) HT_00023); break;
-    case    30: return ((char *) HT_00030); break;
-    case    40: return ((char *) HT_00040); break;
-    case    50: return ((char *) HT_00050); break;
-    case    60: return ((char *) HT_00060); break;
-    case   100: return ((char *) HT_00100); break;
-    case   101: return ((char *) HT_00101); break;
-    case   110: return ((char *) HT_00110); break;
-    case   111: return ((char *) HT_00111); break;
-    case   112: return ((char *) HT_00112); break;
-    case   120: return ((char *) HT_00120); break;
-    case   121: return ((char *) HT_00121); break;
-    case   122: return ((char *) HT_00122); break;
-    case   124: return ((char *) HT_00124); break;
-    case   125: return ((char *) HT_00125); break;
-    case   130: return ((char *) HT_00130); break;
-    case   131: return ((char *) HT_00131); break;
-    case   132: return ((char *) HT_00132); break;
-    case   133: return ((char *) HT_00133); break;
-    case   140: return ((char *) HT_00140); break;
-    case   141: return ((char *) HT_00141); break;
-    case   150: return ((char *) HT_00150); break;
-    case   160: return ((char *) HT_00160); break;
-    case   200: return ((char *) HT_00200); break;
-    case   300: return ((char *) HT_00300); break;
-    case   400: return ((char *) HT_00400); break;
-    case   500: return ((char *) HT_00500); break;
-    case   501: return ((char *) HT_00501); break;
-    case   900: return ((char *) HT_00900); break;
-    case   910: return ((char *) HT_00910); break;
-    case  1000: return ((char *) HT_01000); break;
-    case  1100: return ((char *) HT_01100); break;
-    case  1400: return ((char *) HT_01400); break;
-    case  1410: return ((char *) HT_01410); break;
-    case  1420: return ((char *) HT_01420); break;
-    case  1421: return ((char *) HT_01421); break;
-    case  1430: return ((char *) HT_01430); break;
-    case  1440: return ((char *) HT_01440); break;
-    case  1441: return ((char *) HT_01441); break;
-    case  1450: return ((char *) HT_01450); break;
-    case  1460: return ((char *) HT_01460); break;
-    case  1500: return ((char *) HT_01500); break;
-    case  1600: return ((char *) HT_01600); break;
-    case  1700: return ((char *) HT_01700); break;
-    case  1710: return ((char *) HT_01710); break;
-    case  1711: return ((char *) HT_01711); break;
-    case  1720: return ((char *) HT_01720); break;
-    case  1722: return ((char *) HT_01722); break;
-    case  1730: return ((char *) HT_01730); break;
-    case  1731: return ((char *) HT_01731); break;
-    case  1740: return ((char *) HT_01740); break;
-    case  1750: return ((char *) HT_01750); break;
-    case  1760: return ((char *) HT_01760); break;
-    case  1800: return ((char *) HT_01800); break;
-    case  2100: return ((char *) HT_02100); break;
-    case  2400: return ((char *) HT_02400); break;
-    case  2410: return ((char *) HT_02410); break;
-    case  2500: return ((char *) HT_02500); break;
-    case  2600: return ((char *) HT_02600); break;
-    case  2611: return ((char *) HT_02611); break;
-    case  2612: return ((char *) HT_02612); break;
-    case  2711: return ((char *) HT_02711); break;
-    case  2811: return ((char *) HT_02811); break;
-    case  3000: return ((char *) HT_03000); break;
-    case  3100: return ((char *) HT_03100); break;
-    case  3200: return ((char *) HT_03200); break;
-    case  3710: return ((char *) HT_03710); break;
-    case  3711: return ((char *) HT_03711); break;
-    case  3800: return ((char *) HT_03800); break;
-    case  4300: return ((char *) HT_04300); break;
-    case  4400: return ((char *) HT_04400); break;
-    case  4500: return ((char *) HT_04500); break;
-    case  4700: return ((char *) HT_04700); break;
-    case  4800: return ((char *) HT_04800); break;
-    case  4900: return ((char *) HT_04900); break;
-    case  5000: return ((char *) HT_05000); break;
-    case  5100: return ((char *) HT_05100); break;
-    case  5200: return ((char *) HT_05200); break;
-    case  5300: return ((char *) HT_05300); break;
-    case  5400: return ((char *) HT_05400); break;
-    case  5500: return ((char *) HT_05500); break;
-    case  5600: return ((char *) HT_05600); break;
-    case  5700: return ((char *) HT_05700); break;
-    case  5800: return ((char *) HT_05800); break;
-    case  6000: return ((char *) HT_06000); break;
-    case  6100: return ((char *) HT_06100); break;
-    case  6211: return ((char *) HT_06211); break;
-    case  6212: return ((char *) HT_06212); break;
-    case  6213: return ((char *) HT_06213); break;
-    case  6221: return ((char *) HT_06221); break;
-    case  6222: return ((char *) HT_06222); break;
-    case  6223: return ((char *) HT_06223); break;
-    case  6231: return ((char *) HT_06231); break;
-    case  6232: return ((char *) HT_06232); break;
-    case  6233: return ((char *) HT_06233); break;
-    case  6241: return ((char *) HT_06241); break;
-    case  6242: return ((char *) HT_06242); break;
-    case  6243: return ((char *) HT_06243); break;
-    case  6300: return ((char *) HT_06300); break;
-    case  6400: return ((char *) HT_06400); break;
-    case  6500: return ((char *) HT_06500); break;
-    case  6600: return ((char *) HT_06600); break;
-    case  6700: return ((char *) HT_06700); break;
-    case  6800: return ((char *) HT_06800); break;
-    case  6900: return ((char *) HT_06900); break;
-    case  7100: return ((char *) HT_07100); break;
-    case  7200: return ((char *) HT_07200); break;
-    case  7300: return ((char *) HT_07300); break;
-    case  7400: return ((char *) HT_07400); break;
-    case  7500: return ((char *) HT_07500); break;
-    case  7600: return ((char *) HT_07600); break;
-    case  7700: return ((char *) HT_07700); break;
-    case  7800: return ((char *) HT_07800); break;
-    case  7900: return ((char *) HT_07900); break;
-    case  8000: return ((char *) HT_08000); break;
-    case  8100: return ((char *) HT_08100); break;
-    case  8200: return ((char *) HT_08200); break;
-    case  8300: return ((char *) HT_08300); break;
-    case  8400: return ((char *) HT_08400); break;
-    case  8500: return ((char *) HT_08500); break;
-    case  8600: return ((char *) HT_08600); break;
-    case  8700: return ((char *) HT_08700); break;
-    case  8800: return ((char *) HT_08800); break;
-    case  8900: return ((char *) HT_08900); break;
-    case  9000: return ((char *) HT_09000); break;
-    case  9100: return ((char *) HT_09100); break;
-    case  9200: return ((char *) HT_09200); break;
-    case  9300: return ((char *) HT_09300); break;
-    case  9400: return ((char *) HT_09400); break;
-    case  9500: return ((char *) HT_09500); break;
-    case  9600: return ((char *) HT_09600); break;
-    case  9700: return ((char *) HT_09700); break;
-    case  9710: return ((char *) HT_09710); break;
-    case  9720: return ((char *) HT_09720); break;
-    case  9800: return ((char *) HT_09800); break;
-    case  9810: return ((char *) HT_09810); break;
-    case  9820: return ((char *) HT_09820); break;
-    case  9900: return ((char *) HT_09900); break;
-    case 10000: return ((char *) HT_10000); break;
-    case 10100: return ((char *) HT_10100); break;
-    case 10200: return ((char *) HT_10200); break;
-    case 10300: return ((char *) HT_10300); break;
-    case 10400: return ((char *) HT_10400); break;
-    case 10410: return ((char *) HT_10410); break;
-    case 10420: return ((char *) HT_10420); break;
-    case 10500: return ((char *) HT_10500); break;
-    case 10600: return ((char *) HT_10600); break;
-    case 10700: return ((char *) HT_10700); break;
-    case 10800: return ((char *) HT_10800); break;
-    case 10900: return ((char *) HT_10900); break;
-    case 11000: return ((char *) HT_11000); break;
-    case 11100: return ((char *) HT_11100); break;
-    case 11200: return ((char *) HT_11200); break;
-    case 11300: return ((char *) HT_11300); break;
-    case 11400: return ((char *) HT_11400); break;
-    case 11500: return ((char *) HT_11500); break;
-    case 11600: return ((char *) HT_11600); break;
-    case 11700: return ((char *) HT_11700); break;
-    case 11800: return ((char *) HT_11800); break;
-    case 11900: return ((char *) HT_11900); break;
-    case 12000: return ((char *) HT_12000); break;
-    case 12100: return ((char *) HT_12100); break;
-    case 12200: return ((char *) HT_12200); break;
-    case 12300: return ((char *) HT_12300); break;
-    case 12400: return ((char *) HT_12400); break;
-    case 12500: return ((char *) HT_12500); break;
-    case 12600: return ((char *) HT_12600); break;
-    case 12700: return ((char *) HT_12700); break;
-    case 12800: return ((char *) HT_12800); break;
-    case 12900: return ((char *) HT_12900); break;
-    case 13000: return ((char *) HT_13000); break;
-    case 13100: return ((char *) HT_13100); break;
-    case 13200: return ((char *) HT_13200); break;
-    case 13300: return ((char *) HT_13300); break;
-    case 13400: return ((char *) HT_13400); break;
-    case 13500: return ((char *) HT_13500); break;
-    case 13600: return ((char *) HT_13600); break;
-    case 13711: return ((char *) HT_13711); break;
-    case 13712: return ((char *) HT_13712); break;
-    case 13713: return ((char *) HT_13713); break;
-    case 13721: return ((char *) HT_13721); break;
-    case 13722: return ((char *) HT_13722); break;
-    case 13723: return ((char *) HT_13723); break;
-    case 13731: return ((char *) HT_13731); break;
-    case 13732: return ((char *) HT_13732); break;
-    case 13733: return ((char *) HT_13733); break;
-    case 13741: return ((char *) HT_13741); break;
-    case 13742: return ((char *) HT_13742); break;
-    case 13743: return ((char *) HT_13743); break;
-    case 13751: return ((char *) HT_13751); break;
-    case 13752: return ((char *) HT_13752); break;
-    case 13753: return ((char *) HT_13753); break;
-    case 13761: return ((char *) HT_13761); break;
-    case 13762: return ((char *) HT_13762); break;
-    case 13763: return ((char *) HT_13763); break;
-    case 13800: return ((char *) HT_13800); break;
-    case 13900: return ((char *) HT_13900); break;
-  }
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
 
-  return ((char *) "Unknown");
-}
+  uint n = 8;
 
-char *strstatus (const uint devices_status)
-{
-  switch (devices_status)
+  while (n--)
   {
-    case  STATUS_INIT:               return ((char *) ST_0000); break;
-    case  STATUS_STARTING:           return ((char *) ST_0001); break;
-    case  STATUS_RUNNING:            return ((char *) ST_0002); break;
-    case  STATUS_PAUSED:             return ((char *) ST_0003); break;
-    case  STATUS_EXHAUSTED:          return ((char *) ST_0004); break;
-    case  STATUS_CRACKED:            return ((char *) ST_0005); break;
-    case  STATUS_ABORTED:            return ((char *) ST_0006); break;
-    case  STATUS_QUIT:               return ((char *) ST_0007); break;
-    case  STATUS_BYPASS:             return ((char *) ST_0008); break;
-    case  STATUS_STOP_AT_CHECKPOINT: return ((char *) ST_0009); break;
-    case  STATUS_AUTOTUNE:           return ((char *) ST_0010); break;
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
   }
 
-  return ((char *) "Unknown");
+  return 0;
 }
 
-void ascii_digest (char *out_buf, uint salt_pos, uint digest_pos)
+int sort_by_digest_4_16 (const void *v1, const void *v2)
+{
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  uint n = 16;
+
+  while (n--)
+  {
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
+  }
+
+  return 0;
+}
+
+int sort_by_digest_4_32 (const void *v1, const void *v2)
+{
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  uint n = 32;
+
+  while (n--)
+  {
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
+  }
+
+  return 0;
+}
+
+int sort_by_digest_4_64 (const void *v1, const void *v2)
+{
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  uint n = 64;
+
+  while (n--)
+  {
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
+  }
+
+  return 0;
+}
+
+int sort_by_digest_8_8 (const void *v1, const void *v2)
+{
+  const u64 *d1 = (const u64 *) v1;
+  const u64 *d2 = (const u64 *) v2;
+
+  uint n = 8;
+
+  while (n--)
+  {
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
+  }
+
+  return 0;
+}
+
+int sort_by_digest_8_16 (const void *v1, const void *v2)
+{
+  const u64 *d1 = (const u64 *) v1;
+  const u64 *d2 = (const u64 *) v2;
+
+  uint n = 16;
+
+  while (n--)
+  {
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
+  }
+
+  return 0;
+}
+
+int sort_by_digest_8_25 (const void *v1, const void *v2)
+{
+  const u64 *d1 = (const u64 *) v1;
+  const u64 *d2 = (const u64 *) v2;
+
+  uint n = 25;
+
+  while (n--)
+  {
+    if (d1[n] > d2[n]) return ( 1);
+    if (d1[n] < d2[n]) return -1;
+  }
+
+  return 0;
+}
+
+int sort_by_digest_p0p1 (const void *v1, const void *v2)
+{
+  const u32 *d1 = (const u32 *) v1;
+  const u32 *d2 = (const u32 *) v2;
+
+  const uint dgst_pos0 = data.dgst_pos0;
+  const uint dgst_pos1 = data.dgst_pos1;
+  const uint dgst_pos2 = data.dgst_pos2;
+  const uint dgst_pos3 = data.dgst_pos3;
+
+  if (d1[dgst_pos3] > d2[dgst_pos3]) return ( 1);
+  if (d1[dgst_pos3] < d2[dgst_pos3]) return -1;
+  if (d1[dgst_pos2] > d2[dgst_pos2]) return ( 1);
+  if (d1[dgst_pos2] < d2[dgst_pos2]) return -1;
+  if (d1[dgst_pos1] > d2[dgst_pos1]) return ( 1);
+  if (d1[dgst_pos1] < d2[dgst_pos1]) return -1;
+  if (d1[dgst_pos0] > d2[dgst_pos0]) return ( 1);
+  if (d1[dgst_pos0] < d2[dgst_pos0]) return -1;
+
+  return 0;
+}
+
+int sort_by_tuning_db_alias (const void *v1, const void *v2)
+{
+  const tuning_db_alias_t *t1 = (const tuning_db_alias_t *) v1;
+  const tuning_db_alias_t *t2 = (const tuning_db_alias_t *) v2;
+
+  const int res1 = strcmp (t1->device_name, t2->device_name);
+
+  if (res1 != 0) return (res1);
+
+  return 0;
+}
+
+int sort_by_tuning_db_entry (const void *v1, const void *v2)
+{
+  const tuning_db_entry_t *t1 = (const tuning_db_entry_t *) v1;
+  const tuning_db_entry_t *t2 = (const tuning_db_entry_t *) v2;
+
+  const int res1 = strcmp (t1->device_name, t2->device_name);
+
+  if (res1 != 0) return (res1);
+
+  const int res2 = t1->attack_mode
+                 - t2->attack_mode;
+
+  if (res2 != 0) return (res2);
+
+  const int res3 = t1->hash_type
+                 - t2->hash_type;
+
+  if (res3 != 0) return (res3);
+
+  return 0;
+}
+
+void format_debug (char *debug_file, uint debug_mode, unsigned char *orig_plain_ptr, uint orig_plain_len, unsigned char *mod_plain_ptr, uint mod_plain_len, char *rule_buf, int rule_len)
+{
+  uint outfile_autohex = data.outfile_autohex;
+
+  unsigned char *rule_ptr = (unsigned char *) rule_buf;
+
+  FILE *debug_fp = NULL;
+
+  if (debug_file != NULL)
+  {
+    debug_fp = fopen (debug_file, "ab");
+
+    lock_file (debug_fp);
+  }
+  else
+  {
+    debug_fp = stderr;
+  }
+
+  if (debug_fp == NULL)
+  {
+    log_info ("WARNING: Could not open debug-file for writing");
+  }
+  else
+  {
+    if ((debug_mode == 2) || (debug_mode == 3) || (debug_mode == 4))
+    {
+      format_plain (debug_fp, orig_plain_ptr, orig_plain_len, outfile_autohex);
+
+      if ((debug_mode == 3) || (debug_mode == 4)) fputc (':', debug_fp);
+    }
+
+    fwrite (rule_ptr, rule_len, 1, debug_fp);
+
+    if (debug_mode == 4)
+    {
+      fputc (':', debug_fp);
+
+      format_plain (debug_fp, mod_plain_ptr, mod_plain_len, outfile_autohex);
+    }
+
+    fputc  ('\n', debug_fp);
+
+    if (debug_file != NULL) fclose (debug_fp);
+  }
+}
+
+void format_plain (FILE *fp, unsigned char *plain_ptr, uint plain_len, uint outfile_autohex)
+{
+  int needs_hexify = 0;
+
+  if (outfile_autohex == 1)
+  {
+    for (uint i = 0; i < plain_len; i++)
+    {
+      if (plain_ptr[i] < 0x20)
+      {
+        needs_hexify = 1;
+
+        break;
+      }
+
+      if (plain_ptr[i] > 0x7f)
+      {
+        needs_hexify = 1;
+
+        break;
+      }
+    }
+  }
+
+  if (needs_hexify == 1)
+  {
+    fprintf (fp, "$HEX[");
+
+    for (uint i = 0; i < plain_len; i++)
+    {
+      fprintf (fp, "%02x", plain_ptr[i]);
+    }
+
+    fprintf (fp, "]");
+  }
+  else
+  {
+    fwrite (plain_ptr, plain_len, 1, fp);
+  }
+}
+
+void format_output (FILE *out_fp, char *out_buf, unsigned char *plain_ptr, const uint plain_len, const u64 crackpos, unsigned char *username, const uint user_len)
+{
+  uint outfile_format = data.outfile_format;
+
+  char separator = data.separator;
+
+  if (outfile_format & OUTFILE_FMT_HASH)
+  {
+    fprintf (out_fp, "%s", out_buf);
+
+    if (outfile_format & (OUTFILE_FMT_PLAIN | OUTFILE_FMT_HEXPLAIN | OUTFILE_FMT_CRACKPOS))
+    {
+      fputc (separator, out_fp);
+    }
+  }
+  else if (data.username)
+  {
+    if (username != NULL)
+    {
+      for (uint i = 0; i < user_len; i++)
+      {
+        fprintf (out_fp, "%c", username[i]);
+      }
+
+      if (outfile_format & (OUTFILE_FMT_PLAIN | OUTFILE_FMT_HEXPLAIN | OUTFILE_FMT_CRACKPOS))
+      {
+        fputc (separator, out_fp);
+      }
+    }
+  }
+
+  if (outfile_format & OUTFILE_FMT_PLAIN)
+  {
+    format_plain (out_fp, plain_ptr, plain_len, data.outfile_autohex);
+
+    if (outfile_format & (OUTFILE_FMT_HEXPLAIN | OUTFILE_FMT_CRACKPOS))
+    {
+      fputc (separator, out_fp);
+    }
+  }
+
+  if (outfile_format & OUTFILE_FMT_HEXPLAIN)
+  {
+    for (uint i = 0; i < plain_len; i++)
+    {
+      fprintf (out_fp, "%02x", plain_ptr[i]);
+    }
+
+    if (outfile_format & (OUTFILE_FMT_CRACKPOS))
+    {
+      fputc (separator, out_fp);
+    }
+  }
+
+  if (outfile_format & OUTFILE_FMT_CRACKPOS)
+  {
+    #ifdef _WIN
+    __mingw_fprintf (out_fp, "%llu", crackpos);
+    #endif
+
+    #ifdef _POSIX
+    #ifdef __x86_64__
+    fprintf (out_fp, "%lu", (unsigned long) crackpos);
+    #else
+    fprintf (out_fp, "%llu", crackpos);
+    #endif
+    #endif
+  }
+
+  fputs (EOL, out_fp);
+}
+
+void handle_show_request (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hashes_buf, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
+{
+  pot_t pot_key;
+
+  pot_key.hash.salt   = hashes_buf->salt;
+  pot_key.hash.digest = hashes_buf->digest;
+
+  pot_t *pot_ptr = (pot_t *) bsearch (&pot_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+
+  if (pot_ptr)
+  {
+    log_info_nn ("");
+
+    input_buf[input_len] = 0;
+
+    // user
+    unsigned char *username = NULL;
+    uint user_len = 0;
+
+    if (data.username)
+    {
+      user_t *user = hashes_buf->hash_info->user;
+
+      if (user)
+      {
+        username = (unsigned char *) (user->user_name);
+
+        user_len = user->user_len;
+      }
+    }
+
+    // do output the line
+    format_output (out_fp, input_buf, (unsigned char *) pot_ptr->plain_buf, pot_ptr->plain_len, 0, username, user_len);
+  }
+}
+
+#define LM_WEAK_HASH    "\x4e\xcf\x0d\x0c\x0a\xe2\xfb\xc1"
+#define LM_MASKED_PLAIN "[notfound]"
+
+void handle_show_request_lm (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hash_left, hash_t *hash_right, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
+{
+  // left
+
+  pot_t pot_left_key;
+
+  pot_left_key.hash.salt   = hash_left->salt;
+  pot_left_key.hash.digest = hash_left->digest;
+
+  pot_t *pot_left_ptr = (pot_t *) bsearch (&pot_left_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+
+  // right
+
+  uint weak_hash_found = 0;
+
+  pot_t pot_right_key;
+
+  pot_right_key.hash.salt   = hash_right->salt;
+  pot_right_key.hash.digest = hash_right->digest;
+
+  pot_t *pot_right_ptr = (pot_t *) bsearch (&pot_right_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+
+  if (pot_right_ptr == NULL)
+  {
+    // special case, if "weak hash"
+
+    if (memcmp (hash_right->digest, LM_WEAK_HASH, 8) == 0)
+    {
+      weak_hash_found = 1;
+
+      pot_right_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+
+      // in theory this is not needed, but we are paranoia:
+
+      memset (pot_right_ptr->plain_buf, 0, sizeof (pot_right_ptr->plain_buf));
+      pot_right_ptr->plain_len = 0;
+    }
+  }
+
+  if ((pot_left_ptr == NULL) && (pot_right_ptr == NULL))
+  {
+    if (weak_hash_found == 1) myfree (pot_right_ptr); // this shouldn't happen at all: if weak_hash_found == 1, than pot_right_ptr is not NULL for sure
+
+    return;
+  }
+
+  // at least one half was found:
+
+  log_info_nn ("");
+
+  input_buf[input_len] = 0;
+
+  // user
+
+  unsigned char *username = NULL;
+  uint user_len = 0;
+
+  if (data.username)
+  {
+    user_t *user = hash_left->hash_info->user;
+
+    if (user)
+    {
+      username = (unsigned char *) (user->user_name);
+
+      user_len = user->user_len;
+    }
+  }
+
+  // mask the part which was not found
+
+  uint left_part_masked  = 0;
+  uint right_part_masked = 0;
+
+  uint mask_plain_len = strlen (LM_MASKED_PLAIN);
+
+  if (pot_left_ptr == NULL)
+  {
+    left_part_masked = 1;
+
+    pot_left_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+
+    memset (pot_left_ptr->plain_buf, 0, sizeof (pot_left_ptr->plain_buf));
+
+    memcpy (pot_left_ptr->plain_buf, LM_MASKED_PLAIN, mask_plain_len);
+    pot_left_ptr->plain_len = mask_plain_len;
+  }
+
+  if (pot_right_ptr == NULL)
+  {
+    right_part_masked = 1;
+
+    pot_right_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+
+    memset (pot_right_ptr->plain_buf, 0, sizeof (pot_right_ptr->plain_buf));
+
+    memcpy (pot_right_ptr->plain_buf, LM_MASKED_PLAIN, mask_plain_len);
+    pot_right_ptr->plain_len = mask_plain_len;
+  }
+
+  // create the pot_ptr out of pot_left_ptr and pot_right_ptr
+
+  pot_t pot_ptr;
+
+  pot_ptr.plain_len = pot_left_ptr->plain_len + pot_right_ptr->plain_len;
+
+  memcpy (pot_ptr.plain_buf, pot_left_ptr->plain_buf, pot_left_ptr->plain_len);
+
+  memcpy (pot_ptr.plain_buf + pot_left_ptr->plain_len, pot_right_ptr->plain_buf, pot_right_ptr->plain_len);
+
+  // do output the line
+
+  format_output (out_fp, input_buf, (unsigned char *) pot_ptr.plain_buf, pot_ptr.plain_len, 0, username, user_len);
+
+  if (weak_hash_found == 1) myfree (pot_right_ptr);
+
+  if (left_part_masked  == 1) myfree (pot_left_ptr);
+  if (right_part_masked == 1) myfree (pot_right_ptr);
+}
+
+void handle_left_request (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hashes_buf, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
+{
+  pot_t pot_key;
+
+  memcpy (&pot_key.hash, hashes_buf, sizeof (hash_t));
+
+  pot_t *pot_ptr = (pot_t *) bsearch (&pot_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+
+  if (pot_ptr == NULL)
+  {
+    log_info_nn ("");
+
+    input_buf[input_len] = 0;
+
+    format_output (out_fp, input_buf, NULL, 0, 0, NULL, 0);
+  }
+}
+
+void handle_left_request_lm (pot_t *pot, uint pot_cnt, char *input_buf, int input_len, hash_t *hash_left, hash_t *hash_right, int (*sort_by_pot) (const void *, const void *), FILE *out_fp)
+{
+  // left
+
+  pot_t pot_left_key;
+
+  memcpy (&pot_left_key.hash, hash_left, sizeof (hash_t));
+
+  pot_t *pot_left_ptr = (pot_t *) bsearch (&pot_left_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+
+  // right
+
+  pot_t pot_right_key;
+
+  memcpy (&pot_right_key.hash, hash_right, sizeof (hash_t));
+
+  pot_t *pot_right_ptr = (pot_t *) bsearch (&pot_right_key, pot, pot_cnt, sizeof (pot_t), sort_by_pot);
+
+  uint weak_hash_found = 0;
+
+  if (pot_right_ptr == NULL)
+  {
+    // special case, if "weak hash"
+
+    if (memcmp (hash_right->digest, LM_WEAK_HASH, 8) == 0)
+    {
+      weak_hash_found = 1;
+
+      // we just need that pot_right_ptr is not a NULL pointer
+
+      pot_right_ptr = (pot_t *) mycalloc (1, sizeof (pot_t));
+    }
+  }
+
+  if ((pot_left_ptr != NULL) && (pot_right_ptr != NULL))
+  {
+    if (weak_hash_found == 1) myfree (pot_right_ptr);
+
+    return;
+  }
+
+  // ... at least one part was not cracked
+
+  log_info_nn ("");
+
+  input_buf[input_len] = 0;
+
+  // only show the hash part which is still not cracked
+
+  uint user_len = input_len - 32;
+
+  char *hash_output = (char *) mymalloc (33);
+
+  memcpy (hash_output, input_buf, input_len);
+
+  if (pot_left_ptr != NULL)
+  {
+    // only show right part (because left part was already found)
+
+    memcpy (hash_output + user_len, input_buf + user_len + 16, 16);
+
+    hash_output[user_len + 16] = 0;
+  }
+
+  if (pot_right_ptr != NULL)
+  {
+    // only show left part (because right part was already found)
+
+    memcpy (hash_output + user_len, input_buf + user_len, 16);
+
+    hash_output[user_len + 16] = 0;
+  }
+
+  format_output (out_fp, hash_output, NULL, 0, 0, NULL, 0);
+
+  myfree (hash_output);
+
+  if (weak_hash_found == 1) myfree (pot_right_ptr);
+}
+
+uint setup_opencl_platforms_filter (char *opencl_platforms)
+{
+  uint opencl_platforms_filter = 0;
+
+  if (opencl_platforms)
+  {
+    char *platforms = strdup (opencl_platforms);
+
+    char *next = strtok (platforms, ",");
+
+    do
+    {
+      int platform = atoi (next);
+
+      if (platform < 1 || platform > 32)
+      {
+        log_error ("ERROR: Invalid OpenCL platform %u specified", platform);
+
+        exit (-1);
+      }
+
+      opencl_platforms_filter |= 1u << (platform - 1);
+
+    } while ((next = strtok (NULL, ",")) != NULL);
+
+    free (platforms);
+  }
+  else
+  {
+    opencl_platforms_filter = -1;
+  }
+
+  return opencl_platforms_filter;
+}
+
+u32 setup_devices_filter (char *opencl_devices)
+{
+  u32 devices_filter = 0;
+
+  if (opencl_devices)
+  {
+    char *devices = strdup (opencl_devices);
+
+    char *next = strtok (devices, ",");
+
+    do
+    {
+      int device_id = atoi (next);
+
+      if (device_id < 1 || device_id > 32)
+      {
+        log_error ("ERROR: Invalid device_id %u specified", device_id);
+
+        exit (-1);
+      }
+
+      devices_filter |= 1u << (device_id - 1);
+
+    } while ((next = strtok (NULL, ",")) != NULL);
+
+    free (devices);
+  }
+  else
+  {
+    devices_filter = -1;
+  }
+
+  return devices_filter;
+}
+
+cl_device_type setup_device_types_filter (char *opencl_device_types)
+{
+  cl_device_type device_types_filter = 0;
+
+  if (opencl_device_types)
+  {
+    char *device_types = strdup (opencl_device_types);
+
+    char *next = strtok (device_types, ",");
+
+    do
+    {
+      int device_type = atoi (next);
+
+      if (device_type < 1 || device_type > 3)
+      {
+        log_error ("ERROR: Invalid device_type %u specified", device_type);
+
+        exit (-1);
+      }
+
+      device_types_filter |= 1u << device_type;
+
+    } while ((next = strtok (NULL, ",")) != NULL);
+
+    free (device_types);
+  }
+  else
+  {
+    // Do not use CPU by default, this often reduces GPU performance because
+    // the CPU is too busy to handle GPU synchronization
+
+    device_types_filter = CL_DEVICE_TYPE_ALL & ~CL_DEVICE_TYPE_CPU;
+  }
+
+  return device_types_filter;
+}
+
+u32 get_random_num (const u32 min, const u32 max)
+{
+  if (min == max) return (min);
+
+  return ((rand () % (max - min)) + min);
+}
+
+u32 mydivc32 (const u32 dividend, const u32 divisor)
+{
+  u32 quotient = dividend / divisor;
+
+  if (dividend % divisor) quotient++;
+
+  return quotient;
+}
+
+u64 mydivc64 (const u64 dividend, const u64 divisor)
+{
+  u64 quotient = dividend / divisor;
+
+  if (dividend % divisor) quotient++;
+
+  return quotient;
+}
+
+void format_timer_display (struct tm *tm, char *buf, size_t len)
+{
+  const char *time_entities_s[] = { "year",  "day",  "hour",  "min",  "sec"  };
+  const char *time_entities_m[] = { "years", "days", "hours", "mins", "secs" };
+
+  if (tm->tm_year - 70)
+  {
+    char *time_entity1 = ((tm->tm_year - 70) == 1) ? (char *) time_entities_s[0] : (char *) time_entities_m[0];
+    char *time_entity2 = ( tm->tm_yday       == 1) ? (char *) time_entities_s[1] : (char *) time_entities_m[1];
+
+    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_year - 70, time_entity1, tm->tm_yday, time_entity2);
+  }
+  else if (tm->tm_yday)
+  {
+    char *time_entity1 = (tm->tm_yday == 1) ? (char *) time_entities_s[1] : (char *) time_entities_m[1];
+    char *time_entity2 = (tm->tm_hour == 1) ? (char *) time_entities_s[2] : (char *) time_entities_m[2];
+
+    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_yday, time_entity1, tm->tm_hour, time_entity2);
+  }
+  else if (tm->tm_hour)
+  {
+    char *time_entity1 = (tm->tm_hour == 1) ? (char *) time_entities_s[2] : (char *) time_entities_m[2];
+    char *time_entity2 = (tm->tm_min  == 1) ? (char *) time_entities_s[3] : (char *) time_entities_m[3];
+
+    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_hour, time_entity1, tm->tm_min, time_entity2);
+  }
+  else if (tm->tm_min)
+  {
+    char *time_entity1 = (tm->tm_min == 1) ? (char *) time_entities_s[3] : (char *) time_entities_m[3];
+    char *time_entity2 = (tm->tm_sec == 1) ? (char *) time_entities_s[4] : (char *) time_entities_m[4];
+
+    snprintf (buf, len - 1, "%d %s, %d %s", tm->tm_min, time_entity1, tm->tm_sec, time_entity2);
+  }
+  else
+  {
+    char *time_entity1 = (tm->tm_sec == 1) ? (char *) time_entities_s[4] : (char *) time_entities_m[4];
+
+    snprintf (buf, len - 1, "%d %s", tm->tm_sec, time_entity1);
+  }
+}
+
+void format_speed_display (float val, char *buf, size_t len)
+{
+  if (val <= 0)
+  {
+    buf[0] = '0';
+    buf[1] = ' ';
+    buf[2] = 0;
+
+    return;
+  }
+
+  char units[7] = { ' ', 'k', 'M', 'G', 'T', 'P', 'E' };
+
+  uint level = 0;
+
+  while (val > 99999)
+  {
+    val /= 1000;
+
+    level++;
+  }
+
+  /* generate output */
+
+  if (level == 0)
+  {
+    snprintf (buf, len - 1, "%.0f ", val);
+  }
+  else
+  {
+    snprintf (buf, len - 1, "%.1f %c", val, units[level]);
+  }
+}
+
+void lowercase (u8 *buf, int len)
+{
+  for (int i = 0; i < len; i++) buf[i] = tolower (buf[i]);
+}
+
+void uppercase (u8 *buf, int len)
+{
+  for (int i = 0; i < len; i++) buf[i] = toupper (buf[i]);
+}
+
+int fgetl (FILE *fp, char *line_buf)
+{
+  int line_len = 0;
+
+  while (!feof (fp))
+  {
+    const int c = fgetc (fp);
+
+    if (c == EOF) break;
+
+    line_buf[line_len] = (char) c;
+
+    line_len++;
+
+    if (line_len == HCBUFSIZ) line_len--;
+
+    if (c == '\n') break;
+  }
+
+  if (line_len == 0) return 0;
+
+  if (line_buf[line_len - 1] == '\n')
+  {
+    line_len--;
+
+    line_buf[line_len] = 0;
+  }
+
+  if (line_len == 0) return 0;
+
+  if (line_buf[line_len - 1] == '\r')
+  {
+    line_len--;
+
+    line_buf[line_len] = 0;
+  }
+
+  return (line_len);
+}
+
+int in_superchop (char *buf)
+{
+  int len = strlen (buf);
+
+  while (len)
+  {
+    if (buf[len - 1] == '\n')
+    {
+      len--;
+
+      continue;
+    }
+
+    if (buf[len - 1] == '\r')
+    {
+      len--;
+
+      continue;
+    }
+
+    break;
+  }
+
+  buf[len] = 0;
+
+  return len;
+}
+
+char **scan_directory (const char *path)
+{
+  char *tmp_path = mystrdup (path);
+
+  size_t tmp_path_len = strlen (tmp_path);
+
+  while (tmp_path[tmp_path_len - 1] == '/' || tmp_path[tmp_path_len - 1] == '\\')
+  {
+    tmp_path[tmp_path_len - 1] = 0;
+
+    tmp_path_len = strlen (tmp_path);
+  }
+
+  char **files = NULL;
+
+  int num_files = 0;
+
+  DIR *d = NULL;
+
+  if ((d = opendir (tmp_path)) != NULL)
+  {
+    #ifdef __APPLE__
+
+    struct dirent e;
+
+    for (;;)
+    {
+      memset (&e, 0, sizeof (e));
+
+      struct dirent *de = NULL;
+
+      if (readdir_r (d, &e, &de) != 0)
+      {
+        log_error ("ERROR: readdir_r() failed");
+
+        break;
+      }
+
+      if (de == NULL) break;
+
+    #else
+
+    struct dirent *de;
+
+    while ((de = readdir (d)) != NULL)
+    {
+
+    #endif
+
+      if ((strcmp (de->d_name, ".") == 0) || (strcmp (de->d_name, "..") == 0)) continue;
+
+      int path_size = strlen (tmp_path) + 1 + strlen (de->d_name);
+
+      char *path_file = (char *) mymalloc (path_size + 1);
+
+      snprintf (path_file, path_size + 1, "%s/%s", tmp_path, de->d_name);
+
+      path_file[path_size] = 0;
+
+      DIR *d_test;
+
+      if ((d_test = opendir (path_file)) != NULL)
+      {
+        closedir (d_test);
+
+        myfree (path_file);
+      }
+      else
+      {
+        files = (char **) myrealloc (files, num_files * sizeof (char *), sizeof (char *));
+
+        num_files++;
+
+        files[num_files - 1] = path_file;
+      }
+    }
+
+    closedir (d);
+  }
+  else if (errno == ENOTDIR)
+  {
+    files = (char **) myrealloc (files, num_files * sizeof (char *), sizeof (char *));
+
+    num_files++;
+
+    files[num_files - 1] = mystrdup (path);
+  }
+
+  files = (char **) myrealloc (files, num_files * sizeof (char *), sizeof (char *));
+
+  num_files++;
+
+  files[num_files - 1] = NULL;
+
+  myfree (tmp_path);
+
+  return (files);
+}
+
+int count_dictionaries (char **dictionary_files)
+{
+  if (dictionary_files == NULL) return 0;
+
+  int cnt = 0;
+
+  for (int d = 0; dictionary_files[d] != NULL; d++)
+  {
+    cnt++;
+  }
+
+  return (cnt);
+}
+
+char *stroptitype (const uint opti_type)
+{
+  switch (opti_type)
+  {
+    case OPTI_TYPE_ZERO_BYTE:         return ((char *) OPTI_STR_ZERO_BYTE);         break;
+    case OPTI_TYPE_PRECOMPUTE_INIT:   return ((char *) OPTI_STR_PRECOMPUTE_INIT);   break;
+    case OPTI_TYPE_PRECOMPUTE_MERKLE: return ((char *) OPTI_STR_PRECOMPUTE_MERKLE); break;
+    case OPTI_TYPE_PRECOMPUTE_PERMUT: return ((char *) OPTI_STR_PRECOMPUTE_PERMUT); break;
+    case OPTI_TYPE_MEET_IN_MIDDLE:    return ((char *) OPTI_STR_MEET_IN_MIDDLE);    break;
+    case OPTI_TYPE_EARLY_SKIP:        return ((char *) OPTI_STR_EARLY_SKIP);        break;
+    case OPTI_TYPE_NOT_SALTED:        return ((char *) OPTI_STR_NOT_SALTED);        break;
+    case OPTI_TYPE_NOT_ITERATED:      return ((char *) OPTI_STR_NOT_ITERATED);      break;
+    case OPTI_TYPE_PREPENDED_SALT:    return ((char *) OPTI_STR_PREPENDED_SALT);    break;
+    case OPTI_TYPE_APPENDED_SALT:     return ((char *) OPTI_STR_APPENDED_SALT);     break;
+    case OPTI_TYPE_SINGLE_HASH:       return ((char *) OPTI_STR_SINGLE_HASH);       break;
+    case OPTI_TYPE_SINGLE_SALT:       return ((char *) OPTI_STR_SINGLE_SALT);       break;
+    case OPTI_TYPE_BRUTE_FORCE:       return ((char *) OPTI_STR_BRUTE_FORCE);       break;
+    case OPTI_TYPE_RAW_HASH:          return ((char *) OPTI_STR_RAW_HASH);          break;
+    case OPTI_TYPE_SLOW_HASH_SIMD:    return ((char *) OPTI_STR_SLOW_HASH_SIMD);    break;
+    case OPTI_TYPE_USES_BITS_8:       return ((char *) OPTI_STR_USES_BITS_8);       break;
+    case OPTI_TYPE_USES_BITS_16:      return ((char *) OPTI_STR_USES_BITS_16);      break;
+    case OPTI_TYPE_USES_BITS_32:      return ((char *) OPTI_STR_USES_BITS_32);      break;
+    case OPTI_TYPE_USES_BITS_64:      return ((char *) OPTI_STR_USES_BITS_64);      break;
+  }
+
+  return (NULL);
+}
+
+char *strparser (const uint parser_status)
+{
+  switch (parser_status)
+  {
+    case PARSER_OK:                   return ((char *) PA_000); break;
+    case PARSER_COMMENT:              return ((char *) PA_001); break;
+    case PARSER_GLOBAL_ZERO:          return ((char *) PA_002); break;
+    case PARSER_GLOBAL_LENGTH:        return ((char *) PA_003); break;
+    case PARSER_HASH_LENGTH:          return ((char *) PA_004); break;
+    case PARSER_HASH_VALUE:           return ((char *) PA_005); break;
+    case PARSER_SALT_LENGTH:          return ((char *) PA_006); break;
+    case PARSER_SALT_VALUE:           return ((char *) PA_007); break;
+    case PARSER_SALT_ITERATION:       return ((char *) PA_008); break;
+    case PARSER_SEPARATOR_UNMATCHED:  return ((char *) PA_009); break;
+    case PARSER_SIGNATURE_UNMATCHED:  return ((char *) PA_010); break;
+    case PARSER_HCCAP_FILE_SIZE:      return ((char *) PA_011); break;
+    case PARSER_HCCAP_EAPOL_SIZE:     return ((char *) PA_012); break;
+    case PARSER_PSAFE2_FILE_SIZE:     return ((char *) PA_013); break;
+    case PARSER_PSAFE3_FILE_SIZE:     return ((char *) PA_014); break;
+    case PARSER_TC_FILE_SIZE:         return ((char *) PA_015); break;
+    case PARSER_SIP_AUTH_DIRECTIVE:   return ((char *) PA_016); break;
+  }
+
+  return ((char *) PA_255);
+}
+
+char *strhashtype (const uint hash_mode)
+{
+  switch (hash_mode)
+  {
+    case     0: return ((char *) HT_00000); break;
+    case    10: return ((char *) HT_00010); break;
+    case    11: return ((char *) HT_00011); break;
+    case    12: return ((char *) HT_00012); break;
+    case    20: return ((char *) HT_00020); break;
+    case    21: return ((char *) HT_00021); break;
+    case    22: return ((char *) HT_00022); break;
+    case    23: return ((char *) HT_00023); break;
+    case    30: return ((char *) HT_00030); break;
+    case    40: return ((char *) HT_00040); break;
+    case    50: return ((char *) HT_00050); break;
+    case    60: return ((char *) HT_00060); break;
+    case   100: return ((char *) HT_00100); break;
+    case   101: return ((char *) HT_00101); break;
+    case   110: return ((char *) HT_00110); break;
+    case   111: return ((char *) HT_00111); break;
+    case   112: return ((char *) HT_00112); break;
+    case   120: return ((char *) HT_00120); break;
+    case   121: return ((char *) HT_00121); break;
+    case   122: return ((char *) HT_00122); break;
+    case   124: return ((char *) HT_00124); break;
+    case   125: return ((char *) HT_00125); break;
+    case   130: return ((char *) HT_00130); break;
+    case   131: return ((char *) HT_00131); break;
+    case   132: return ((char *) HT_00132); break;
+    case   133: return ((char *) HT_00133); break;
+    case   140: return ((char *) HT_00140); break;
+    case   141: return ((char *) HT_00141); break;
+    case   150: return ((char *) HT_00150); break;
+    case   160: return ((char *) HT_00160); break;
+    case   200: return ((char *) HT_00200); break;
+    case   300: return ((char *) HT_00300); break;
+    case   400: return ((char *) HT_00400); break;
+    case   500: return ((char *) HT_00500); break;
+    case   501: return ((char *) HT_00501); break;
+    case   900: return ((char *) HT_00900); break;
+    case   910: return ((char *) HT_00910); break;
+    case  1000: return ((char *) HT_01000); break;
+    case  1100: return ((char *) HT_01100); break;
+    case  1400: return ((char *) HT_01400); break;
+    case  1410: return ((char *) HT_01410); break;
+    case  1420: return ((char *) HT_01420); break;
+    case  1421: return ((char *) HT_01421); break;
+    case  1430: return ((char *) HT_01430); break;
+    case  1440: return ((char *) HT_01440); break;
+    case  1441: return ((char *) HT_01441); break;
+    case  1450: return ((char *) HT_01450); break;
+    case  1460: return ((char *) HT_01460); break;
+    case  1500: return ((char *) HT_01500); break;
+    case  1600: return ((char *) HT_01600); break;
+    case  1700: return ((char *) HT_01700); break;
+    case  1710: return ((char *) HT_01710); break;
+    case  1711: return ((char *) HT_01711); break;
+    case  1720: return ((char *) HT_01720); break;
+    case  1722: return ((char *) HT_01722); break;
+    case  1730: return ((char *) HT_01730); break;
+    case  1731: return ((char *) HT_01731); break;
+    case  1740: return ((char *) HT_01740); break;
+    case  1750: return ((char *) HT_01750); break;
+    case  1760: return ((char *) HT_01760); break;
+    case  1800: return ((char *) HT_01800); break;
+    case  2100: return ((char *) HT_02100); break;
+    case  2400: return ((char *) HT_02400); break;
+    case  2410: return ((char *) HT_02410); break;
+    case  2500: return ((char *) HT_02500); break;
+    case  2600: return ((char *) HT_02600); break;
+    case  2611: return ((char *) HT_02611); break;
+    case  2612: return ((char *) HT_02612); break;
+    case  2711: return ((char *) HT_02711); break;
+    case  2811: return ((char *) HT_02811); break;
+    case  3000: return ((char *) HT_03000); break;
+    case  3100: return ((char *) HT_03100); break;
+    case  3200: return ((char *) HT_03200); break;
+    case  3710: return ((char *) HT_03710); break;
+    case  3711: return ((char *) HT_03711); break;
+    case  3800: return ((char *) HT_03800); break;
+    case  4300: return ((char *) HT_04300); break;
+    case  4400: return ((char *) HT_04400); break;
+    case  4500: return ((char *) HT_04500); break;
+    case  4700: return ((char *) HT_04700); break;
+    case  4800: return ((char *) HT_04800); break;
+    case  4900: return ((char *) HT_04900); break;
+    case  5000: return ((char *) HT_05000); break;
+    case  5100: return ((char *) HT_05100); break;
+    case  5200: return ((char *) HT_05200); break;
+    case  5300: return ((char *) HT_05300); break;
+    case  5400: return ((char *) HT_05400); break;
+    case  5500: return ((char *) HT_05500); break;
+    case  5600: return ((char *) HT_05600); break;
+    case  5700: return ((char *) HT_05700); break;
+    case  5800: return ((char *) HT_05800); break;
+    case  6000: return ((char *) HT_06000); break;
+    case  6100: return ((char *) HT_06100); break;
+    case  6211: return ((char *) HT_06211); break;
+    case  6212: return ((char *) HT_06212); break;
+    case  6213: return ((char *) HT_06213); break;
+    case  6221: return ((char *) HT_06221); break;
+    case  6222: return ((char *) HT_06222); break;
+    case  6223: return ((char *) HT_06223); break;
+    case  6231: return ((char *) HT_06231); break;
+    case  6232: return ((char *) HT_06232); break;
+    case  6233: return ((char *) HT_06233); break;
+    case  6241: return ((char *) HT_06241); break;
+    case  6242: return ((char *) HT_06242); break;
+    case  6243: return ((char *) HT_06243); break;
+    case  6300: return ((char *) HT_06300); break;
+    case  6400: return ((char *) HT_06400); break;
+    case  6500: return ((char *) HT_06500); break;
+    case  6600: return ((char *) HT_06600); break;
+    case  6700: return ((char *) HT_06700); break;
+    case  6800: return ((char *) HT_06800); break;
+    case  6900: return ((char *) HT_06900); break;
+    case  7100: return ((char *) HT_07100); break;
+    case  7200: return ((char *) HT_07200); break;
+    case  7300: return ((char *) HT_07300); break;
+    case  7400: return ((char *) HT_07400); break;
+    case  7500: return ((char *) HT_07500); break;
+    case  7600: return ((char *) HT_07600); break;
+    case  7700: return ((char *) HT_07700); break;
+    case  7800: return ((char *) HT_07800); break;
+    case  7900: return ((char *) HT_07900); break;
+    case  8000: return ((char *) HT_08000); break;
+    case  8100: return ((char *) HT_08100); break;
+    case  8200: return ((char *) HT_08200); break;
+    case  8300: return ((char *) HT_08300); break;
+    case  8400: return ((char *) HT_08400); break;
+    case  8500: return ((char *) HT_08500); break;
+    case  8600: return ((char *) HT_08600); break;
+    case  8700: return ((char *) HT_08700); break;
+    case  8800: return ((char *) HT_08800); break;
+    case  8900: return ((char *) HT_08900); break;
+    case  9000: return ((char *) HT_09000); break;
+    case  9100: return ((char *) HT_09100); break;
+    case  9200: return ((char *) HT_09200); break;
+    case  9300: return ((char *) HT_09300); break;
+    case  9400: return ((char *) HT_09400); break;
+    case  9500: return ((char *) HT_09500); break;
+    case  9600: return ((char *) HT_09600); break;
+    case  9700: return ((char *) HT_09700); break;
+    case  9710: return ((char *) HT_09710); break;
+    case  9720: return ((char *) HT_09720); break;
+    case  9800: return ((char *) HT_09800); break;
+    case  9810: return ((char *) HT_09810); break;
+    case  9820: return ((char *) HT_09820); break;
+    case  9900: return ((char *) HT_09900); break;
+    case 10000: return ((char *) HT_10000); break;
+    case 10100: return ((char *) HT_10100); break;
+    case 10200: return ((char *) HT_10200); break;
+    case 10300: return ((char *) HT_10300); break;
+    case 10400: return ((char *) HT_10400); break;
+    case 10410: return ((char *) HT_10410); break;
+    case 10420: return ((char *) HT_10420); break;
+    case 10500: return ((char *) HT_10500); break;
+    case 10600: return ((char *) HT_10600); break;
+    case 10700: return ((char *) HT_10700); break;
+    case 10800: return ((char *) HT_10800); break;
+    case 10900: return ((char *) HT_10900); break;
+    case 11000: return ((char *) HT_11000); break;
+    case 11100: return ((char *) HT_11100); break;
+    case 11200: return ((char *) HT_11200); break;
+    case 11300: return ((char *) HT_11300); break;
+    case 11400: return ((char *) HT_11400); break;
+    case 11500: return ((char *) HT_11500); break;
+    case 11600: return ((char *) HT_11600); break;
+    case 11700: return ((char *) HT_11700); break;
+    case 11800: return ((char *) HT_11800); break;
+    case 11900: return ((char *) HT_11900); break;
+    case 12000: return ((char *) HT_12000); break;
+    case 12100: return ((char *) HT_12100); break;
+    case 12200: return ((char *) HT_12200); break;
+    case 12300: return ((char *) HT_12300); break;
+    case 12400: return ((char *) HT_12400); break;
+    case 12500: return ((char *) HT_12500); break;
+    case 12600: return ((char *) HT_12600); break;
+    case 12700: return ((char *) HT_12700); break;
+    case 12800: return ((char *) HT_12800); break;
+    case 12900: return ((char *) HT_12900); break;
+    case 13000: return ((char *) HT_13000); break;
+    case 13100: return ((char *) HT_13100); break;
+    case 13200: return ((char *) HT_13200); break;
+    case 13300: return ((char *) HT_13300); break;
+    case 13400: return ((char *) HT_13400); break;
+    case 13500: return ((char *) HT_13500); break;
+    case 13600: return ((char *) HT_13600); break;
+    case 13711: return ((char *) HT_13711); break;
+    case 13712: return ((char *) HT_13712); break;
+    case 13713: return ((char *) HT_13713); break;
+    case 13721: return ((char *) HT_13721); break;
+    case 13722: return ((char *) HT_13722); break;
+    case 13723: return ((char *) HT_13723); break;
+    case 13731: return ((char *) HT_13731); break;
+    case 13732: return ((char *) HT_13732); break;
+    case 13733: return ((char *) HT_13733); break;
+    case 13741: return ((char *) HT_13741); break;
+    case 13742: return ((char *) HT_13742); break;
+    case 13743: return ((char *) HT_13743); break;
+    case 13751: return ((char *) HT_13751); break;
+    case 13752: return ((char *) HT_13752); break;
+    case 13753: return ((char *) HT_13753); break;
+    case 13761: return ((char *) HT_13761); break;
+    case 13762: return ((char *) HT_13762); break;
+    case 13763: return ((char *) HT_13763); break;
+    case 13800: return ((char *) HT_13800); break;
+    case 13900: return ((char *) HT_13900); break;
+  }
+
+  return ((char *) "Unknown");
+}
+
+char *strstatus (const uint devices_status)
+{
+  switch (devices_status)
+  {
+    case  STATUS_INIT:               return ((char *) ST_0000); break;
+    case  STATUS_STARTING:           return ((char *) ST_0001); break;
+    case  STATUS_RUNNING:            return ((char *) ST_0002); break;
+    case  STATUS_PAUSED:             return ((char *) ST_0003); break;
+    case  STATUS_EXHAUSTED:          return ((char *) ST_0004); break;
+    case  STATUS_CRACKED:            return ((char *) ST_0005); break;
+    case  STATUS_ABORTED:            return ((char *) ST_0006); break;
+    case  STATUS_QUIT:               return ((char *) ST_0007); break;
+    case  STATUS_BYPASS:             return ((char *) ST_0008); break;
+    case  STATUS_STOP_AT_CHECKPOINT: return ((char *) ST_0009); break;
+    case  STATUS_AUTOTUNE:           return ((char *) ST_0010); break;
+  }
+
+  return ((char *) "Unknown");
+}
+
+void ascii_digest (char *out_buf, uint salt_pos, uint digest_pos)
 {
   uint hash_type = data.hash_type;
   uint hash_mode = data.hash_mode;
@@ -6182,320 +7868,1000 @@ void ascii_digest (char *out_buf, uint salt_pos, uint digest_pos)
   uint opti_type = data.opti_type;
   uint dgst_size = data.dgst_size;
 
-  char *hashfile = data.hashfile;
+  char *hashfile = data.hashfile;
+
+  uint len = 4096;
+
+  u8 datax[256] = { 0 };
+
+  u64 *digest_buf64 = (u64 *) datax;
+  u32 *digest_buf   = (u32 *) datax;
+
+  char *digests_buf_ptr = (char *) data.digests_buf;
+
+  memcpy (digest_buf, digests_buf_ptr + (data.salts_buf[salt_pos].digests_offset * dgst_size) + (digest_pos * dgst_size), dgst_size);
+
+  if (opti_type & OPTI_TYPE_PRECOMPUTE_PERMUT)
+  {
+    uint tt;
+
+    switch (hash_type)
+    {
+      case HASH_TYPE_DESCRYPT:
+        FP (digest_buf[1], digest_buf[0], tt);
+        break;
+
+      case HASH_TYPE_DESRACF:
+        digest_buf[0] = rotl32 (digest_buf[0], 29);
+        digest_buf[1] = rotl32 (digest_buf[1], 29);
+
+        FP (digest_buf[1], digest_buf[0], tt);
+        break;
+
+      case HASH_TYPE_LM:
+        FP (digest_buf[1], digest_buf[0], tt);
+        break;
+
+      case HASH_TYPE_NETNTLM:
+        digest_buf[0] = rotl32 (digest_buf[0], 29);
+        digest_buf[1] = rotl32 (digest_buf[1], 29);
+        digest_buf[2] = rotl32 (digest_buf[2], 29);
+        digest_buf[3] = rotl32 (digest_buf[3], 29);
+
+        FP (digest_buf[1], digest_buf[0], tt);
+        FP (digest_buf[3], digest_buf[2], tt);
+        break;
+
+      case HASH_TYPE_BSDICRYPT:
+        digest_buf[0] = rotl32 (digest_buf[0], 31);
+        digest_buf[1] = rotl32 (digest_buf[1], 31);
+
+        FP (digest_buf[1], digest_buf[0], tt);
+        break;
+    }
+  }
+
+  if (opti_type & OPTI_TYPE_PRECOMPUTE_MERKLE)
+  {
+    switch (hash_type)
+    {
+      case HASH_TYPE_MD4:
+        digest_buf[0] += MD4M_A;
+        digest_buf[1] += MD4M_B;
+        digest_buf[2] += MD4M_C;
+        digest_buf[3] += MD4M_D;
+        break;
+
+      case HASH_TYPE_MD5:
+        digest_buf[0] += MD5M_A;
+        digest_buf[1] += MD5M_B;
+        digest_buf[2] += MD5M_C;
+        digest_buf[3] += MD5M_D;
+        break;
+
+      case HASH_TYPE_SHA1:
+        digest_buf[0] += SHA1M_A;
+        digest_buf[1] += SHA1M_B;
+        digest_buf[2] += SHA1M_C;
+        digest_buf[3] += SHA1M_D;
+        digest_buf[4] += SHA1M_E;
+        break;
+
+      case HASH_TYPE_SHA256:
+        digest_buf[0] += SHA256M_A;
+        digest_buf[1] += SHA256M_B;
+        digest_buf[2] += SHA256M_C;
+        digest_buf[3] += SHA256M_D;
+        digest_buf[4] += SHA256M_E;
+        digest_buf[5] += SHA256M_F;
+        digest_buf[6] += SHA256M_G;
+        digest_buf[7] += SHA256M_H;
+        break;
+
+      case HASH_TYPE_SHA384:
+        digest_buf64[0] += SHA384M_A;
+        digest_buf64[1] += SHA384M_B;
+        digest_buf64[2] += SHA384M_C;
+        digest_buf64[3] += SHA384M_D;
+        digest_buf64[4] += SHA384M_E;
+        digest_buf64[5] += SHA384M_F;
+        digest_buf64[6] += 0;
+        digest_buf64[7] += 0;
+        break;
+
+      case HASH_TYPE_SHA512:
+        digest_buf64[0] += SHA512M_A;
+        digest_buf64[1] += SHA512M_B;
+        digest_buf64[2] += SHA512M_C;
+        digest_buf64[3] += SHA512M_D;
+        digest_buf64[4] += SHA512M_E;
+        digest_buf64[5] += SHA512M_F;
+        digest_buf64[6] += SHA512M_G;
+        digest_buf64[7] += SHA512M_H;
+        break;
+    }
+  }
+
+  if (opts_type & OPTS_TYPE_PT_GENERATE_LE)
+  {
+    if (dgst_size == DGST_SIZE_4_2)
+    {
+      for (int i = 0; i < 2; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+    }
+    else if (dgst_size == DGST_SIZE_4_4)
+    {
+      for (int i = 0; i < 4; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+    }
+    else if (dgst_size == DGST_SIZE_4_5)
+    {
+      for (int i = 0; i < 5; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+    }
+    else if (dgst_size == DGST_SIZE_4_6)
+    {
+      for (int i = 0; i < 6; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+    }
+    else if (dgst_size == DGST_SIZE_4_8)
+    {
+      for (int i = 0; i < 8; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+    }
+    else if ((dgst_size == DGST_SIZE_4_16) || (dgst_size == DGST_SIZE_8_8)) // same size, same result :)
+    {
+      if (hash_type == HASH_TYPE_WHIRLPOOL)
+      {
+        for (int i = 0; i < 16; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+      }
+      else if (hash_type == HASH_TYPE_SHA384)
+      {
+        for (int i = 0; i < 8; i++) digest_buf64[i] = byte_swap_64 (digest_buf64[i]);
+      }
+      else if (hash_type == HASH_TYPE_SHA512)
+      {
+        for (int i = 0; i < 8; i++) digest_buf64[i] = byte_swap_64 (digest_buf64[i]);
+      }
+      else if (hash_type == HASH_TYPE_GOST)
+      {
+        for (int i = 0; i < 16; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+      }
+    }
+    else if (dgst_size == DGST_SIZE_4_64)
+    {
+      for (int i = 0; i < 64; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
+    }
+    else if (dgst_size == DGST_SIZE_8_25)
+    {
+      for (int i = 0; i < 25; i++) digest_buf64[i] = byte_swap_64 (digest_buf64[i]);
+    }
+  }
+
+  uint isSalted = ((data.salt_type == SALT_TYPE_INTERN)
+                |  (data.salt_type == SALT_TYPE_EXTERN)
+                |  (data.salt_type == SALT_TYPE_EMBEDDED));
+
+  salt_t salt;
+
+  if (isSalted)
+  {
+    memset (&salt, 0, sizeof (salt_t));
+
+    memcpy (&salt, &data.salts_buf[salt_pos], sizeof (salt_t));
+
+    char *ptr = (char *) salt.salt_buf;
+
+    uint len = salt.salt_len;
+
+    if (opti_type & OPTI_TYPE_PRECOMPUTE_PERMUT)
+    {
+      uint tt;
+
+      switch (hash_type)
+      {
+        case HASH_TYPE_NETNTLM:
+
+          salt.salt_buf[0] = rotr32 (salt.salt_buf[0], 3);
+          salt.salt_buf[1] = rotr32 (salt.salt_buf[1], 3);
+
+          FP (salt.salt_buf[1], salt.salt_buf[0], tt);
+
+          break;
+      }
+    }
+
+    if (opts_type & OPTS_TYPE_ST_UNICODE)
+    {
+      for (uint i = 0, j = 0; i < len; i += 1, j += 2)
+      {
+        ptr[i] = ptr[j];
+      }
+
+      len = len / 2;
+    }
+
+    if (opts_type & OPTS_TYPE_ST_GENERATE_LE)
+    {
+      uint max = salt.salt_len / 4;
+
+      if (len % 4) max++;
+
+      for (uint i = 0; i < max; i++)
+      {
+        salt.salt_buf[i] = byte_swap_32 (salt.salt_buf[i]);
+      }
+    }
+
+    if (opts_type & OPTS_TYPE_ST_HEX)
+    {
+      char tmp[64] = { 0 };
+
+      for (uint i = 0, j = 0; i < len; i += 1, j += 2)
+      {
+        sprintf (tmp + j, "%02x", (unsigned char) ptr[i]);
+      }
+
+      len = len * 2;
+
+      memcpy (ptr, tmp, len);
+    }
+
+    uint memset_size = ((48 - (int) len) > 0) ? (48 - len) : 0;
+
+    memset (ptr + len, 0, memset_size);
+
+    salt.salt_len = len;
+  }
+
+  //
+  // some modes require special encoding
+  //
+
+  uint out_buf_plain[256] = { 0 };
+  uint out_buf_salt[256] = { 0 };
+
+  char tmp_buf[1024] = { 0 };
+
+  char *ptr_plain = (char *) out_buf_plain;
+  char *ptr_salt  = (char *) out_buf_salt;
+
+  if (hash_mode == 22)
+  {
+    char username[30] = { 0 };
+
+    memcpy (username, salt.salt_buf, salt.salt_len - 22);
+
+    char sig[6] = { 'n', 'r', 'c', 's', 't', 'n' };
+
+    u16 *ptr = (u16 *) digest_buf;
+
+    tmp_buf[ 0] = sig[0];
+    tmp_buf[ 1] = int_to_base64 (((ptr[1]) >> 12) & 0x3f);
+    tmp_buf[ 2] = int_to_base64 (((ptr[1]) >>  6) & 0x3f);
+    tmp_buf[ 3] = int_to_base64 (((ptr[1]) >>  0) & 0x3f);
+    tmp_buf[ 4] = int_to_base64 (((ptr[0]) >> 12) & 0x3f);
+    tmp_buf[ 5] = int_to_base64 (((ptr[0]) >>  6) & 0x3f);
+    tmp_buf[ 6] = sig[1];
+    tmp_buf[ 7] = int_to_base64 (((ptr[0]) >>  0) & 0x3f);
+    tmp_buf[ 8] = int_to_base64 (((ptr[3]) >> 12) & 0x3f);
+    tmp_buf[ 9] = int_to_base64 (((ptr[3]) >>  6) & 0x3f);
+    tmp_buf[10] = int_to_base64 (((ptr[3]) >>  0) & 0x3f);
+    tmp_buf[11] = int_to_base64 (((ptr[2]) >> 12) & 0x3f);
+    tmp_buf[12] = sig[2];
+    tmp_buf[13] = int_to_base64 (((ptr[2]) >>  6) & 0x3f);
+    tmp_buf[14] = int_to_base64 (((ptr[2]) >>  0) & 0x3f);
+    tmp_buf[15] = int_to_base64 (((ptr[5]) >> 12) & 0x3f);
+    tmp_buf[16] = int_to_base64 (((ptr[5]) >>  6) & 0x3f);
+    tmp_buf[17] = sig[3];
+    tmp_buf[18] = int_to_base64 (((ptr[5]) >>  0) & 0x3f);
+    tmp_buf[19] = int_to_base64 (((ptr[4]) >> 12) & 0x3f);
+    tmp_buf[20] = int_to_base64 (((ptr[4]) >>  6) & 0x3f);
+    tmp_buf[21] = int_to_base64 (((ptr[4]) >>  0) & 0x3f);
+    tmp_buf[22] = int_to_base64 (((ptr[7]) >> 12) & 0x3f);
+    tmp_buf[23] = sig[4];
+    tmp_buf[24] = int_to_base64 (((ptr[7]) >>  6) & 0x3f);
+    tmp_buf[25] = int_to_base64 (((ptr[7]) >>  0) & 0x3f);
+    tmp_buf[26] = int_to_base64 (((ptr[6]) >> 12) & 0x3f);
+    tmp_buf[27] = int_to_base64 (((ptr[6]) >>  6) & 0x3f);
+    tmp_buf[28] = int_to_base64 (((ptr[6]) >>  0) & 0x3f);
+    tmp_buf[29] = sig[5];
+
+    snprintf (out_buf, len-1, "%s:%s",
+      tmp_buf,
+      username);
+  }
+  else if (hash_mode == 23)
+  {
+    // do not show the skyper part in output
+
+    char *salt_buf_ptr = (char *) salt.salt_buf;
+
+    salt_buf_ptr[salt.salt_len - 8] = 0;
+
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x:%s",
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      salt_buf_ptr);
+  }
+  else if (hash_mode == 101)
+  {
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+
+    memcpy (tmp_buf, digest_buf, 20);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20, (u8 *) ptr_plain);
+
+    snprintf (out_buf, len-1, "{SHA}%s", ptr_plain);
+  }
+  else if (hash_mode == 111)
+  {
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+
+    memcpy (tmp_buf, digest_buf, 20);
+    memcpy (tmp_buf + 20, salt.salt_buf, salt.salt_len);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20 + salt.salt_len, (u8 *) ptr_plain);
+
+    snprintf (out_buf, len-1, "{SSHA}%s", ptr_plain);
+  }
+  else if ((hash_mode == 122) || (hash_mode == 125))
+  {
+    snprintf (out_buf, len-1, "%s%08x%08x%08x%08x%08x",
+      (char *) salt.salt_buf,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4]);
+  }
+  else if (hash_mode == 124)
+  {
+    snprintf (out_buf, len-1, "sha1$%s$%08x%08x%08x%08x%08x",
+      (char *) salt.salt_buf,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4]);
+  }
+  else if (hash_mode == 131)
+  {
+    snprintf (out_buf, len-1, "0x0100%s%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+      (char *) salt.salt_buf,
+      0, 0, 0, 0, 0,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4]);
+  }
+  else if (hash_mode == 132)
+  {
+    snprintf (out_buf, len-1, "0x0100%s%08x%08x%08x%08x%08x",
+      (char *) salt.salt_buf,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4]);
+  }
+  else if (hash_mode == 133)
+  {
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+
+    memcpy (tmp_buf, digest_buf, 20);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20, (u8 *) ptr_plain);
+
+    snprintf (out_buf, len-1, "%s", ptr_plain);
+  }
+  else if (hash_mode == 141)
+  {
+    memcpy (tmp_buf, salt.salt_buf, salt.salt_len);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, salt.salt_len, (u8 *) ptr_salt);
+
+    memset (tmp_buf, 0, sizeof (tmp_buf));
+
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+
+    memcpy (tmp_buf, digest_buf, 20);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20, (u8 *) ptr_plain);
+
+    ptr_plain[27] = 0;
+
+    snprintf (out_buf, len-1, "%s%s*%s", SIGNATURE_EPISERVER, ptr_salt, ptr_plain);
+  }
+  else if (hash_mode == 400)
+  {
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+
+    phpass_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
 
-  uint len = 4096;
+    snprintf (out_buf, len-1, "%s%s%s", (char *) salt.salt_sign, (char *) salt.salt_buf, (char *) ptr_plain);
+  }
+  else if (hash_mode == 500)
+  {
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
 
-  u8 datax[256] = { 0 };
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
 
-  u64 *digest_buf64 = (u64 *) datax;
-  u32 *digest_buf   = (u32 *) datax;
+    md5crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+
+    if (salt.salt_iter == ROUNDS_MD5CRYPT)
+    {
+      snprintf (out_buf, len-1, "$1$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
+    }
+    else
+    {
+      snprintf (out_buf, len-1, "$1$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
+    }
+  }
+  else if (hash_mode == 501)
+  {
+    uint digest_idx = salt.digests_offset + digest_pos;
+
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+
+    snprintf (out_buf, len-1, "%s", hash_buf);
+  }
+  else if (hash_mode == 1421)
+  {
+    u8 *salt_ptr = (u8 *) salt.salt_buf;
+
+    snprintf (out_buf, len-1, "%c%c%c%c%c%c%08x%08x%08x%08x%08x%08x%08x%08x",
+      salt_ptr[0],
+      salt_ptr[1],
+      salt_ptr[2],
+      salt_ptr[3],
+      salt_ptr[4],
+      salt_ptr[5],
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4],
+      digest_buf[5],
+      digest_buf[6],
+      digest_buf[7]);
+  }
+  else if (hash_mode == 1441)
+  {
+    memcpy (tmp_buf, salt.salt_buf, salt.salt_len);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, salt.salt_len, (u8 *) ptr_salt);
+
+    memset (tmp_buf, 0, sizeof (tmp_buf));
+
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    digest_buf[5] = byte_swap_32 (digest_buf[5]);
+    digest_buf[6] = byte_swap_32 (digest_buf[6]);
+    digest_buf[7] = byte_swap_32 (digest_buf[7]);
+
+    memcpy (tmp_buf, digest_buf, 32);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, 32, (u8 *) ptr_plain);
+
+    ptr_plain[43] = 0;
+
+    snprintf (out_buf, len-1, "%s%s*%s", SIGNATURE_EPISERVER4, ptr_salt, ptr_plain);
+  }
+  else if (hash_mode == 1500)
+  {
+    out_buf[0] = salt.salt_sign[0] & 0xff;
+    out_buf[1] = salt.salt_sign[1] & 0xff;
+    //original method, but changed because of this ticket: https://hashcat.net/trac/ticket/269
+    //out_buf[0] = int_to_itoa64 ((salt.salt_buf[0] >> 0) & 0x3f);
+    //out_buf[1] = int_to_itoa64 ((salt.salt_buf[0] >> 6) & 0x3f);
+
+    memset (tmp_buf, 0, sizeof (tmp_buf));
+
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+
+    memcpy (tmp_buf, digest_buf, 8);
+
+    base64_encode (int_to_itoa64, (const u8 *) tmp_buf, 8, (u8 *) ptr_plain);
+
+    snprintf (out_buf + 2, len-1-2, "%s", ptr_plain);
+
+    out_buf[13] = 0;
+  }
+  else if (hash_mode == 1600)
+  {
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+
+    md5crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+
+    if (salt.salt_iter == ROUNDS_MD5CRYPT)
+    {
+      snprintf (out_buf, len-1, "$apr1$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
+    }
+    else
+    {
+      snprintf (out_buf, len-1, "$apr1$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
+    }
+  }
+  else if (hash_mode == 1711)
+  {
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf64[0] = byte_swap_64 (digest_buf64[0]);
+    digest_buf64[1] = byte_swap_64 (digest_buf64[1]);
+    digest_buf64[2] = byte_swap_64 (digest_buf64[2]);
+    digest_buf64[3] = byte_swap_64 (digest_buf64[3]);
+    digest_buf64[4] = byte_swap_64 (digest_buf64[4]);
+    digest_buf64[5] = byte_swap_64 (digest_buf64[5]);
+    digest_buf64[6] = byte_swap_64 (digest_buf64[6]);
+    digest_buf64[7] = byte_swap_64 (digest_buf64[7]);
+
+    memcpy (tmp_buf, digest_buf, 64);
+    memcpy (tmp_buf + 64, salt.salt_buf, salt.salt_len);
+
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, 64 + salt.salt_len, (u8 *) ptr_plain);
+
+    snprintf (out_buf, len-1, "%s%s", SIGNATURE_SHA512B64S, ptr_plain);
+  }
+  else if (hash_mode == 1722)
+  {
+    uint *ptr = digest_buf;
+
+    snprintf (out_buf, len-1, "%s%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+      (unsigned char *) salt.salt_buf,
+      ptr[ 1], ptr[ 0],
+      ptr[ 3], ptr[ 2],
+      ptr[ 5], ptr[ 4],
+      ptr[ 7], ptr[ 6],
+      ptr[ 9], ptr[ 8],
+      ptr[11], ptr[10],
+      ptr[13], ptr[12],
+      ptr[15], ptr[14]);
+  }
+  else if (hash_mode == 1731)
+  {
+    uint *ptr = digest_buf;
+
+    snprintf (out_buf, len-1, "0x0200%s%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+      (unsigned char *) salt.salt_buf,
+        ptr[ 1], ptr[ 0],
+        ptr[ 3], ptr[ 2],
+        ptr[ 5], ptr[ 4],
+        ptr[ 7], ptr[ 6],
+        ptr[ 9], ptr[ 8],
+        ptr[11], ptr[10],
+        ptr[13], ptr[12],
+        ptr[15], ptr[14]);
+  }
+  else if (hash_mode == 1800)
+  {
+    // temp workaround
+
+    digest_buf64[0] = byte_swap_64 (digest_buf64[0]);
+    digest_buf64[1] = byte_swap_64 (digest_buf64[1]);
+    digest_buf64[2] = byte_swap_64 (digest_buf64[2]);
+    digest_buf64[3] = byte_swap_64 (digest_buf64[3]);
+    digest_buf64[4] = byte_swap_64 (digest_buf64[4]);
+    digest_buf64[5] = byte_swap_64 (digest_buf64[5]);
+    digest_buf64[6] = byte_swap_64 (digest_buf64[6]);
+    digest_buf64[7] = byte_swap_64 (digest_buf64[7]);
+
+    sha512crypt_encode ((unsigned char *) digest_buf64, (unsigned char *) ptr_plain);
+
+    if (salt.salt_iter == ROUNDS_SHA512CRYPT)
+    {
+      snprintf (out_buf, len-1, "$6$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
+    }
+    else
+    {
+      snprintf (out_buf, len-1, "$6$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
+    }
+  }
+  else if (hash_mode == 2100)
+  {
+    uint pos = 0;
+
+    snprintf (out_buf + pos, len-1, "%s%i#",
+      SIGNATURE_DCC2,
+      salt.salt_iter + 1);
+
+    uint signature_len = strlen (out_buf);
+
+    pos += signature_len;
+    len -= signature_len;
+
+    char *salt_ptr = (char *) salt.salt_buf;
+
+    for (uint i = 0; i < salt.salt_len; i++, pos++, len--) snprintf (out_buf + pos, len-1, "%c", salt_ptr[i]);
+
+    snprintf (out_buf + pos, len-1, "#%08x%08x%08x%08x",
+      byte_swap_32 (digest_buf[0]),
+      byte_swap_32 (digest_buf[1]),
+      byte_swap_32 (digest_buf[2]),
+      byte_swap_32 (digest_buf[3]));
+  }
+  else if ((hash_mode == 2400) || (hash_mode == 2410))
+  {
+    memcpy (tmp_buf, digest_buf, 16);
+
+    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+
+    out_buf[ 0] = int_to_itoa64 ((digest_buf[0] >>  0) & 0x3f);
+    out_buf[ 1] = int_to_itoa64 ((digest_buf[0] >>  6) & 0x3f);
+    out_buf[ 2] = int_to_itoa64 ((digest_buf[0] >> 12) & 0x3f);
+    out_buf[ 3] = int_to_itoa64 ((digest_buf[0] >> 18) & 0x3f);
+
+    out_buf[ 4] = int_to_itoa64 ((digest_buf[1] >>  0) & 0x3f);
+    out_buf[ 5] = int_to_itoa64 ((digest_buf[1] >>  6) & 0x3f);
+    out_buf[ 6] = int_to_itoa64 ((digest_buf[1] >> 12) & 0x3f);
+    out_buf[ 7] = int_to_itoa64 ((digest_buf[1] >> 18) & 0x3f);
+
+    out_buf[ 8] = int_to_itoa64 ((digest_buf[2] >>  0) & 0x3f);
+    out_buf[ 9] = int_to_itoa64 ((digest_buf[2] >>  6) & 0x3f);
+    out_buf[10] = int_to_itoa64 ((digest_buf[2] >> 12) & 0x3f);
+    out_buf[11] = int_to_itoa64 ((digest_buf[2] >> 18) & 0x3f);
+
+    out_buf[12] = int_to_itoa64 ((digest_buf[3] >>  0) & 0x3f);
+    out_buf[13] = int_to_itoa64 ((digest_buf[3] >>  6) & 0x3f);
+    out_buf[14] = int_to_itoa64 ((digest_buf[3] >> 12) & 0x3f);
+    out_buf[15] = int_to_itoa64 ((digest_buf[3] >> 18) & 0x3f);
+
+    out_buf[16] = 0;
+  }
+  else if (hash_mode == 2500)
+  {
+    wpa_t *wpas = (wpa_t *) data.esalts_buf;
 
-  char *digests_buf_ptr = (char *) data.digests_buf;
+    wpa_t *wpa = &wpas[salt_pos];
 
-  memcpy (digest_buf, digests_buf_ptr + (data.salts_buf[salt_pos].digests_offset * dgst_size) + (digest_pos * dgst_size), dgst_size);
+    snprintf (out_buf, len-1, "%s:%02x%02x%02x%02x%02x%02x:%02x%02x%02x%02x%02x%02x",
+      (char *) salt.salt_buf,
+      wpa->orig_mac1[0],
+      wpa->orig_mac1[1],
+      wpa->orig_mac1[2],
+      wpa->orig_mac1[3],
+      wpa->orig_mac1[4],
+      wpa->orig_mac1[5],
+      wpa->orig_mac2[0],
+      wpa->orig_mac2[1],
+      wpa->orig_mac2[2],
+      wpa->orig_mac2[3],
+      wpa->orig_mac2[4],
+      wpa->orig_mac2[5]);
+  }
+  else if (hash_mode == 4400)
+  {
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x",
+      byte_swap_32 (digest_buf[0]),
+      byte_swap_32 (digest_buf[1]),
+      byte_swap_32 (digest_buf[2]),
+      byte_swap_32 (digest_buf[3]));
+  }
+  else if (hash_mode == 4700)
+  {
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
+      byte_swap_32 (digest_buf[0]),
+      byte_swap_32 (digest_buf[1]),
+      byte_swap_32 (digest_buf[2]),
+      byte_swap_32 (digest_buf[3]),
+      byte_swap_32 (digest_buf[4]));
+  }
+  else if (hash_mode == 4800)
+  {
+    u8 chap_id_byte = (u8) salt.salt_buf[4];
 
-  if (opti_type & OPTI_TYPE_PRECOMPUTE_PERMUT)
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x:%08x%08x%08x%08x:%02x",
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      byte_swap_32 (salt.salt_buf[0]),
+      byte_swap_32 (salt.salt_buf[1]),
+      byte_swap_32 (salt.salt_buf[2]),
+      byte_swap_32 (salt.salt_buf[3]),
+      chap_id_byte);
+  }
+  else if (hash_mode == 4900)
   {
-    uint tt;
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
+      byte_swap_32 (digest_buf[0]),
+      byte_swap_32 (digest_buf[1]),
+      byte_swap_32 (digest_buf[2]),
+      byte_swap_32 (digest_buf[3]),
+      byte_swap_32 (digest_buf[4]));
+  }
+  else if (hash_mode == 5100)
+  {
+    snprintf (out_buf, len-1, "%08x%08x",
+      digest_buf[0],
+      digest_buf[1]);
+  }
+  else if (hash_mode == 5200)
+  {
+    snprintf (out_buf, len-1, "%s", hashfile);
+  }
+  else if (hash_mode == 5300)
+  {
+    ikepsk_t *ikepsks = (ikepsk_t *) data.esalts_buf;
 
-    switch (hash_type)
-    {
-      case HASH_TYPE_DESCRYPT:
-        FP (digest_buf[1], digest_buf[0], tt);
-        break;
+    ikepsk_t *ikepsk  = &ikepsks[salt_pos];
 
-      case HASH_TYPE_DESRACF:
-        digest_buf[0] = rotl32 (digest_buf[0], 29);
-        digest_buf[1] = rotl32 (digest_buf[1], 29);
+    int buf_len = len -1;
 
-        FP (digest_buf[1], digest_buf[0], tt);
-        break;
+    // msg_buf
 
-      case HASH_TYPE_LM:
-        FP (digest_buf[1], digest_buf[0], tt);
-        break;
+    uint ikepsk_msg_len = ikepsk->msg_len / 4;
 
-      case HASH_TYPE_NETNTLM:
-        digest_buf[0] = rotl32 (digest_buf[0], 29);
-        digest_buf[1] = rotl32 (digest_buf[1], 29);
-        digest_buf[2] = rotl32 (digest_buf[2], 29);
-        digest_buf[3] = rotl32 (digest_buf[3], 29);
+    for (uint i = 0; i < ikepsk_msg_len; i++)
+    {
+      if ((i == 32) || (i == 64) || (i == 66) || (i == 68) || (i == 108))
+      {
+        snprintf (out_buf, buf_len, ":");
 
-        FP (digest_buf[1], digest_buf[0], tt);
-        FP (digest_buf[3], digest_buf[2], tt);
-        break;
+        buf_len--;
+        out_buf++;
+      }
 
-      case HASH_TYPE_BSDICRYPT:
-        digest_buf[0] = rotl32 (digest_buf[0], 31);
-        digest_buf[1] = rotl32 (digest_buf[1], 31);
+      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->msg_buf[i]));
 
-        FP (digest_buf[1], digest_buf[0], tt);
-        break;
+      buf_len -= 8;
+      out_buf += 8;
     }
-  }
 
-  if (opti_type & OPTI_TYPE_PRECOMPUTE_MERKLE)
-  {
-    switch (hash_type)
-    {
-      case HASH_TYPE_MD4:
-        digest_buf[0] += MD4M_A;
-        digest_buf[1] += MD4M_B;
-        digest_buf[2] += MD4M_C;
-        digest_buf[3] += MD4M_D;
-        break;
+    // nr_buf
 
-      case HASH_TYPE_MD5:
-        digest_buf[0] += MD5M_A;
-        digest_buf[1] += MD5M_B;
-        digest_buf[2] += MD5M_C;
-        digest_buf[3] += MD5M_D;
-        break;
+    uint ikepsk_nr_len = ikepsk->nr_len / 4;
 
-      case HASH_TYPE_SHA1:
-        digest_buf[0] += SHA1M_A;
-        digest_buf[1] += SHA1M_B;
-        digest_buf[2] += SHA1M_C;
-        digest_buf[3] += SHA1M_D;
-        digest_buf[4] += SHA1M_E;
-        break;
+    for (uint i = 0; i < ikepsk_nr_len; i++)
+    {
+      if ((i == 0) || (i == 5))
+      {
+        snprintf (out_buf, buf_len, ":");
 
-      case HASH_TYPE_SHA256:
-        digest_buf[0] += SHA256M_A;
-        digest_buf[1] += SHA256M_B;
-        digest_buf[2] += SHA256M_C;
-        digest_buf[3] += SHA256M_D;
-        digest_buf[4] += SHA256M_E;
-        digest_buf[5] += SHA256M_F;
-        digest_buf[6] += SHA256M_G;
-        digest_buf[7] += SHA256M_H;
-        break;
+        buf_len--;
+        out_buf++;
+      }
 
-      case HASH_TYPE_SHA384:
-        digest_buf64[0] += SHA384M_A;
-        digest_buf64[1] += SHA384M_B;
-        digest_buf64[2] += SHA384M_C;
-        digest_buf64[3] += SHA384M_D;
-        digest_buf64[4] += SHA384M_E;
-        digest_buf64[5] += SHA384M_F;
-        digest_buf64[6] += 0;
-        digest_buf64[7] += 0;
-        break;
+      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->nr_buf[i]));
 
-      case HASH_TYPE_SHA512:
-        digest_buf64[0] += SHA512M_A;
-        digest_buf64[1] += SHA512M_B;
-        digest_buf64[2] += SHA512M_C;
-        digest_buf64[3] += SHA512M_D;
-        digest_buf64[4] += SHA512M_E;
-        digest_buf64[5] += SHA512M_F;
-        digest_buf64[6] += SHA512M_G;
-        digest_buf64[7] += SHA512M_H;
-        break;
+      buf_len -= 8;
+      out_buf += 8;
     }
-  }
 
-  if (opts_type & OPTS_TYPE_PT_GENERATE_LE)
-  {
-    if (dgst_size == DGST_SIZE_4_2)
-    {
-      for (int i = 0; i < 2; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-    }
-    else if (dgst_size == DGST_SIZE_4_4)
-    {
-      for (int i = 0; i < 4; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-    }
-    else if (dgst_size == DGST_SIZE_4_5)
-    {
-      for (int i = 0; i < 5; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-    }
-    else if (dgst_size == DGST_SIZE_4_6)
-    {
-      for (int i = 0; i < 6; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-    }
-    else if (dgst_size == DGST_SIZE_4_8)
-    {
-      for (int i = 0; i < 8; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-    }
-    else if ((dgst_size == DGST_SIZE_4_16) || (dgst_size == DGST_SIZE_8_8)) // same size, same result :)
+    // digest_buf
+
+    for (uint i = 0; i < 4; i++)
     {
-      if (hash_type == HASH_TYPE_WHIRLPOOL)
-      {
-        for (int i = 0; i < 16; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-      }
-      else if (hash_type == HASH_TYPE_SHA384)
-      {
-        for (int i = 0; i < 8; i++) digest_buf64[i] = byte_swap_64 (digest_buf64[i]);
-      }
-      else if (hash_type == HASH_TYPE_SHA512)
-      {
-        for (int i = 0; i < 8; i++) digest_buf64[i] = byte_swap_64 (digest_buf64[i]);
-      }
-      else if (hash_type == HASH_TYPE_GOST)
+      if (i == 0)
       {
-        for (int i = 0; i < 16; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-      }
-    }
-    else if (dgst_size == DGST_SIZE_4_64)
-    {
-      for (int i = 0; i < 64; i++) digest_buf[i] = byte_swap_32 (digest_buf[i]);
-    }
-    else if (dgst_size == DGST_SIZE_8_25)
-    {
-      for (int i = 0; i < 25; i++) digest_buf64[i] = byte_swap_64 (digest_buf64[i]);
-    }
-  }
+        snprintf (out_buf, buf_len, ":");
 
-  uint isSalted = ((data.salt_type == SALT_TYPE_INTERN)
-                |  (data.salt_type == SALT_TYPE_EXTERN)
-                |  (data.salt_type == SALT_TYPE_EMBEDDED));
+        buf_len--;
+        out_buf++;
+      }
 
-  salt_t salt;
+      snprintf (out_buf, buf_len, "%08x", digest_buf[i]);
 
-  if (isSalted)
+      buf_len -= 8;
+      out_buf += 8;
+    }
+  }
+  else if (hash_mode == 5400)
   {
-    memset (&salt, 0, sizeof (salt_t));
+    ikepsk_t *ikepsks = (ikepsk_t *) data.esalts_buf;
+
+    ikepsk_t *ikepsk  = &ikepsks[salt_pos];
 
-    memcpy (&salt, &data.salts_buf[salt_pos], sizeof (salt_t));
+    int buf_len = len -1;
 
-    char *ptr = (char *) salt.salt_buf;
+    // msg_buf
 
-    uint len = salt.salt_len;
+    uint ikepsk_msg_len = ikepsk->msg_len / 4;
 
-    if (opti_type & OPTI_TYPE_PRECOMPUTE_PERMUT)
+    for (uint i = 0; i < ikepsk_msg_len; i++)
     {
-      uint tt;
-
-      switch (hash_type)
+      if ((i == 32) || (i == 64) || (i == 66) || (i == 68) || (i == 108))
       {
-        case HASH_TYPE_NETNTLM:
+        snprintf (out_buf, buf_len, ":");
 
-          salt.salt_buf[0] = rotr32 (salt.salt_buf[0], 3);
-          salt.salt_buf[1] = rotr32 (salt.salt_buf[1], 3);
+        buf_len--;
+        out_buf++;
+      }
 
-          FP (salt.salt_buf[1], salt.salt_buf[0], tt);
+      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->msg_buf[i]));
 
-          break;
-      }
+      buf_len -= 8;
+      out_buf += 8;
     }
 
-    if (opts_type & OPTS_TYPE_ST_UNICODE)
+    // nr_buf
+
+    uint ikepsk_nr_len = ikepsk->nr_len / 4;
+
+    for (uint i = 0; i < ikepsk_nr_len; i++)
     {
-      for (uint i = 0, j = 0; i < len; i += 1, j += 2)
+      if ((i == 0) || (i == 5))
       {
-        ptr[i] = ptr[j];
+        snprintf (out_buf, buf_len, ":");
+
+        buf_len--;
+        out_buf++;
       }
 
-      len = len / 2;
-    }
+      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->nr_buf[i]));
 
-    if (opts_type & OPTS_TYPE_ST_GENERATE_LE)
-    {
-      uint max = salt.salt_len / 4;
+      buf_len -= 8;
+      out_buf += 8;
+    }
 
-      if (len % 4) max++;
+    // digest_buf
 
-      for (uint i = 0; i < max; i++)
+    for (uint i = 0; i < 5; i++)
+    {
+      if (i == 0)
       {
-        salt.salt_buf[i] = byte_swap_32 (salt.salt_buf[i]);
+        snprintf (out_buf, buf_len, ":");
+
+        buf_len--;
+        out_buf++;
       }
+
+      snprintf (out_buf, buf_len, "%08x", digest_buf[i]);
+
+      buf_len -= 8;
+      out_buf += 8;
     }
+  }
+  else if (hash_mode == 5500)
+  {
+    netntlm_t *netntlms = (netntlm_t *) data.esalts_buf;
 
-    if (opts_type & OPTS_TYPE_ST_HEX)
+    netntlm_t *netntlm = &netntlms[salt_pos];
+
+    char user_buf[64] = { 0 };
+    char domain_buf[64] = { 0 };
+    char srvchall_buf[1024] = { 0 };
+    char clichall_buf[1024] = { 0 };
+
+    for (uint i = 0, j = 0; j < netntlm->user_len; i += 1, j += 2)
     {
-      char tmp[64] = { 0 };
+      char *ptr = (char *) netntlm->userdomain_buf;
 
-      for (uint i = 0, j = 0; i < len; i += 1, j += 2)
-      {
-        sprintf (tmp + j, "%02x", (unsigned char) ptr[i]);
-      }
+      user_buf[i] = ptr[j];
+    }
 
-      len = len * 2;
+    for (uint i = 0, j = 0; j < netntlm->domain_len; i += 1, j += 2)
+    {
+      char *ptr = (char *) netntlm->userdomain_buf;
 
-      memcpy (ptr, tmp, len);
+      domain_buf[i] = ptr[netntlm->user_len + j];
     }
 
-    uint memset_size = ((48 - (int) len) > 0) ? (48 - len) : 0;
+    for (uint i = 0, j = 0; i < netntlm->srvchall_len; i += 1, j += 2)
+    {
+      u8 *ptr = (u8 *) netntlm->chall_buf;
 
-    memset (ptr + len, 0, memset_size);
+      sprintf (srvchall_buf + j, "%02x", ptr[i]);
+    }
 
-    salt.salt_len = len;
-  }
+    for (uint i = 0, j = 0; i < netntlm->clichall_len; i += 1, j += 2)
+    {
+      u8 *ptr = (u8 *) netntlm->chall_buf;
 
-  //
-  // some modes require special encoding
-  //
+      sprintf (clichall_buf + j, "%02x", ptr[netntlm->srvchall_len + i]);
+    }
 
-  uint out_buf_plain[256] = { 0 };
-  uint out_buf_salt[256] = { 0 };
+    snprintf (out_buf, len-1, "%s::%s:%s:%08x%08x%08x%08x%08x%08x:%s",
+      user_buf,
+      domain_buf,
+      srvchall_buf,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      byte_swap_32 (salt.salt_buf_pc[0]),
+      byte_swap_32 (salt.salt_buf_pc[1]),
+      clichall_buf);
+  }
+  else if (hash_mode == 5600)
+  {
+    netntlm_t *netntlms = (netntlm_t *) data.esalts_buf;
 
-  char tmp_buf[1024] = { 0 };
+    netntlm_t *netntlm = &netntlms[salt_pos];
 
-  char *ptr_plain = (char *) out_buf_plain;
-  char *ptr_salt  = (char *) out_buf_salt;
+    char user_buf[64] = { 0 };
+    char domain_buf[64] = { 0 };
+    char srvchall_buf[1024] = { 0 };
+    char clichall_buf[1024] = { 0 };
 
-  if (hash_mode == 22)
-  {
-    char username[30] = { 0 };
+    for (uint i = 0, j = 0; j < netntlm->user_len; i += 1, j += 2)
+    {
+      char *ptr = (char *) netntlm->userdomain_buf;
 
-    memcpy (username, salt.salt_buf, salt.salt_len - 22);
+      user_buf[i] = ptr[j];
+    }
 
-    char sig[6] = { 'n', 'r', 'c', 's', 't', 'n' };
+    for (uint i = 0, j = 0; j < netntlm->domain_len; i += 1, j += 2)
+    {
+      char *ptr = (char *) netntlm->userdomain_buf;
 
-    u16 *ptr = (u16 *) digest_buf;
+      domain_buf[i] = ptr[netntlm->user_len + j];
+    }
 
-    tmp_buf[ 0] = sig[0];
-    tmp_buf[ 1] = int_to_base64 (((ptr[1]) >> 12) & 0x3f);
-    tmp_buf[ 2] = int_to_base64 (((ptr[1]) >>  6) & 0x3f);
-    tmp_buf[ 3] = int_to_base64 (((ptr[1]) >>  0) & 0x3f);
-    tmp_buf[ 4] = int_to_base64 (((ptr[0]) >> 12) & 0x3f);
-    tmp_buf[ 5] = int_to_base64 (((ptr[0]) >>  6) & 0x3f);
-    tmp_buf[ 6] = sig[1];
-    tmp_buf[ 7] = int_to_base64 (((ptr[0]) >>  0) & 0x3f);
-    tmp_buf[ 8] = int_to_base64 (((ptr[3]) >> 12) & 0x3f);
-    tmp_buf[ 9] = int_to_base64 (((ptr[3]) >>  6) & 0x3f);
-    tmp_buf[10] = int_to_base64 (((ptr[3]) >>  0) & 0x3f);
-    tmp_buf[11] = int_to_base64 (((ptr[2]) >> 12) & 0x3f);
-    tmp_buf[12] = sig[2];
-    tmp_buf[13] = int_to_base64 (((ptr[2]) >>  6) & 0x3f);
-    tmp_buf[14] = int_to_base64 (((ptr[2]) >>  0) & 0x3f);
-    tmp_buf[15] = int_to_base64 (((ptr[5]) >> 12) & 0x3f);
-    tmp_buf[16] = int_to_base64 (((ptr[5]) >>  6) & 0x3f);
-    tmp_buf[17] = sig[3];
-    tmp_buf[18] = int_to_base64 (((ptr[5]) >>  0) & 0x3f);
-    tmp_buf[19] = int_to_base64 (((ptr[4]) >> 12) & 0x3f);
-    tmp_buf[20] = int_to_base64 (((ptr[4]) >>  6) & 0x3f);
-    tmp_buf[21] = int_to_base64 (((ptr[4]) >>  0) & 0x3f);
-    tmp_buf[22] = int_to_base64 (((ptr[7]) >> 12) & 0x3f);
-    tmp_buf[23] = sig[4];
-    tmp_buf[24] = int_to_base64 (((ptr[7]) >>  6) & 0x3f);
-    tmp_buf[25] = int_to_base64 (((ptr[7]) >>  0) & 0x3f);
-    tmp_buf[26] = int_to_base64 (((ptr[6]) >> 12) & 0x3f);
-    tmp_buf[27] = int_to_base64 (((ptr[6]) >>  6) & 0x3f);
-    tmp_buf[28] = int_to_base64 (((ptr[6]) >>  0) & 0x3f);
-    tmp_buf[29] = sig[5];
+    for (uint i = 0, j = 0; i < netntlm->srvchall_len; i += 1, j += 2)
+    {
+      u8 *ptr = (u8 *) netntlm->chall_buf;
 
-    snprintf (out_buf, len-1, "%s:%s",
-      tmp_buf,
-      username);
-  }
-  else if (hash_mode == 23)
-  {
-    // do not show the skyper part in output
+      sprintf (srvchall_buf + j, "%02x", ptr[i]);
+    }
 
-    char *salt_buf_ptr = (char *) salt.salt_buf;
+    for (uint i = 0, j = 0; i < netntlm->clichall_len; i += 1, j += 2)
+    {
+      u8 *ptr = (u8 *) netntlm->chall_buf;
 
-    salt_buf_ptr[salt.salt_len - 8] = 0;
+      sprintf (clichall_buf + j, "%02x", ptr[netntlm->srvchall_len + i]);
+    }
 
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x:%s",
+    snprintf (out_buf, len-1, "%s::%s:%s:%08x%08x%08x%08x:%s",
+      user_buf,
+      domain_buf,
+      srvchall_buf,
       digest_buf[0],
       digest_buf[1],
       digest_buf[2],
       digest_buf[3],
-      salt_buf_ptr);
+      clichall_buf);
   }
-  else if (hash_mode == 101)
+  else if (hash_mode == 5700)
   {
     // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
 
@@ -6504,72 +8870,38 @@ void ascii_digest (char *out_buf, uint salt_pos, uint digest_pos)
     digest_buf[2] = byte_swap_32 (digest_buf[2]);
     digest_buf[3] = byte_swap_32 (digest_buf[3]);
     digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    digest_buf[5] = byte_swap_32 (digest_buf[5]);
+    digest_buf[6] = byte_swap_32 (digest_buf[6]);
+    digest_buf[7] = byte_swap_32 (digest_buf[7]);
 
-    memcpy (tmp_buf, digest_buf, 20);
+    memcpy (tmp_buf, digest_buf, 32);
 
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20, (u8 *) ptr_plain);
+    base64_encode (int_to_itoa64, (const u8 *) tmp_buf, 32, (u8 *) ptr_plain);
 
-    snprintf (out_buf, len-1, "{SHA}%s", ptr_plain);
+    ptr_plain[43] = 0;
+
+    snprintf (out_buf, len-1, "%s", ptr_plain);
   }
-  else if (hash_mode == 111)
+  else if (hash_mode == 5800)
   {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
-
     digest_buf[0] = byte_swap_32 (digest_buf[0]);
     digest_buf[1] = byte_swap_32 (digest_buf[1]);
     digest_buf[2] = byte_swap_32 (digest_buf[2]);
     digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
-
-    memcpy (tmp_buf, digest_buf, 20);
-    memcpy (tmp_buf + 20, salt.salt_buf, salt.salt_len);
-
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20 + salt.salt_len, (u8 *) ptr_plain);
-
-    snprintf (out_buf, len-1, "{SSHA}%s", ptr_plain);
-  }
-  else if ((hash_mode == 122) || (hash_mode == 125))
-  {
-    snprintf (out_buf, len-1, "%s%08x%08x%08x%08x%08x",
-      (char *) salt.salt_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4]);
-  }
-  else if (hash_mode == 124)
-  {
-    snprintf (out_buf, len-1, "sha1$%s$%08x%08x%08x%08x%08x",
-      (char *) salt.salt_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4]);
-  }
-  else if (hash_mode == 131)
-  {
-    snprintf (out_buf, len-1, "0x0100%s%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-      (char *) salt.salt_buf,
-      0, 0, 0, 0, 0,
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
       digest_buf[0],
       digest_buf[1],
       digest_buf[2],
       digest_buf[3],
       digest_buf[4]);
   }
-  else if (hash_mode == 132)
+  else if ((hash_mode >= 6200) && (hash_mode <= 6299))
   {
-    snprintf (out_buf, len-1, "0x0100%s%08x%08x%08x%08x%08x",
-      (char *) salt.salt_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4]);
+    snprintf (out_buf, len-1, "%s", hashfile);
   }
-  else if (hash_mode == 133)
+  else if (hash_mode == 6300)
   {
     // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
 
@@ -6577,108 +8909,140 @@ void ascii_digest (char *out_buf, uint salt_pos, uint digest_pos)
     digest_buf[1] = byte_swap_32 (digest_buf[1]);
     digest_buf[2] = byte_swap_32 (digest_buf[2]);
     digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
 
-    memcpy (tmp_buf, digest_buf, 20);
+    md5crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
 
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20, (u8 *) ptr_plain);
+    snprintf (out_buf, len-1, "{smd5}%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
+  }
+  else if (hash_mode == 6400)
+  {
+    sha256aix_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
 
-    snprintf (out_buf, len-1, "%s", ptr_plain);
+    snprintf (out_buf, len-1, "{ssha256}%02d$%s$%s", salt.salt_sign[0], (char *) salt.salt_buf, (char *) ptr_plain);
   }
-  else if (hash_mode == 141)
+  else if (hash_mode == 6500)
   {
-    memcpy (tmp_buf, salt.salt_buf, salt.salt_len);
+    sha512aix_encode ((unsigned char *) digest_buf64, (unsigned char *) ptr_plain);
 
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, salt.salt_len, (u8 *) ptr_salt);
+    snprintf (out_buf, len-1, "{ssha512}%02d$%s$%s", salt.salt_sign[0], (char *) salt.salt_buf, (char *) ptr_plain);
+  }
+  else if (hash_mode == 6600)
+  {
+    agilekey_t *agilekeys = (agilekey_t *) data.esalts_buf;
 
-    memset (tmp_buf, 0, sizeof (tmp_buf));
+    agilekey_t *agilekey = &agilekeys[salt_pos];
 
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    salt.salt_buf[0] = byte_swap_32 (salt.salt_buf[0]);
+    salt.salt_buf[1] = byte_swap_32 (salt.salt_buf[1]);
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    uint buf_len = len - 1;
 
-    memcpy (tmp_buf, digest_buf, 20);
+    uint off = snprintf (out_buf, buf_len, "%d:%08x%08x:", salt.salt_iter + 1, salt.salt_buf[0], salt.salt_buf[1]);
+    buf_len -= 22;
 
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, 20, (u8 *) ptr_plain);
+    for (uint i = 0, j = off; i < 1040; i++, j += 2)
+    {
+      snprintf (out_buf + j, buf_len, "%02x", agilekey->cipher[i]);
 
-    ptr_plain[27] = 0;
+      buf_len -= 2;
+    }
+  }
+  else if (hash_mode == 6700)
+  {
+    sha1aix_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
 
-    snprintf (out_buf, len-1, "%s%s*%s", SIGNATURE_EPISERVER, ptr_salt, ptr_plain);
+    snprintf (out_buf, len-1, "{ssha1}%02d$%s$%s", salt.salt_sign[0], (char *) salt.salt_buf, (char *) ptr_plain);
   }
-  else if (hash_mode == 400)
+  else if (hash_mode == 6800)
   {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    snprintf (out_buf, len-1, "%s", (char *) salt.salt_buf);
+  }
+  else if (hash_mode == 7100)
+  {
+    uint *ptr = digest_buf;
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    pbkdf2_sha512_t *pbkdf2_sha512s = (pbkdf2_sha512_t *) data.esalts_buf;
 
-    phpass_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+    pbkdf2_sha512_t *pbkdf2_sha512  = &pbkdf2_sha512s[salt_pos];
 
-    snprintf (out_buf, len-1, "%s%s%s", (char *) salt.salt_sign, (char *) salt.salt_buf, (char *) ptr_plain);
+    uint esalt[8] = { 0 };
+
+    esalt[0] = byte_swap_32 (pbkdf2_sha512->salt_buf[0]);
+    esalt[1] = byte_swap_32 (pbkdf2_sha512->salt_buf[1]);
+    esalt[2] = byte_swap_32 (pbkdf2_sha512->salt_buf[2]);
+    esalt[3] = byte_swap_32 (pbkdf2_sha512->salt_buf[3]);
+    esalt[4] = byte_swap_32 (pbkdf2_sha512->salt_buf[4]);
+    esalt[5] = byte_swap_32 (pbkdf2_sha512->salt_buf[5]);
+    esalt[6] = byte_swap_32 (pbkdf2_sha512->salt_buf[6]);
+    esalt[7] = byte_swap_32 (pbkdf2_sha512->salt_buf[7]);
+
+    snprintf (out_buf, len-1, "%s%i$%08x%08x%08x%08x%08x%08x%08x%08x$%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+      SIGNATURE_SHA512OSX,
+      salt.salt_iter + 1,
+      esalt[ 0], esalt[ 1],
+      esalt[ 2], esalt[ 3],
+      esalt[ 4], esalt[ 5],
+      esalt[ 6], esalt[ 7],
+      ptr  [ 1], ptr  [ 0],
+      ptr  [ 3], ptr  [ 2],
+      ptr  [ 5], ptr  [ 4],
+      ptr  [ 7], ptr  [ 6],
+      ptr  [ 9], ptr  [ 8],
+      ptr  [11], ptr  [10],
+      ptr  [13], ptr  [12],
+      ptr  [15], ptr  [14]);
   }
-  else if (hash_mode == 500)
+  else if (hash_mode == 7200)
   {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    uint *ptr = digest_buf;
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    pbkdf2_sha512_t *pbkdf2_sha512s = (pbkdf2_sha512_t *) data.esalts_buf;
 
-    md5crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+    pbkdf2_sha512_t *pbkdf2_sha512  = &pbkdf2_sha512s[salt_pos];
 
-    if (salt.salt_iter == ROUNDS_MD5CRYPT)
-    {
-      snprintf (out_buf, len-1, "$1$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
-    }
-    else
+    uint len_used = 0;
+
+    snprintf (out_buf + len_used, len - len_used - 1, "%s%i.", SIGNATURE_SHA512GRUB, salt.salt_iter + 1);
+
+    len_used = strlen (out_buf);
+
+    unsigned char *salt_buf_ptr = (unsigned char *) pbkdf2_sha512->salt_buf;
+
+    for (uint i = 0; i < salt.salt_len; i++, len_used += 2)
     {
-      snprintf (out_buf, len-1, "$1$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
+      snprintf (out_buf + len_used, len - len_used - 1, "%02x", salt_buf_ptr[i]);
     }
+
+    snprintf (out_buf + len_used, len - len_used - 1, ".%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+      ptr  [ 1], ptr  [ 0],
+      ptr  [ 3], ptr  [ 2],
+      ptr  [ 5], ptr  [ 4],
+      ptr  [ 7], ptr  [ 6],
+      ptr  [ 9], ptr  [ 8],
+      ptr  [11], ptr  [10],
+      ptr  [13], ptr  [12],
+      ptr  [15], ptr  [14]);
   }
-  else if (hash_mode == 501)
+  else if (hash_mode == 7300)
   {
-    uint digest_idx = salt.digests_offset + digest_pos;
+    rakp_t *rakps = (rakp_t *) data.esalts_buf;
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+    rakp_t *rakp = &rakps[salt_pos];
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
-  }
-  else if (hash_mode == 1421)
-  {
-    u8 *salt_ptr = (u8 *) salt.salt_buf;
+    for (uint i = 0, j = 0; (i * 4) < rakp->salt_len; i += 1, j += 8)
+    {
+      sprintf (out_buf + j, "%08x", rakp->salt_buf[i]);
+    }
 
-    snprintf (out_buf, len-1, "%c%c%c%c%c%c%08x%08x%08x%08x%08x%08x%08x%08x",
-      salt_ptr[0],
-      salt_ptr[1],
-      salt_ptr[2],
-      salt_ptr[3],
-      salt_ptr[4],
-      salt_ptr[5],
+    snprintf (out_buf + rakp->salt_len * 2, len - 1, ":%08x%08x%08x%08x%08x",
       digest_buf[0],
       digest_buf[1],
       digest_buf[2],
       digest_buf[3],
-      digest_buf[4],
-      digest_buf[5],
-      digest_buf[6],
-      digest_buf[7]);
+      digest_buf[4]);
   }
-  else if (hash_mode == 1441)
+  else if (hash_mode == 7400)
   {
-    memcpy (tmp_buf, salt.salt_buf, salt.salt_len);
-
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, salt.salt_len, (u8 *) ptr_salt);
-
-    memset (tmp_buf, 0, sizeof (tmp_buf));
-
     // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
 
     digest_buf[0] = byte_swap_32 (digest_buf[0]);
@@ -6690,494 +9054,563 @@ void ascii_digest (char *out_buf, uint salt_pos, uint digest_pos)
     digest_buf[6] = byte_swap_32 (digest_buf[6]);
     digest_buf[7] = byte_swap_32 (digest_buf[7]);
 
-    memcpy (tmp_buf, digest_buf, 32);
-
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, 32, (u8 *) ptr_plain);
-
-    ptr_plain[43] = 0;
+    sha256crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
 
-    snprintf (out_buf, len-1, "%s%s*%s", SIGNATURE_EPISERVER4, ptr_salt, ptr_plain);
+    if (salt.salt_iter == ROUNDS_SHA256CRYPT)
+    {
+      snprintf (out_buf, len-1, "$5$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
+    }
+    else
+    {
+      snprintf (out_buf, len-1, "$5$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
+    }
   }
-  else if (hash_mode == 1500)
+  else if (hash_mode == 7500)
   {
-    out_buf[0] = salt.salt_sign[0] & 0xff;
-    out_buf[1] = salt.salt_sign[1] & 0xff;
-    //original method, but changed because of this ticket: https://hashcat.net/trac/ticket/269
-    //out_buf[0] = int_to_itoa64 ((salt.salt_buf[0] >> 0) & 0x3f);
-    //out_buf[1] = int_to_itoa64 ((salt.salt_buf[0] >> 6) & 0x3f);
-
-    memset (tmp_buf, 0, sizeof (tmp_buf));
-
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
-
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-
-    memcpy (tmp_buf, digest_buf, 8);
-
-    base64_encode (int_to_itoa64, (const u8 *) tmp_buf, 8, (u8 *) ptr_plain);
+    krb5pa_t *krb5pas = (krb5pa_t *) data.esalts_buf;
 
-    snprintf (out_buf + 2, len-1-2, "%s", ptr_plain);
+    krb5pa_t *krb5pa = &krb5pas[salt_pos];
 
-    out_buf[13] = 0;
-  }
-  else if (hash_mode == 1600)
-  {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    u8 *ptr_timestamp = (u8 *) krb5pa->timestamp;
+    u8 *ptr_checksum  = (u8 *) krb5pa->checksum;
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    char data[128] = { 0 };
 
-    md5crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+    char *ptr_data = data;
 
-    if (salt.salt_iter == ROUNDS_MD5CRYPT)
+    for (uint i = 0; i < 36; i++, ptr_data += 2)
     {
-      snprintf (out_buf, len-1, "$apr1$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
+      sprintf (ptr_data, "%02x", ptr_timestamp[i]);
     }
-    else
+
+    for (uint i = 0; i < 16; i++, ptr_data += 2)
     {
-      snprintf (out_buf, len-1, "$apr1$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
+      sprintf (ptr_data, "%02x", ptr_checksum[i]);
     }
+
+    *ptr_data = 0;
+
+    snprintf (out_buf, len-1, "%s$%s$%s$%s$%s",
+      SIGNATURE_KRB5PA,
+      (char *) krb5pa->user,
+      (char *) krb5pa->realm,
+      (char *) krb5pa->salt,
+      data);
+  }
+  else if (hash_mode == 7700)
+  {
+    snprintf (out_buf, len-1, "%s$%08X%08X",
+      (char *) salt.salt_buf,
+      digest_buf[0],
+      digest_buf[1]);
+  }
+  else if (hash_mode == 7800)
+  {
+    snprintf (out_buf, len-1, "%s$%08X%08X%08X%08X%08X",
+      (char *) salt.salt_buf,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4]);
   }
-  else if (hash_mode == 1711)
+  else if (hash_mode == 7900)
   {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    drupal7_encode ((unsigned char *) digest_buf64, (unsigned char *) ptr_plain);
 
-    digest_buf64[0] = byte_swap_64 (digest_buf64[0]);
-    digest_buf64[1] = byte_swap_64 (digest_buf64[1]);
-    digest_buf64[2] = byte_swap_64 (digest_buf64[2]);
-    digest_buf64[3] = byte_swap_64 (digest_buf64[3]);
-    digest_buf64[4] = byte_swap_64 (digest_buf64[4]);
-    digest_buf64[5] = byte_swap_64 (digest_buf64[5]);
-    digest_buf64[6] = byte_swap_64 (digest_buf64[6]);
-    digest_buf64[7] = byte_swap_64 (digest_buf64[7]);
+    // ugly hack start
 
-    memcpy (tmp_buf, digest_buf, 64);
-    memcpy (tmp_buf + 64, salt.salt_buf, salt.salt_len);
+    char *tmp = (char *) salt.salt_buf_pc;
 
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, 64 + salt.salt_len, (u8 *) ptr_plain);
+    ptr_plain[42] = tmp[0];
 
-    snprintf (out_buf, len-1, "%s%s", SIGNATURE_SHA512B64S, ptr_plain);
+    // ugly hack end
+
+    ptr_plain[43] = 0;
+
+    snprintf (out_buf, len-1, "%s%s%s", (char *) salt.salt_sign, (char *) salt.salt_buf, (char *) ptr_plain);
   }
-  else if (hash_mode == 1722)
+  else if (hash_mode == 8000)
   {
-    uint *ptr = digest_buf;
-
-    snprintf (out_buf, len-1, "%s%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+    snprintf (out_buf, len-1, "0xc007%s%08x%08x%08x%08x%08x%08x%08x%08x",
       (unsigned char *) salt.salt_buf,
-      ptr[ 1], ptr[ 0],
-      ptr[ 3], ptr[ 2],
-      ptr[ 5], ptr[ 4],
-      ptr[ 7], ptr[ 6],
-      ptr[ 9], ptr[ 8],
-      ptr[11], ptr[10],
-      ptr[13], ptr[12],
-      ptr[15], ptr[14]);
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4],
+      digest_buf[5],
+      digest_buf[6],
+      digest_buf[7]);
   }
-  else if (hash_mode == 1731)
+  else if (hash_mode == 8100)
   {
-    uint *ptr = digest_buf;
+    salt.salt_buf[0] = byte_swap_32 (salt.salt_buf[0]);
+    salt.salt_buf[1] = byte_swap_32 (salt.salt_buf[1]);
 
-    snprintf (out_buf, len-1, "0x0200%s%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+    snprintf (out_buf, len-1, "1%s%08x%08x%08x%08x%08x",
       (unsigned char *) salt.salt_buf,
-        ptr[ 1], ptr[ 0],
-        ptr[ 3], ptr[ 2],
-        ptr[ 5], ptr[ 4],
-        ptr[ 7], ptr[ 6],
-        ptr[ 9], ptr[ 8],
-        ptr[11], ptr[10],
-        ptr[13], ptr[12],
-        ptr[15], ptr[14]);
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4]);
   }
-  else if (hash_mode == 1800)
+  else if (hash_mode == 8200)
   {
-    // temp workaround
+    cloudkey_t *cloudkeys = (cloudkey_t *) data.esalts_buf;
 
-    digest_buf64[0] = byte_swap_64 (digest_buf64[0]);
-    digest_buf64[1] = byte_swap_64 (digest_buf64[1]);
-    digest_buf64[2] = byte_swap_64 (digest_buf64[2]);
-    digest_buf64[3] = byte_swap_64 (digest_buf64[3]);
-    digest_buf64[4] = byte_swap_64 (digest_buf64[4]);
-    digest_buf64[5] = byte_swap_64 (digest_buf64[5]);
-    digest_buf64[6] = byte_swap_64 (digest_buf64[6]);
-    digest_buf64[7] = byte_swap_64 (digest_buf64[7]);
+    cloudkey_t *cloudkey = &cloudkeys[salt_pos];
 
-    sha512crypt_encode ((unsigned char *) digest_buf64, (unsigned char *) ptr_plain);
+    char data_buf[4096] = { 0 };
 
-    if (salt.salt_iter == ROUNDS_SHA512CRYPT)
-    {
-      snprintf (out_buf, len-1, "$6$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
-    }
-    else
+    for (int i = 0, j = 0; i < 512; i += 1, j += 8)
     {
-      snprintf (out_buf, len-1, "$6$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
+      sprintf (data_buf + j, "%08x", cloudkey->data_buf[i]);
     }
-  }
-  else if (hash_mode == 2100)
-  {
-    uint pos = 0;
-
-    snprintf (out_buf + pos, len-1, "%s%i#",
-      SIGNATURE_DCC2,
-      salt.salt_iter + 1);
-
-    uint signature_len = strlen (out_buf);
 
-    pos += signature_len;
-    len -= signature_len;
+    data_buf[cloudkey->data_len * 2] = 0;
 
-    char *salt_ptr = (char *) salt.salt_buf;
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    digest_buf[5] = byte_swap_32 (digest_buf[5]);
+    digest_buf[6] = byte_swap_32 (digest_buf[6]);
+    digest_buf[7] = byte_swap_32 (digest_buf[7]);
 
-    for (uint i = 0; i < salt.salt_len; i++, pos++, len--) snprintf (out_buf + pos, len-1, "%c", salt_ptr[i]);
+    salt.salt_buf[0] = byte_swap_32 (salt.salt_buf[0]);
+    salt.salt_buf[1] = byte_swap_32 (salt.salt_buf[1]);
+    salt.salt_buf[2] = byte_swap_32 (salt.salt_buf[2]);
+    salt.salt_buf[3] = byte_swap_32 (salt.salt_buf[3]);
 
-    snprintf (out_buf + pos, len-1, "#%08x%08x%08x%08x",
-      byte_swap_32 (digest_buf[0]),
-      byte_swap_32 (digest_buf[1]),
-      byte_swap_32 (digest_buf[2]),
-      byte_swap_32 (digest_buf[3]));
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x:%08x%08x%08x%08x:%u:%s",
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4],
+      digest_buf[5],
+      digest_buf[6],
+      digest_buf[7],
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      salt.salt_iter + 1,
+      data_buf);
   }
-  else if ((hash_mode == 2400) || (hash_mode == 2410))
+  else if (hash_mode == 8300)
   {
-    memcpy (tmp_buf, digest_buf, 16);
-
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    char digest_buf_c[34] = { 0 };
 
     digest_buf[0] = byte_swap_32 (digest_buf[0]);
     digest_buf[1] = byte_swap_32 (digest_buf[1]);
     digest_buf[2] = byte_swap_32 (digest_buf[2]);
     digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
 
-    out_buf[ 0] = int_to_itoa64 ((digest_buf[0] >>  0) & 0x3f);
-    out_buf[ 1] = int_to_itoa64 ((digest_buf[0] >>  6) & 0x3f);
-    out_buf[ 2] = int_to_itoa64 ((digest_buf[0] >> 12) & 0x3f);
-    out_buf[ 3] = int_to_itoa64 ((digest_buf[0] >> 18) & 0x3f);
+    base32_encode (int_to_itoa32, (const u8 *) digest_buf, 20, (u8 *) digest_buf_c);
 
-    out_buf[ 4] = int_to_itoa64 ((digest_buf[1] >>  0) & 0x3f);
-    out_buf[ 5] = int_to_itoa64 ((digest_buf[1] >>  6) & 0x3f);
-    out_buf[ 6] = int_to_itoa64 ((digest_buf[1] >> 12) & 0x3f);
-    out_buf[ 7] = int_to_itoa64 ((digest_buf[1] >> 18) & 0x3f);
+    digest_buf_c[32] = 0;
 
-    out_buf[ 8] = int_to_itoa64 ((digest_buf[2] >>  0) & 0x3f);
-    out_buf[ 9] = int_to_itoa64 ((digest_buf[2] >>  6) & 0x3f);
-    out_buf[10] = int_to_itoa64 ((digest_buf[2] >> 12) & 0x3f);
-    out_buf[11] = int_to_itoa64 ((digest_buf[2] >> 18) & 0x3f);
+    // domain
 
-    out_buf[12] = int_to_itoa64 ((digest_buf[3] >>  0) & 0x3f);
-    out_buf[13] = int_to_itoa64 ((digest_buf[3] >>  6) & 0x3f);
-    out_buf[14] = int_to_itoa64 ((digest_buf[3] >> 12) & 0x3f);
-    out_buf[15] = int_to_itoa64 ((digest_buf[3] >> 18) & 0x3f);
+    const uint salt_pc_len = salt.salt_buf_pc[7]; // what a hack
 
-    out_buf[16] = 0;
-  }
-  else if (hash_mode == 2500)
-  {
-    wpa_t *wpas = (wpa_t *) data.esalts_buf;
+    char domain_buf_c[33] = { 0 };
 
-    wpa_t *wpa = &wpas[salt_pos];
+    memcpy (domain_buf_c, (char *) salt.salt_buf_pc, salt_pc_len);
 
-    snprintf (out_buf, len-1, "%s:%02x%02x%02x%02x%02x%02x:%02x%02x%02x%02x%02x%02x",
-      (char *) salt.salt_buf,
-      wpa->orig_mac1[0],
-      wpa->orig_mac1[1],
-      wpa->orig_mac1[2],
-      wpa->orig_mac1[3],
-      wpa->orig_mac1[4],
-      wpa->orig_mac1[5],
-      wpa->orig_mac2[0],
-      wpa->orig_mac2[1],
-      wpa->orig_mac2[2],
-      wpa->orig_mac2[3],
-      wpa->orig_mac2[4],
-      wpa->orig_mac2[5]);
+    for (uint i = 0; i < salt_pc_len; i++)
+    {
+      const char next = domain_buf_c[i];
+
+      domain_buf_c[i] = '.';
+
+      i += next;
+    }
+
+    domain_buf_c[salt_pc_len] = 0;
+
+    // final
+
+    snprintf (out_buf, len-1, "%s:%s:%s:%u", digest_buf_c, domain_buf_c, (char *) salt.salt_buf, salt.salt_iter);
   }
-  else if (hash_mode == 4400)
+  else if (hash_mode == 8500)
   {
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x",
-      byte_swap_32 (digest_buf[0]),
-      byte_swap_32 (digest_buf[1]),
-      byte_swap_32 (digest_buf[2]),
-      byte_swap_32 (digest_buf[3]));
+    snprintf (out_buf, len-1, "%s*%s*%08X%08X", SIGNATURE_RACF, (char *) salt.salt_buf, digest_buf[0], digest_buf[1]);
   }
-  else if (hash_mode == 4700)
+  else if (hash_mode == 2612)
   {
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
-      byte_swap_32 (digest_buf[0]),
-      byte_swap_32 (digest_buf[1]),
-      byte_swap_32 (digest_buf[2]),
-      byte_swap_32 (digest_buf[3]),
-      byte_swap_32 (digest_buf[4]));
+    snprintf (out_buf, len-1, "%s%s$%08x%08x%08x%08x",
+      SIGNATURE_PHPS,
+      (char *) salt.salt_buf,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3]);
   }
-  else if (hash_mode == 4800)
+  else if (hash_mode == 3711)
   {
-    u8 chap_id_byte = (u8) salt.salt_buf[4];
+    char *salt_ptr = (char *) salt.salt_buf;
+
+    salt_ptr[salt.salt_len - 1] = 0;
+
+    snprintf (out_buf, len-1, "%s%s$%08x%08x%08x%08x",
+      SIGNATURE_MEDIAWIKI_B,
+      salt_ptr,
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3]);
+  }
+  else if (hash_mode == 8800)
+  {
+    androidfde_t *androidfdes = (androidfde_t *) data.esalts_buf;
+
+    androidfde_t *androidfde = &androidfdes[salt_pos];
+
+    char tmp[3073] = { 0 };
+
+    for (uint i = 0, j = 0; i < 384; i += 1, j += 8)
+    {
+      sprintf (tmp + j, "%08x", androidfde->data[i]);
+    }
 
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x:%08x%08x%08x%08x:%02x",
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
+    tmp[3072] = 0;
+
+    snprintf (out_buf, len-1, "%s16$%08x%08x%08x%08x$16$%08x%08x%08x%08x$%s",
+      SIGNATURE_ANDROIDFDE,
       byte_swap_32 (salt.salt_buf[0]),
       byte_swap_32 (salt.salt_buf[1]),
       byte_swap_32 (salt.salt_buf[2]),
       byte_swap_32 (salt.salt_buf[3]),
-      chap_id_byte);
-  }
-  else if (hash_mode == 4900)
-  {
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
       byte_swap_32 (digest_buf[0]),
       byte_swap_32 (digest_buf[1]),
       byte_swap_32 (digest_buf[2]),
       byte_swap_32 (digest_buf[3]),
-      byte_swap_32 (digest_buf[4]));
-  }
-  else if (hash_mode == 5100)
-  {
-    snprintf (out_buf, len-1, "%08x%08x",
-      digest_buf[0],
-      digest_buf[1]);
-  }
-  else if (hash_mode == 5200)
-  {
-    snprintf (out_buf, len-1, "%s", hashfile);
+      tmp);
   }
-  else if (hash_mode == 5300)
+  else if (hash_mode == 8900)
   {
-    ikepsk_t *ikepsks = (ikepsk_t *) data.esalts_buf;
-
-    ikepsk_t *ikepsk  = &ikepsks[salt_pos];
-
-    int buf_len = len -1;
-
-    // msg_buf
-
-    uint ikepsk_msg_len = ikepsk->msg_len / 4;
+    uint N = salt.scrypt_N;
+    uint r = salt.scrypt_r;
+    uint p = salt.scrypt_p;
 
-    for (uint i = 0; i < ikepsk_msg_len; i++)
-    {
-      if ((i == 32) || (i == 64) || (i == 66) || (i == 68) || (i == 108))
-      {
-        snprintf (out_buf, buf_len, ":");
+    char base64_salt[32] = { 0 };
 
-        buf_len--;
-        out_buf++;
-      }
+    base64_encode (int_to_base64, (const u8 *) salt.salt_buf, salt.salt_len, (u8 *) base64_salt);
 
-      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->msg_buf[i]));
+    memset (tmp_buf, 0, 46);
 
-      buf_len -= 8;
-      out_buf += 8;
-    }
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    digest_buf[5] = byte_swap_32 (digest_buf[5]);
+    digest_buf[6] = byte_swap_32 (digest_buf[6]);
+    digest_buf[7] = byte_swap_32 (digest_buf[7]);
+    digest_buf[8] = 0; // needed for base64_encode ()
 
-    // nr_buf
+    base64_encode (int_to_base64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
 
-    uint ikepsk_nr_len = ikepsk->nr_len / 4;
+    snprintf (out_buf, len-1, "%s:%i:%i:%i:%s:%s",
+      SIGNATURE_SCRYPT,
+      N,
+      r,
+      p,
+      base64_salt,
+      tmp_buf);
+  }
+  else if (hash_mode == 9000)
+  {
+    snprintf (out_buf, len-1, "%s", hashfile);
+  }
+  else if (hash_mode == 9200)
+  {
+    // salt
 
-    for (uint i = 0; i < ikepsk_nr_len; i++)
-    {
-      if ((i == 0) || (i == 5))
-      {
-        snprintf (out_buf, buf_len, ":");
+    pbkdf2_sha256_t *pbkdf2_sha256s = (pbkdf2_sha256_t *) data.esalts_buf;
 
-        buf_len--;
-        out_buf++;
-      }
+    pbkdf2_sha256_t *pbkdf2_sha256  = &pbkdf2_sha256s[salt_pos];
 
-      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->nr_buf[i]));
+    unsigned char *salt_buf_ptr = (unsigned char *) pbkdf2_sha256->salt_buf;
 
-      buf_len -= 8;
-      out_buf += 8;
-    }
+    // hash
 
-    // digest_buf
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    digest_buf[5] = byte_swap_32 (digest_buf[5]);
+    digest_buf[6] = byte_swap_32 (digest_buf[6]);
+    digest_buf[7] = byte_swap_32 (digest_buf[7]);
+    digest_buf[8] = 0; // needed for base64_encode ()
 
-    for (uint i = 0; i < 4; i++)
-    {
-      if (i == 0)
-      {
-        snprintf (out_buf, buf_len, ":");
+    char tmp_buf[64] = { 0 };
 
-        buf_len--;
-        out_buf++;
-      }
+    base64_encode (int_to_itoa64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
+    tmp_buf[43] = 0; // cut it here
 
-      snprintf (out_buf, buf_len, "%08x", digest_buf[i]);
+    // output
 
-      buf_len -= 8;
-      out_buf += 8;
-    }
+    snprintf (out_buf, len-1, "%s%s$%s", SIGNATURE_CISCO8, salt_buf_ptr, tmp_buf);
   }
-  else if (hash_mode == 5400)
+  else if (hash_mode == 9300)
   {
-    ikepsk_t *ikepsks = (ikepsk_t *) data.esalts_buf;
-
-    ikepsk_t *ikepsk  = &ikepsks[salt_pos];
-
-    int buf_len = len -1;
-
-    // msg_buf
-
-    uint ikepsk_msg_len = ikepsk->msg_len / 4;
-
-    for (uint i = 0; i < ikepsk_msg_len; i++)
-    {
-      if ((i == 32) || (i == 64) || (i == 66) || (i == 68) || (i == 108))
-      {
-        snprintf (out_buf, buf_len, ":");
-
-        buf_len--;
-        out_buf++;
-      }
-
-      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->msg_buf[i]));
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+    digest_buf[2] = byte_swap_32 (digest_buf[2]);
+    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    digest_buf[5] = byte_swap_32 (digest_buf[5]);
+    digest_buf[6] = byte_swap_32 (digest_buf[6]);
+    digest_buf[7] = byte_swap_32 (digest_buf[7]);
+    digest_buf[8] = 0; // needed for base64_encode ()
 
-      buf_len -= 8;
-      out_buf += 8;
-    }
+    char tmp_buf[64] = { 0 };
 
-    // nr_buf
+    base64_encode (int_to_itoa64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
+    tmp_buf[43] = 0; // cut it here
 
-    uint ikepsk_nr_len = ikepsk->nr_len / 4;
+    unsigned char *salt_buf_ptr = (unsigned char *) salt.salt_buf;
 
-    for (uint i = 0; i < ikepsk_nr_len; i++)
-    {
-      if ((i == 0) || (i == 5))
-      {
-        snprintf (out_buf, buf_len, ":");
+    snprintf (out_buf, len-1, "%s%s$%s", SIGNATURE_CISCO9, salt_buf_ptr, tmp_buf);
+  }
+  else if (hash_mode == 9400)
+  {
+    office2007_t *office2007s = (office2007_t *) data.esalts_buf;
 
-        buf_len--;
-        out_buf++;
-      }
+    office2007_t *office2007 = &office2007s[salt_pos];
 
-      snprintf (out_buf, buf_len, "%08x", byte_swap_32 (ikepsk->nr_buf[i]));
+    snprintf (out_buf, len-1, "%s*%u*%u*%u*%u*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x",
+      SIGNATURE_OFFICE2007,
+      2007,
+      20,
+      office2007->keySize,
+      16,
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      office2007->encryptedVerifier[0],
+      office2007->encryptedVerifier[1],
+      office2007->encryptedVerifier[2],
+      office2007->encryptedVerifier[3],
+      office2007->encryptedVerifierHash[0],
+      office2007->encryptedVerifierHash[1],
+      office2007->encryptedVerifierHash[2],
+      office2007->encryptedVerifierHash[3],
+      office2007->encryptedVerifierHash[4]);
+  }
+  else if (hash_mode == 9500)
+  {
+    office2010_t *office2010s = (office2010_t *) data.esalts_buf;
 
-      buf_len -= 8;
-      out_buf += 8;
-    }
+    office2010_t *office2010 = &office2010s[salt_pos];
 
-    // digest_buf
+    snprintf (out_buf, len-1, "%s*%u*%u*%u*%u*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x%08x%08x%08x", SIGNATURE_OFFICE2010, 2010, 100000, 128, 16,
 
-    for (uint i = 0; i < 5; i++)
-    {
-      if (i == 0)
-      {
-        snprintf (out_buf, buf_len, ":");
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      office2010->encryptedVerifier[0],
+      office2010->encryptedVerifier[1],
+      office2010->encryptedVerifier[2],
+      office2010->encryptedVerifier[3],
+      office2010->encryptedVerifierHash[0],
+      office2010->encryptedVerifierHash[1],
+      office2010->encryptedVerifierHash[2],
+      office2010->encryptedVerifierHash[3],
+      office2010->encryptedVerifierHash[4],
+      office2010->encryptedVerifierHash[5],
+      office2010->encryptedVerifierHash[6],
+      office2010->encryptedVerifierHash[7]);
+  }
+  else if (hash_mode == 9600)
+  {
+    office2013_t *office2013s = (office2013_t *) data.esalts_buf;
 
-        buf_len--;
-        out_buf++;
-      }
+    office2013_t *office2013 = &office2013s[salt_pos];
 
-      snprintf (out_buf, buf_len, "%08x", digest_buf[i]);
+    snprintf (out_buf, len-1, "%s*%u*%u*%u*%u*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x%08x%08x%08x", SIGNATURE_OFFICE2013, 2013, 100000, 256, 16,
 
-      buf_len -= 8;
-      out_buf += 8;
-    }
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      office2013->encryptedVerifier[0],
+      office2013->encryptedVerifier[1],
+      office2013->encryptedVerifier[2],
+      office2013->encryptedVerifier[3],
+      office2013->encryptedVerifierHash[0],
+      office2013->encryptedVerifierHash[1],
+      office2013->encryptedVerifierHash[2],
+      office2013->encryptedVerifierHash[3],
+      office2013->encryptedVerifierHash[4],
+      office2013->encryptedVerifierHash[5],
+      office2013->encryptedVerifierHash[6],
+      office2013->encryptedVerifierHash[7]);
   }
-  else if (hash_mode == 5500)
+  else if (hash_mode == 9700)
   {
-    netntlm_t *netntlms = (netntlm_t *) data.esalts_buf;
-
-    netntlm_t *netntlm = &netntlms[salt_pos];
-
-    char user_buf[64] = { 0 };
-    char domain_buf[64] = { 0 };
-    char srvchall_buf[1024] = { 0 };
-    char clichall_buf[1024] = { 0 };
-
-    for (uint i = 0, j = 0; j < netntlm->user_len; i += 1, j += 2)
-    {
-      char *ptr = (char *) netntlm->userdomain_buf;
-
-      user_buf[i] = ptr[j];
-    }
+    oldoffice01_t *oldoffice01s = (oldoffice01_t *) data.esalts_buf;
 
-    for (uint i = 0, j = 0; j < netntlm->domain_len; i += 1, j += 2)
-    {
-      char *ptr = (char *) netntlm->userdomain_buf;
+    oldoffice01_t *oldoffice01 = &oldoffice01s[salt_pos];
 
-      domain_buf[i] = ptr[netntlm->user_len + j];
-    }
+    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x",
+      (oldoffice01->version == 0) ? SIGNATURE_OLDOFFICE0 : SIGNATURE_OLDOFFICE1,
+      byte_swap_32 (salt.salt_buf[0]),
+      byte_swap_32 (salt.salt_buf[1]),
+      byte_swap_32 (salt.salt_buf[2]),
+      byte_swap_32 (salt.salt_buf[3]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[0]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[1]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[2]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[3]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[0]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[1]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[2]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[3]));
+  }
+  else if (hash_mode == 9710)
+  {
+    oldoffice01_t *oldoffice01s = (oldoffice01_t *) data.esalts_buf;
 
-    for (uint i = 0, j = 0; i < netntlm->srvchall_len; i += 1, j += 2)
-    {
-      u8 *ptr = (u8 *) netntlm->chall_buf;
+    oldoffice01_t *oldoffice01 = &oldoffice01s[salt_pos];
 
-      sprintf (srvchall_buf + j, "%02x", ptr[i]);
-    }
+    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x",
+      (oldoffice01->version == 0) ? SIGNATURE_OLDOFFICE0 : SIGNATURE_OLDOFFICE1,
+      byte_swap_32 (salt.salt_buf[0]),
+      byte_swap_32 (salt.salt_buf[1]),
+      byte_swap_32 (salt.salt_buf[2]),
+      byte_swap_32 (salt.salt_buf[3]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[0]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[1]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[2]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[3]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[0]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[1]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[2]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[3]));
+  }
+  else if (hash_mode == 9720)
+  {
+    oldoffice01_t *oldoffice01s = (oldoffice01_t *) data.esalts_buf;
 
-    for (uint i = 0, j = 0; i < netntlm->clichall_len; i += 1, j += 2)
-    {
-      u8 *ptr = (u8 *) netntlm->chall_buf;
+    oldoffice01_t *oldoffice01 = &oldoffice01s[salt_pos];
 
-      sprintf (clichall_buf + j, "%02x", ptr[netntlm->srvchall_len + i]);
-    }
+    u8 *rc4key = (u8 *) oldoffice01->rc4key;
 
-    snprintf (out_buf, len-1, "%s::%s:%s:%08x%08x%08x%08x%08x%08x:%s",
-      user_buf,
-      domain_buf,
-      srvchall_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      byte_swap_32 (salt.salt_buf_pc[0]),
-      byte_swap_32 (salt.salt_buf_pc[1]),
-      clichall_buf);
+    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x:%02x%02x%02x%02x%02x",
+      (oldoffice01->version == 0) ? SIGNATURE_OLDOFFICE0 : SIGNATURE_OLDOFFICE1,
+      byte_swap_32 (salt.salt_buf[0]),
+      byte_swap_32 (salt.salt_buf[1]),
+      byte_swap_32 (salt.salt_buf[2]),
+      byte_swap_32 (salt.salt_buf[3]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[0]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[1]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[2]),
+      byte_swap_32 (oldoffice01->encryptedVerifier[3]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[0]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[1]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[2]),
+      byte_swap_32 (oldoffice01->encryptedVerifierHash[3]),
+      rc4key[0],
+      rc4key[1],
+      rc4key[2],
+      rc4key[3],
+      rc4key[4]);
   }
-  else if (hash_mode == 5600)
+  else if (hash_mode == 9800)
   {
-    netntlm_t *netntlms = (netntlm_t *) data.esalts_buf;
+    oldoffice34_t *oldoffice34s = (oldoffice34_t *) data.esalts_buf;
 
-    netntlm_t *netntlm = &netntlms[salt_pos];
+    oldoffice34_t *oldoffice34 = &oldoffice34s[salt_pos];
 
-    char user_buf[64] = { 0 };
-    char domain_buf[64] = { 0 };
-    char srvchall_buf[1024] = { 0 };
-    char clichall_buf[1024] = { 0 };
+    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x",
+      (oldoffice34->version == 3) ? SIGNATURE_OLDOFFICE3 : SIGNATURE_OLDOFFICE4,
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      byte_swap_32 (oldoffice34->encryptedVerifier[0]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[1]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[2]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[3]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[0]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[1]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[2]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[3]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[4]));
+  }
+  else if (hash_mode == 9810)
+  {
+    oldoffice34_t *oldoffice34s = (oldoffice34_t *) data.esalts_buf;
 
-    for (uint i = 0, j = 0; j < netntlm->user_len; i += 1, j += 2)
-    {
-      char *ptr = (char *) netntlm->userdomain_buf;
+    oldoffice34_t *oldoffice34 = &oldoffice34s[salt_pos];
 
-      user_buf[i] = ptr[j];
-    }
+    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x",
+      (oldoffice34->version == 3) ? SIGNATURE_OLDOFFICE3 : SIGNATURE_OLDOFFICE4,
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      byte_swap_32 (oldoffice34->encryptedVerifier[0]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[1]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[2]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[3]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[0]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[1]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[2]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[3]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[4]));
+  }
+  else if (hash_mode == 9820)
+  {
+    oldoffice34_t *oldoffice34s = (oldoffice34_t *) data.esalts_buf;
 
-    for (uint i = 0, j = 0; j < netntlm->domain_len; i += 1, j += 2)
-    {
-      char *ptr = (char *) netntlm->userdomain_buf;
+    oldoffice34_t *oldoffice34 = &oldoffice34s[salt_pos];
 
-      domain_buf[i] = ptr[netntlm->user_len + j];
-    }
+    u8 *rc4key = (u8 *) oldoffice34->rc4key;
 
-    for (uint i = 0, j = 0; i < netntlm->srvchall_len; i += 1, j += 2)
-    {
-      u8 *ptr = (u8 *) netntlm->chall_buf;
+    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x:%02x%02x%02x%02x%02x",
+      (oldoffice34->version == 3) ? SIGNATURE_OLDOFFICE3 : SIGNATURE_OLDOFFICE4,
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      byte_swap_32 (oldoffice34->encryptedVerifier[0]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[1]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[2]),
+      byte_swap_32 (oldoffice34->encryptedVerifier[3]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[0]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[1]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[2]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[3]),
+      byte_swap_32 (oldoffice34->encryptedVerifierHash[4]),
+      rc4key[0],
+      rc4key[1],
+      rc4key[2],
+      rc4key[3],
+      rc4key[4]);
+  }
+  else if (hash_mode == 10000)
+  {
+    // salt
 
-      sprintf (srvchall_buf + j, "%02x", ptr[i]);
-    }
+    pbkdf2_sha256_t *pbkdf2_sha256s = (pbkdf2_sha256_t *) data.esalts_buf;
 
-    for (uint i = 0, j = 0; i < netntlm->clichall_len; i += 1, j += 2)
-    {
-      u8 *ptr = (u8 *) netntlm->chall_buf;
+    pbkdf2_sha256_t *pbkdf2_sha256  = &pbkdf2_sha256s[salt_pos];
 
-      sprintf (clichall_buf + j, "%02x", ptr[netntlm->srvchall_len + i]);
-    }
+    unsigned char *salt_buf_ptr = (unsigned char *) pbkdf2_sha256->salt_buf;
 
-    snprintf (out_buf, len-1, "%s::%s:%s:%08x%08x%08x%08x:%s",
-      user_buf,
-      domain_buf,
-      srvchall_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      clichall_buf);
-  }
-  else if (hash_mode == 5700)
-  {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    // hash
 
     digest_buf[0] = byte_swap_32 (digest_buf[0]);
     digest_buf[1] = byte_swap_32 (digest_buf[1]);
@@ -7187,2542 +9620,2420 @@ void ascii_digest (char *out_buf, uint salt_pos, uint digest_pos)
     digest_buf[5] = byte_swap_32 (digest_buf[5]);
     digest_buf[6] = byte_swap_32 (digest_buf[6]);
     digest_buf[7] = byte_swap_32 (digest_buf[7]);
+    digest_buf[8] = 0; // needed for base64_encode ()
 
-    memcpy (tmp_buf, digest_buf, 32);
+    char tmp_buf[64] = { 0 };
 
-    base64_encode (int_to_itoa64, (const u8 *) tmp_buf, 32, (u8 *) ptr_plain);
+    base64_encode (int_to_base64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
 
-    ptr_plain[43] = 0;
+    // output
 
-    snprintf (out_buf, len-1, "%s", ptr_plain);
+    snprintf (out_buf, len-1, "%s%i$%s$%s", SIGNATURE_DJANGOPBKDF2, salt.salt_iter + 1, salt_buf_ptr, tmp_buf);
   }
-  else if (hash_mode == 5800)
+  else if (hash_mode == 10100)
   {
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    snprintf (out_buf, len-1, "%08x%08x:%u:%u:%08x%08x%08x%08x",
+      digest_buf[0],
+      digest_buf[1],
+      2,
+      4,
+      byte_swap_32 (salt.salt_buf[0]),
+      byte_swap_32 (salt.salt_buf[1]),
+      byte_swap_32 (salt.salt_buf[2]),
+      byte_swap_32 (salt.salt_buf[3]));
+  }
+  else if (hash_mode == 10200)
+  {
+    cram_md5_t *cram_md5s = (cram_md5_t *) data.esalts_buf;
+
+    cram_md5_t *cram_md5 = &cram_md5s[salt_pos];
+
+    // challenge
+
+    char challenge[100] = { 0 };
+
+    base64_encode (int_to_base64, (const u8 *) salt.salt_buf, salt.salt_len, (u8 *) challenge);
 
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
+    // response
+
+    char tmp_buf[100] = { 0 };
+
+    uint tmp_len = snprintf (tmp_buf, 100, "%s %08x%08x%08x%08x",
+      (char *) cram_md5->user,
       digest_buf[0],
       digest_buf[1],
       digest_buf[2],
-      digest_buf[3],
-      digest_buf[4]);
-  }
-  else if ((hash_mode >= 6200) && (hash_mode <= 6299))
-  {
-    snprintf (out_buf, len-1, "%s", hashfile);
-  }
-  else if (hash_mode == 6300)
-  {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+      digest_buf[3]);
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
+    char response[100] = { 0 };
 
-    md5crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, tmp_len, (u8 *) response);
 
-    snprintf (out_buf, len-1, "{smd5}%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
+    snprintf (out_buf, len-1, "%s%s$%s", SIGNATURE_CRAM_MD5, challenge, response);
   }
-  else if (hash_mode == 6400)
+  else if (hash_mode == 10300)
   {
-    sha256aix_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+    char tmp_buf[100] = { 0 };
 
-    snprintf (out_buf, len-1, "{ssha256}%02d$%s$%s", salt.salt_sign[0], (char *) salt.salt_buf, (char *) ptr_plain);
-  }
-  else if (hash_mode == 6500)
-  {
-    sha512aix_encode ((unsigned char *) digest_buf64, (unsigned char *) ptr_plain);
+    memcpy (tmp_buf +  0, digest_buf, 20);
+    memcpy (tmp_buf + 20, salt.salt_buf, salt.salt_len);
 
-    snprintf (out_buf, len-1, "{ssha512}%02d$%s$%s", salt.salt_sign[0], (char *) salt.salt_buf, (char *) ptr_plain);
-  }
-  else if (hash_mode == 6600)
-  {
-    agilekey_t *agilekeys = (agilekey_t *) data.esalts_buf;
+    uint tmp_len = 20 + salt.salt_len;
 
-    agilekey_t *agilekey = &agilekeys[salt_pos];
+    // base64 encode it
 
-    salt.salt_buf[0] = byte_swap_32 (salt.salt_buf[0]);
-    salt.salt_buf[1] = byte_swap_32 (salt.salt_buf[1]);
+    char base64_encoded[100] = { 0 };
 
-    uint buf_len = len - 1;
+    base64_encode (int_to_base64, (const u8 *) tmp_buf, tmp_len, (u8 *) base64_encoded);
 
-    uint off = snprintf (out_buf, buf_len, "%d:%08x%08x:", salt.salt_iter + 1, salt.salt_buf[0], salt.salt_buf[1]);
-    buf_len -= 22;
+    snprintf (out_buf, len-1, "%s%i}%s", SIGNATURE_SAPH_SHA1, salt.salt_iter + 1, base64_encoded);
+  }
+  else if (hash_mode == 10400)
+  {
+    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
 
-    for (uint i = 0, j = off; i < 1040; i++, j += 2)
-    {
-      snprintf (out_buf + j, buf_len, "%02x", agilekey->cipher[i]);
+    pdf_t *pdf = &pdfs[salt_pos];
 
-      buf_len -= 2;
-    }
+    snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
+
+      pdf->V,
+      pdf->R,
+      40,
+      pdf->P,
+      pdf->enc_md,
+      pdf->id_len,
+      byte_swap_32 (pdf->id_buf[0]),
+      byte_swap_32 (pdf->id_buf[1]),
+      byte_swap_32 (pdf->id_buf[2]),
+      byte_swap_32 (pdf->id_buf[3]),
+      pdf->u_len,
+      byte_swap_32 (pdf->u_buf[0]),
+      byte_swap_32 (pdf->u_buf[1]),
+      byte_swap_32 (pdf->u_buf[2]),
+      byte_swap_32 (pdf->u_buf[3]),
+      byte_swap_32 (pdf->u_buf[4]),
+      byte_swap_32 (pdf->u_buf[5]),
+      byte_swap_32 (pdf->u_buf[6]),
+      byte_swap_32 (pdf->u_buf[7]),
+      pdf->o_len,
+      byte_swap_32 (pdf->o_buf[0]),
+      byte_swap_32 (pdf->o_buf[1]),
+      byte_swap_32 (pdf->o_buf[2]),
+      byte_swap_32 (pdf->o_buf[3]),
+      byte_swap_32 (pdf->o_buf[4]),
+      byte_swap_32 (pdf->o_buf[5]),
+      byte_swap_32 (pdf->o_buf[6]),
+      byte_swap_32 (pdf->o_buf[7])
+    );
   }
-  else if (hash_mode == 6700)
+  else if (hash_mode == 10410)
   {
-    sha1aix_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
 
-    snprintf (out_buf, len-1, "{ssha1}%02d$%s$%s", salt.salt_sign[0], (char *) salt.salt_buf, (char *) ptr_plain);
+    pdf_t *pdf = &pdfs[salt_pos];
+
+    snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
+
+      pdf->V,
+      pdf->R,
+      40,
+      pdf->P,
+      pdf->enc_md,
+      pdf->id_len,
+      byte_swap_32 (pdf->id_buf[0]),
+      byte_swap_32 (pdf->id_buf[1]),
+      byte_swap_32 (pdf->id_buf[2]),
+      byte_swap_32 (pdf->id_buf[3]),
+      pdf->u_len,
+      byte_swap_32 (pdf->u_buf[0]),
+      byte_swap_32 (pdf->u_buf[1]),
+      byte_swap_32 (pdf->u_buf[2]),
+      byte_swap_32 (pdf->u_buf[3]),
+      byte_swap_32 (pdf->u_buf[4]),
+      byte_swap_32 (pdf->u_buf[5]),
+      byte_swap_32 (pdf->u_buf[6]),
+      byte_swap_32 (pdf->u_buf[7]),
+      pdf->o_len,
+      byte_swap_32 (pdf->o_buf[0]),
+      byte_swap_32 (pdf->o_buf[1]),
+      byte_swap_32 (pdf->o_buf[2]),
+      byte_swap_32 (pdf->o_buf[3]),
+      byte_swap_32 (pdf->o_buf[4]),
+      byte_swap_32 (pdf->o_buf[5]),
+      byte_swap_32 (pdf->o_buf[6]),
+      byte_swap_32 (pdf->o_buf[7])
+    );
   }
-  else if (hash_mode == 6800)
+  else if (hash_mode == 10420)
   {
-    snprintf (out_buf, len-1, "%s", (char *) salt.salt_buf);
+    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
+
+    pdf_t *pdf = &pdfs[salt_pos];
+
+    u8 *rc4key = (u8 *) pdf->rc4key;
+
+    snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x:%02x%02x%02x%02x%02x",
+
+      pdf->V,
+      pdf->R,
+      40,
+      pdf->P,
+      pdf->enc_md,
+      pdf->id_len,
+      byte_swap_32 (pdf->id_buf[0]),
+      byte_swap_32 (pdf->id_buf[1]),
+      byte_swap_32 (pdf->id_buf[2]),
+      byte_swap_32 (pdf->id_buf[3]),
+      pdf->u_len,
+      byte_swap_32 (pdf->u_buf[0]),
+      byte_swap_32 (pdf->u_buf[1]),
+      byte_swap_32 (pdf->u_buf[2]),
+      byte_swap_32 (pdf->u_buf[3]),
+      byte_swap_32 (pdf->u_buf[4]),
+      byte_swap_32 (pdf->u_buf[5]),
+      byte_swap_32 (pdf->u_buf[6]),
+      byte_swap_32 (pdf->u_buf[7]),
+      pdf->o_len,
+      byte_swap_32 (pdf->o_buf[0]),
+      byte_swap_32 (pdf->o_buf[1]),
+      byte_swap_32 (pdf->o_buf[2]),
+      byte_swap_32 (pdf->o_buf[3]),
+      byte_swap_32 (pdf->o_buf[4]),
+      byte_swap_32 (pdf->o_buf[5]),
+      byte_swap_32 (pdf->o_buf[6]),
+      byte_swap_32 (pdf->o_buf[7]),
+      rc4key[0],
+      rc4key[1],
+      rc4key[2],
+      rc4key[3],
+      rc4key[4]
+    );
   }
-  else if (hash_mode == 7100)
+  else if (hash_mode == 10500)
   {
-    uint *ptr = digest_buf;
-
-    pbkdf2_sha512_t *pbkdf2_sha512s = (pbkdf2_sha512_t *) data.esalts_buf;
+    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
 
-    pbkdf2_sha512_t *pbkdf2_sha512  = &pbkdf2_sha512s[salt_pos];
+    pdf_t *pdf = &pdfs[salt_pos];
 
-    uint esalt[8] = { 0 };
+    if (pdf->id_len == 32)
+    {
+      snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
 
-    esalt[0] = byte_swap_32 (pbkdf2_sha512->salt_buf[0]);
-    esalt[1] = byte_swap_32 (pbkdf2_sha512->salt_buf[1]);
-    esalt[2] = byte_swap_32 (pbkdf2_sha512->salt_buf[2]);
-    esalt[3] = byte_swap_32 (pbkdf2_sha512->salt_buf[3]);
-    esalt[4] = byte_swap_32 (pbkdf2_sha512->salt_buf[4]);
-    esalt[5] = byte_swap_32 (pbkdf2_sha512->salt_buf[5]);
-    esalt[6] = byte_swap_32 (pbkdf2_sha512->salt_buf[6]);
-    esalt[7] = byte_swap_32 (pbkdf2_sha512->salt_buf[7]);
+        pdf->V,
+        pdf->R,
+        128,
+        pdf->P,
+        pdf->enc_md,
+        pdf->id_len,
+        byte_swap_32 (pdf->id_buf[0]),
+        byte_swap_32 (pdf->id_buf[1]),
+        byte_swap_32 (pdf->id_buf[2]),
+        byte_swap_32 (pdf->id_buf[3]),
+        byte_swap_32 (pdf->id_buf[4]),
+        byte_swap_32 (pdf->id_buf[5]),
+        byte_swap_32 (pdf->id_buf[6]),
+        byte_swap_32 (pdf->id_buf[7]),
+        pdf->u_len,
+        byte_swap_32 (pdf->u_buf[0]),
+        byte_swap_32 (pdf->u_buf[1]),
+        byte_swap_32 (pdf->u_buf[2]),
+        byte_swap_32 (pdf->u_buf[3]),
+        byte_swap_32 (pdf->u_buf[4]),
+        byte_swap_32 (pdf->u_buf[5]),
+        byte_swap_32 (pdf->u_buf[6]),
+        byte_swap_32 (pdf->u_buf[7]),
+        pdf->o_len,
+        byte_swap_32 (pdf->o_buf[0]),
+        byte_swap_32 (pdf->o_buf[1]),
+        byte_swap_32 (pdf->o_buf[2]),
+        byte_swap_32 (pdf->o_buf[3]),
+        byte_swap_32 (pdf->o_buf[4]),
+        byte_swap_32 (pdf->o_buf[5]),
+        byte_swap_32 (pdf->o_buf[6]),
+        byte_swap_32 (pdf->o_buf[7])
+      );
+    }
+    else
+    {
+      snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
 
-    snprintf (out_buf, len-1, "%s%i$%08x%08x%08x%08x%08x%08x%08x%08x$%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-      SIGNATURE_SHA512OSX,
-      salt.salt_iter + 1,
-      esalt[ 0], esalt[ 1],
-      esalt[ 2], esalt[ 3],
-      esalt[ 4], esalt[ 5],
-      esalt[ 6], esalt[ 7],
-      ptr  [ 1], ptr  [ 0],
-      ptr  [ 3], ptr  [ 2],
-      ptr  [ 5], ptr  [ 4],
-      ptr  [ 7], ptr  [ 6],
-      ptr  [ 9], ptr  [ 8],
-      ptr  [11], ptr  [10],
-      ptr  [13], ptr  [12],
-      ptr  [15], ptr  [14]);
+        pdf->V,
+        pdf->R,
+        128,
+        pdf->P,
+        pdf->enc_md,
+        pdf->id_len,
+        byte_swap_32 (pdf->id_buf[0]),
+        byte_swap_32 (pdf->id_buf[1]),
+        byte_swap_32 (pdf->id_buf[2]),
+        byte_swap_32 (pdf->id_buf[3]),
+        pdf->u_len,
+        byte_swap_32 (pdf->u_buf[0]),
+        byte_swap_32 (pdf->u_buf[1]),
+        byte_swap_32 (pdf->u_buf[2]),
+        byte_swap_32 (pdf->u_buf[3]),
+        byte_swap_32 (pdf->u_buf[4]),
+        byte_swap_32 (pdf->u_buf[5]),
+        byte_swap_32 (pdf->u_buf[6]),
+        byte_swap_32 (pdf->u_buf[7]),
+        pdf->o_len,
+        byte_swap_32 (pdf->o_buf[0]),
+        byte_swap_32 (pdf->o_buf[1]),
+        byte_swap_32 (pdf->o_buf[2]),
+        byte_swap_32 (pdf->o_buf[3]),
+        byte_swap_32 (pdf->o_buf[4]),
+        byte_swap_32 (pdf->o_buf[5]),
+        byte_swap_32 (pdf->o_buf[6]),
+        byte_swap_32 (pdf->o_buf[7])
+      );
+    }
   }
-  else if (hash_mode == 7200)
+  else if (hash_mode == 10600)
   {
-    uint *ptr = digest_buf;
-
-    pbkdf2_sha512_t *pbkdf2_sha512s = (pbkdf2_sha512_t *) data.esalts_buf;
-
-    pbkdf2_sha512_t *pbkdf2_sha512  = &pbkdf2_sha512s[salt_pos];
-
-    uint len_used = 0;
-
-    snprintf (out_buf + len_used, len - len_used - 1, "%s%i.", SIGNATURE_SHA512GRUB, salt.salt_iter + 1);
+    uint digest_idx = salt.digests_offset + digest_pos;
 
-    len_used = strlen (out_buf);
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
 
-    unsigned char *salt_buf_ptr = (unsigned char *) pbkdf2_sha512->salt_buf;
+    snprintf (out_buf, len-1, "%s", hash_buf);
+  }
+  else if (hash_mode == 10700)
+  {
+    uint digest_idx = salt.digests_offset + digest_pos;
 
-    for (uint i = 0; i < salt.salt_len; i++, len_used += 2)
-    {
-      snprintf (out_buf + len_used, len - len_used - 1, "%02x", salt_buf_ptr[i]);
-    }
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
 
-    snprintf (out_buf + len_used, len - len_used - 1, ".%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-      ptr  [ 1], ptr  [ 0],
-      ptr  [ 3], ptr  [ 2],
-      ptr  [ 5], ptr  [ 4],
-      ptr  [ 7], ptr  [ 6],
-      ptr  [ 9], ptr  [ 8],
-      ptr  [11], ptr  [10],
-      ptr  [13], ptr  [12],
-      ptr  [15], ptr  [14]);
+    snprintf (out_buf, len-1, "%s", hash_buf);
   }
-  else if (hash_mode == 7300)
+  else if (hash_mode == 10900)
   {
-    rakp_t *rakps = (rakp_t *) data.esalts_buf;
-
-    rakp_t *rakp = &rakps[salt_pos];
+    uint digest_idx = salt.digests_offset + digest_pos;
 
-    for (uint i = 0, j = 0; (i * 4) < rakp->salt_len; i += 1, j += 8)
-    {
-      sprintf (out_buf + j, "%08x", rakp->salt_buf[i]);
-    }
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
 
-    snprintf (out_buf + rakp->salt_len * 2, len - 1, ":%08x%08x%08x%08x%08x",
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4]);
+    snprintf (out_buf, len-1, "%s", hash_buf);
   }
-  else if (hash_mode == 7400)
+  else if (hash_mode == 11100)
   {
-    // the encoder is a bit too intelligent, it expects the input data in the wrong BOM
+    u32 salt_challenge = salt.salt_buf[0];
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
-    digest_buf[5] = byte_swap_32 (digest_buf[5]);
-    digest_buf[6] = byte_swap_32 (digest_buf[6]);
-    digest_buf[7] = byte_swap_32 (digest_buf[7]);
+    salt_challenge = byte_swap_32 (salt_challenge);
 
-    sha256crypt_encode ((unsigned char *) digest_buf, (unsigned char *) ptr_plain);
+    unsigned char *user_name = (unsigned char *) (salt.salt_buf + 1);
 
-    if (salt.salt_iter == ROUNDS_SHA256CRYPT)
-    {
-      snprintf (out_buf, len-1, "$5$%s$%s", (char *) salt.salt_buf, (char *) ptr_plain);
-    }
-    else
-    {
-      snprintf (out_buf, len-1, "$5$rounds=%i$%s$%s", salt.salt_iter, (char *) salt.salt_buf, (char *) ptr_plain);
-    }
+    snprintf (out_buf, len-1, "%s%s*%08x*%08x%08x%08x%08x",
+        SIGNATURE_POSTGRESQL_AUTH,
+        user_name,
+        salt_challenge,
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3]);
   }
-  else if (hash_mode == 7500)
+  else if (hash_mode == 11200)
   {
-    krb5pa_t *krb5pas = (krb5pa_t *) data.esalts_buf;
+    snprintf (out_buf, len-1, "%s%s*%08x%08x%08x%08x%08x",
+        SIGNATURE_MYSQL_AUTH,
+        (unsigned char *) salt.salt_buf,
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3],
+        digest_buf[4]);
+  }
+  else if (hash_mode == 11300)
+  {
+    bitcoin_wallet_t *bitcoin_wallets = (bitcoin_wallet_t *) data.esalts_buf;
 
-    krb5pa_t *krb5pa = &krb5pas[salt_pos];
+    bitcoin_wallet_t *bitcoin_wallet = &bitcoin_wallets[salt_pos];
 
-    u8 *ptr_timestamp = (u8 *) krb5pa->timestamp;
-    u8 *ptr_checksum  = (u8 *) krb5pa->checksum;
+    const uint cry_master_len = bitcoin_wallet->cry_master_len;
+    const uint ckey_len       = bitcoin_wallet->ckey_len;
+    const uint public_key_len = bitcoin_wallet->public_key_len;
 
-    char data[128] = { 0 };
+    char *cry_master_buf = (char *) mymalloc ((cry_master_len * 2) + 1);
+    char *ckey_buf       = (char *) mymalloc ((ckey_len * 2)       + 1);
+    char *public_key_buf = (char *) mymalloc ((public_key_len * 2) + 1);
 
-    char *ptr_data = data;
+    for (uint i = 0, j = 0; i < cry_master_len; i += 1, j += 2)
+    {
+      const u8 *ptr = (const u8 *) bitcoin_wallet->cry_master_buf;
 
-    for (uint i = 0; i < 36; i++, ptr_data += 2)
+      sprintf (cry_master_buf + j, "%02x", ptr[i]);
+    }
+
+    for (uint i = 0, j = 0; i < ckey_len; i += 1, j += 2)
     {
-      sprintf (ptr_data, "%02x", ptr_timestamp[i]);
+      const u8 *ptr = (const u8 *) bitcoin_wallet->ckey_buf;
+
+      sprintf (ckey_buf + j, "%02x", ptr[i]);
     }
 
-    for (uint i = 0; i < 16; i++, ptr_data += 2)
+    for (uint i = 0, j = 0; i < public_key_len; i += 1, j += 2)
     {
-      sprintf (ptr_data, "%02x", ptr_checksum[i]);
+      const u8 *ptr = (const u8 *) bitcoin_wallet->public_key_buf;
+
+      sprintf (public_key_buf + j, "%02x", ptr[i]);
     }
 
-    *ptr_data = 0;
+    snprintf (out_buf, len-1, "%s%d$%s$%d$%s$%d$%d$%s$%d$%s",
+      SIGNATURE_BITCOIN_WALLET,
+      cry_master_len * 2,
+      cry_master_buf,
+      salt.salt_len,
+      (unsigned char *) salt.salt_buf,
+      salt.salt_iter + 1,
+      ckey_len * 2,
+      ckey_buf,
+      public_key_len * 2,
+      public_key_buf
+    );
 
-    snprintf (out_buf, len-1, "%s$%s$%s$%s$%s",
-      SIGNATURE_KRB5PA,
-      (char *) krb5pa->user,
-      (char *) krb5pa->realm,
-      (char *) krb5pa->salt,
-      data);
-  }
-  else if (hash_mode == 7700)
-  {
-    snprintf (out_buf, len-1, "%s$%08X%08X",
-      (char *) salt.salt_buf,
-      digest_buf[0],
-      digest_buf[1]);
+    free (cry_master_buf);
+    free (ckey_buf);
+    free (public_key_buf);
   }
-  else if (hash_mode == 7800)
+  else if (hash_mode == 11400)
   {
-    snprintf (out_buf, len-1, "%s$%08X%08X%08X%08X%08X",
-      (char *) salt.salt_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4]);
+    uint digest_idx = salt.digests_offset + digest_pos;
+
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+
+    snprintf (out_buf, len-1, "%s", hash_buf);
   }
-  else if (hash_mode == 7900)
+  else if (hash_mode == 11600)
   {
-    drupal7_encode ((unsigned char *) digest_buf64, (unsigned char *) ptr_plain);
+    seven_zip_t *seven_zips = (seven_zip_t *) data.esalts_buf;
 
-    // ugly hack start
+    seven_zip_t *seven_zip = &seven_zips[salt_pos];
 
-    char *tmp = (char *) salt.salt_buf_pc;
+    const uint data_len = seven_zip->data_len;
 
-    ptr_plain[42] = tmp[0];
+    char *data_buf = (char *) mymalloc ((data_len * 2) + 1);
 
-    // ugly hack end
+    for (uint i = 0, j = 0; i < data_len; i += 1, j += 2)
+    {
+      const u8 *ptr = (const u8 *) seven_zip->data_buf;
 
-    ptr_plain[43] = 0;
+      sprintf (data_buf + j, "%02x", ptr[i]);
+    }
 
-    snprintf (out_buf, len-1, "%s%s%s", (char *) salt.salt_sign, (char *) salt.salt_buf, (char *) ptr_plain);
-  }
-  else if (hash_mode == 8000)
-  {
-    snprintf (out_buf, len-1, "0xc007%s%08x%08x%08x%08x%08x%08x%08x%08x",
-      (unsigned char *) salt.salt_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4],
-      digest_buf[5],
-      digest_buf[6],
-      digest_buf[7]);
-  }
-  else if (hash_mode == 8100)
-  {
-    salt.salt_buf[0] = byte_swap_32 (salt.salt_buf[0]);
-    salt.salt_buf[1] = byte_swap_32 (salt.salt_buf[1]);
+    snprintf (out_buf, len-1, "%s%u$%u$%u$%s$%u$%08x%08x%08x%08x$%u$%u$%u$%s",
+      SIGNATURE_SEVEN_ZIP,
+      0,
+      salt.salt_sign[0],
+      0,
+      (char *) seven_zip->salt_buf,
+      seven_zip->iv_len,
+      seven_zip->iv_buf[0],
+      seven_zip->iv_buf[1],
+      seven_zip->iv_buf[2],
+      seven_zip->iv_buf[3],
+      seven_zip->crc,
+      seven_zip->data_len,
+      seven_zip->unpack_size,
+      data_buf);
 
-    snprintf (out_buf, len-1, "1%s%08x%08x%08x%08x%08x",
-      (unsigned char *) salt.salt_buf,
+    free (data_buf);
+  }
+  else if (hash_mode == 11700)
+  {
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x",
       digest_buf[0],
       digest_buf[1],
       digest_buf[2],
       digest_buf[3],
-      digest_buf[4]);
+      digest_buf[4],
+      digest_buf[5],
+      digest_buf[6],
+      digest_buf[7]);
   }
-  else if (hash_mode == 8200)
+  else if (hash_mode == 11800)
   {
-    cloudkey_t *cloudkeys = (cloudkey_t *) data.esalts_buf;
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+      digest_buf[ 0],
+      digest_buf[ 1],
+      digest_buf[ 2],
+      digest_buf[ 3],
+      digest_buf[ 4],
+      digest_buf[ 5],
+      digest_buf[ 6],
+      digest_buf[ 7],
+      digest_buf[ 8],
+      digest_buf[ 9],
+      digest_buf[10],
+      digest_buf[11],
+      digest_buf[12],
+      digest_buf[13],
+      digest_buf[14],
+      digest_buf[15]);
+  }
+  else if (hash_mode == 11900)
+  {
+    uint digest_idx = salt.digests_offset + digest_pos;
 
-    cloudkey_t *cloudkey = &cloudkeys[salt_pos];
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
 
-    char data_buf[4096] = { 0 };
+    snprintf (out_buf, len-1, "%s", hash_buf);
+  }
+  else if (hash_mode == 12000)
+  {
+    uint digest_idx = salt.digests_offset + digest_pos;
 
-    for (int i = 0, j = 0; i < 512; i += 1, j += 8)
-    {
-      sprintf (data_buf + j, "%08x", cloudkey->data_buf[i]);
-    }
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
 
-    data_buf[cloudkey->data_len * 2] = 0;
+    snprintf (out_buf, len-1, "%s", hash_buf);
+  }
+  else if (hash_mode == 12100)
+  {
+    uint digest_idx = salt.digests_offset + digest_pos;
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
-    digest_buf[5] = byte_swap_32 (digest_buf[5]);
-    digest_buf[6] = byte_swap_32 (digest_buf[6]);
-    digest_buf[7] = byte_swap_32 (digest_buf[7]);
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
 
-    salt.salt_buf[0] = byte_swap_32 (salt.salt_buf[0]);
-    salt.salt_buf[1] = byte_swap_32 (salt.salt_buf[1]);
-    salt.salt_buf[2] = byte_swap_32 (salt.salt_buf[2]);
-    salt.salt_buf[3] = byte_swap_32 (salt.salt_buf[3]);
+    snprintf (out_buf, len-1, "%s", hash_buf);
+  }
+  else if (hash_mode == 12200)
+  {
+    uint *ptr_digest = digest_buf;
+    uint *ptr_salt   = salt.salt_buf;
 
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x:%08x%08x%08x%08x:%u:%s",
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4],
-      digest_buf[5],
-      digest_buf[6],
-      digest_buf[7],
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      salt.salt_iter + 1,
-      data_buf);
+    snprintf (out_buf, len-1, "%s0$1$%08x%08x$%08x%08x",
+      SIGNATURE_ECRYPTFS,
+      ptr_salt[0],
+      ptr_salt[1],
+      ptr_digest[0],
+      ptr_digest[1]);
   }
-  else if (hash_mode == 8300)
+  else if (hash_mode == 12300)
   {
-    char digest_buf_c[34] = { 0 };
+    uint *ptr_digest = digest_buf;
+    uint *ptr_salt   = salt.salt_buf;
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
+    snprintf (out_buf, len-1, "%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X",
+      ptr_digest[ 0], ptr_digest[ 1],
+      ptr_digest[ 2], ptr_digest[ 3],
+      ptr_digest[ 4], ptr_digest[ 5],
+      ptr_digest[ 6], ptr_digest[ 7],
+      ptr_digest[ 8], ptr_digest[ 9],
+      ptr_digest[10], ptr_digest[11],
+      ptr_digest[12], ptr_digest[13],
+      ptr_digest[14], ptr_digest[15],
+      ptr_salt[0],
+      ptr_salt[1],
+      ptr_salt[2],
+      ptr_salt[3]);
+  }
+  else if (hash_mode == 12400)
+  {
+    // encode iteration count
 
-    base32_encode (int_to_itoa32, (const u8 *) digest_buf, 20, (u8 *) digest_buf_c);
+    char salt_iter[5] = { 0 };
 
-    digest_buf_c[32] = 0;
+    salt_iter[0] = int_to_itoa64 ((salt.salt_iter      ) & 0x3f);
+    salt_iter[1] = int_to_itoa64 ((salt.salt_iter >>  6) & 0x3f);
+    salt_iter[2] = int_to_itoa64 ((salt.salt_iter >> 12) & 0x3f);
+    salt_iter[3] = int_to_itoa64 ((salt.salt_iter >> 18) & 0x3f);
+    salt_iter[4] = 0;
 
-    // domain
+    // encode salt
 
-    const uint salt_pc_len = salt.salt_buf_pc[7]; // what a hack
+    ptr_salt[0] = int_to_itoa64 ((salt.salt_buf[0]      ) & 0x3f);
+    ptr_salt[1] = int_to_itoa64 ((salt.salt_buf[0] >>  6) & 0x3f);
+    ptr_salt[2] = int_to_itoa64 ((salt.salt_buf[0] >> 12) & 0x3f);
+    ptr_salt[3] = int_to_itoa64 ((salt.salt_buf[0] >> 18) & 0x3f);
+    ptr_salt[4] = 0;
 
-    char domain_buf_c[33] = { 0 };
+    // encode digest
 
-    memcpy (domain_buf_c, (char *) salt.salt_buf_pc, salt_pc_len);
+    memset (tmp_buf, 0, sizeof (tmp_buf));
 
-    for (uint i = 0; i < salt_pc_len; i++)
-    {
-      const char next = domain_buf_c[i];
+    digest_buf[0] = byte_swap_32 (digest_buf[0]);
+    digest_buf[1] = byte_swap_32 (digest_buf[1]);
 
-      domain_buf_c[i] = '.';
+    memcpy (tmp_buf, digest_buf, 8);
 
-      i += next;
-    }
+    base64_encode (int_to_itoa64, (const u8 *) tmp_buf, 8, (u8 *) ptr_plain);
 
-    domain_buf_c[salt_pc_len] = 0;
+    ptr_plain[11] = 0;
 
-    // final
+    // fill the resulting buffer
 
-    snprintf (out_buf, len-1, "%s:%s:%s:%u", digest_buf_c, domain_buf_c, (char *) salt.salt_buf, salt.salt_iter);
+    snprintf (out_buf, len - 1, "_%s%s%s", salt_iter, ptr_salt, ptr_plain);
   }
-  else if (hash_mode == 8500)
+  else if (hash_mode == 12500)
   {
-    snprintf (out_buf, len-1, "%s*%s*%08X%08X", SIGNATURE_RACF, (char *) salt.salt_buf, digest_buf[0], digest_buf[1]);
+    snprintf (out_buf, len - 1, "%s*0*%08x%08x*%08x%08x%08x%08x",
+      SIGNATURE_RAR3,
+      byte_swap_32 (salt.salt_buf[0]),
+      byte_swap_32 (salt.salt_buf[1]),
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      salt.salt_buf[4],
+      salt.salt_buf[5]);
   }
-  else if (hash_mode == 2612)
+  else if (hash_mode == 12600)
   {
-    snprintf (out_buf, len-1, "%s%s$%08x%08x%08x%08x",
-      SIGNATURE_PHPS,
-      (char *) salt.salt_buf,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3]);
+    snprintf (out_buf, len - 1, "%08x%08x%08x%08x%08x%08x%08x%08x",
+      digest_buf[0] + salt.salt_buf_pc[0],
+      digest_buf[1] + salt.salt_buf_pc[1],
+      digest_buf[2] + salt.salt_buf_pc[2],
+      digest_buf[3] + salt.salt_buf_pc[3],
+      digest_buf[4] + salt.salt_buf_pc[4],
+      digest_buf[5] + salt.salt_buf_pc[5],
+      digest_buf[6] + salt.salt_buf_pc[6],
+      digest_buf[7] + salt.salt_buf_pc[7]);
   }
-  else if (hash_mode == 3711)
+  else if (hash_mode == 12700)
   {
-    char *salt_ptr = (char *) salt.salt_buf;
+    uint digest_idx = salt.digests_offset + digest_pos;
 
-    salt_ptr[salt.salt_len - 1] = 0;
+    hashinfo_t **hashinfo_ptr = data.hash_info;
+    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
 
-    snprintf (out_buf, len-1, "%s%s$%08x%08x%08x%08x",
-      SIGNATURE_MEDIAWIKI_B,
-      salt_ptr,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3]);
+    snprintf (out_buf, len-1, "%s", hash_buf);
   }
-  else if (hash_mode == 8800)
+  else if (hash_mode == 12800)
   {
-    androidfde_t *androidfdes = (androidfde_t *) data.esalts_buf;
-
-    androidfde_t *androidfde = &androidfdes[salt_pos];
-
-    char tmp[3073] = { 0 };
-
-    for (uint i = 0, j = 0; i < 384; i += 1, j += 8)
-    {
-      sprintf (tmp + j, "%08x", androidfde->data[i]);
-    }
-
-    tmp[3072] = 0;
+    const u8 *ptr = (const u8 *) salt.salt_buf;
 
-    snprintf (out_buf, len-1, "%s16$%08x%08x%08x%08x$16$%08x%08x%08x%08x$%s",
-      SIGNATURE_ANDROIDFDE,
-      byte_swap_32 (salt.salt_buf[0]),
-      byte_swap_32 (salt.salt_buf[1]),
-      byte_swap_32 (salt.salt_buf[2]),
-      byte_swap_32 (salt.salt_buf[3]),
+    snprintf (out_buf, len-1, "%s,%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x,%d,%08x%08x%08x%08x%08x%08x%08x%08x",
+      SIGNATURE_MS_DRSR,
+      ptr[0],
+      ptr[1],
+      ptr[2],
+      ptr[3],
+      ptr[4],
+      ptr[5],
+      ptr[6],
+      ptr[7],
+      ptr[8],
+      ptr[9],
+      salt.salt_iter + 1,
+      byte_swap_32 (digest_buf[0]),
+      byte_swap_32 (digest_buf[1]),
+      byte_swap_32 (digest_buf[2]),
+      byte_swap_32 (digest_buf[3]),
+      byte_swap_32 (digest_buf[4]),
+      byte_swap_32 (digest_buf[5]),
+      byte_swap_32 (digest_buf[6]),
+      byte_swap_32 (digest_buf[7])
+    );
+  }
+  else if (hash_mode == 12900)
+  {
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+      salt.salt_buf[ 4],
+      salt.salt_buf[ 5],
+      salt.salt_buf[ 6],
+      salt.salt_buf[ 7],
+      salt.salt_buf[ 8],
+      salt.salt_buf[ 9],
+      salt.salt_buf[10],
+      salt.salt_buf[11],
       byte_swap_32 (digest_buf[0]),
       byte_swap_32 (digest_buf[1]),
       byte_swap_32 (digest_buf[2]),
       byte_swap_32 (digest_buf[3]),
-      tmp);
+      byte_swap_32 (digest_buf[4]),
+      byte_swap_32 (digest_buf[5]),
+      byte_swap_32 (digest_buf[6]),
+      byte_swap_32 (digest_buf[7]),
+      salt.salt_buf[ 0],
+      salt.salt_buf[ 1],
+      salt.salt_buf[ 2],
+      salt.salt_buf[ 3]
+    );
   }
-  else if (hash_mode == 8900)
+  else if (hash_mode == 13000)
   {
-    uint N = salt.scrypt_N;
-    uint r = salt.scrypt_r;
-    uint p = salt.scrypt_p;
-
-    char base64_salt[32] = { 0 };
-
-    base64_encode (int_to_base64, (const u8 *) salt.salt_buf, salt.salt_len, (u8 *) base64_salt);
-
-    memset (tmp_buf, 0, 46);
-
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
-    digest_buf[5] = byte_swap_32 (digest_buf[5]);
-    digest_buf[6] = byte_swap_32 (digest_buf[6]);
-    digest_buf[7] = byte_swap_32 (digest_buf[7]);
-    digest_buf[8] = 0; // needed for base64_encode ()
+    rar5_t *rar5s = (rar5_t *) data.esalts_buf;
 
-    base64_encode (int_to_base64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
+    rar5_t *rar5 = &rar5s[salt_pos];
 
-    snprintf (out_buf, len-1, "%s:%i:%i:%i:%s:%s",
-      SIGNATURE_SCRYPT,
-      N,
-      r,
-      p,
-      base64_salt,
-      tmp_buf);
-  }
-  else if (hash_mode == 9000)
-  {
-    snprintf (out_buf, len-1, "%s", hashfile);
+    snprintf (out_buf, len-1, "$rar5$16$%08x%08x%08x%08x$%u$%08x%08x%08x%08x$8$%08x%08x",
+      salt.salt_buf[0],
+      salt.salt_buf[1],
+      salt.salt_buf[2],
+      salt.salt_buf[3],
+      salt.salt_sign[0],
+      rar5->iv[0],
+      rar5->iv[1],
+      rar5->iv[2],
+      rar5->iv[3],
+      byte_swap_32 (digest_buf[0]),
+      byte_swap_32 (digest_buf[1])
+    );
   }
-  else if (hash_mode == 9200)
+  else if (hash_mode == 13100)
   {
-    // salt
-
-    pbkdf2_sha256_t *pbkdf2_sha256s = (pbkdf2_sha256_t *) data.esalts_buf;
-
-    pbkdf2_sha256_t *pbkdf2_sha256  = &pbkdf2_sha256s[salt_pos];
-
-    unsigned char *salt_buf_ptr = (unsigned char *) pbkdf2_sha256->salt_buf;
-
-    // hash
-
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
-    digest_buf[5] = byte_swap_32 (digest_buf[5]);
-    digest_buf[6] = byte_swap_32 (digest_buf[6]);
-    digest_buf[7] = byte_swap_32 (digest_buf[7]);
-    digest_buf[8] = 0; // needed for base64_encode ()
+    krb5tgs_t *krb5tgss = (krb5tgs_t *) data.esalts_buf;
 
-    char tmp_buf[64] = { 0 };
+    krb5tgs_t *krb5tgs = &krb5tgss[salt_pos];
 
-    base64_encode (int_to_itoa64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
-    tmp_buf[43] = 0; // cut it here
+    u8 *ptr_checksum  = (u8 *) krb5tgs->checksum;
+    u8 *ptr_edata2 = (u8 *) krb5tgs->edata2;
 
-    // output
+    char data[2560 * 4 * 2] = { 0 };
 
-    snprintf (out_buf, len-1, "%s%s$%s", SIGNATURE_CISCO8, salt_buf_ptr, tmp_buf);
-  }
-  else if (hash_mode == 9300)
-  {
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
-    digest_buf[5] = byte_swap_32 (digest_buf[5]);
-    digest_buf[6] = byte_swap_32 (digest_buf[6]);
-    digest_buf[7] = byte_swap_32 (digest_buf[7]);
-    digest_buf[8] = 0; // needed for base64_encode ()
+    char *ptr_data = data;
 
-    char tmp_buf[64] = { 0 };
+    for (uint i = 0; i < 16; i++, ptr_data += 2)
+      sprintf (ptr_data, "%02x", ptr_checksum[i]);
 
-    base64_encode (int_to_itoa64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
-    tmp_buf[43] = 0; // cut it here
+    /* skip '$' */
+    ptr_data++;
 
-    unsigned char *salt_buf_ptr = (unsigned char *) salt.salt_buf;
+    for (uint i = 0; i < krb5tgs->edata2_len; i++, ptr_data += 2)
+      sprintf (ptr_data, "%02x", ptr_edata2[i]);
 
-    snprintf (out_buf, len-1, "%s%s$%s", SIGNATURE_CISCO9, salt_buf_ptr, tmp_buf);
+    snprintf (out_buf, len-1, "%s$%s$%s$%s",
+      SIGNATURE_KRB5TGS,
+      (char *) krb5tgs->account_info,
+      data,
+      data + 33);
   }
-  else if (hash_mode == 9400)
+  else if (hash_mode == 13200)
   {
-    office2007_t *office2007s = (office2007_t *) data.esalts_buf;
-
-    office2007_t *office2007 = &office2007s[salt_pos];
-
-    snprintf (out_buf, len-1, "%s*%u*%u*%u*%u*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x",
-      SIGNATURE_OFFICE2007,
-      2007,
-      20,
-      office2007->keySize,
-      16,
+    snprintf (out_buf, len-1, "%s*%d*%08x%08x%08x%08x*%08x%08x%08x%08x%08x%08x",
+      SIGNATURE_AXCRYPT,
+      salt.salt_iter,
       salt.salt_buf[0],
       salt.salt_buf[1],
       salt.salt_buf[2],
       salt.salt_buf[3],
-      office2007->encryptedVerifier[0],
-      office2007->encryptedVerifier[1],
-      office2007->encryptedVerifier[2],
-      office2007->encryptedVerifier[3],
-      office2007->encryptedVerifierHash[0],
-      office2007->encryptedVerifierHash[1],
-      office2007->encryptedVerifierHash[2],
-      office2007->encryptedVerifierHash[3],
-      office2007->encryptedVerifierHash[4]);
+      salt.salt_buf[4],
+      salt.salt_buf[5],
+      salt.salt_buf[6],
+      salt.salt_buf[7],
+      salt.salt_buf[8],
+      salt.salt_buf[9]);
   }
-  else if (hash_mode == 9500)
+  else if (hash_mode == 13300)
   {
-    office2010_t *office2010s = (office2010_t *) data.esalts_buf;
+    snprintf (out_buf, len-1, "%s$%08x%08x%08x%08x",
+      SIGNATURE_AXCRYPT_SHA1,
+              digest_buf[0],
+              digest_buf[1],
+              digest_buf[2],
+              digest_buf[3]);
+  }
+  else if (hash_mode == 13400)
+  {
+    keepass_t *keepasss = (keepass_t *) data.esalts_buf;
 
-    office2010_t *office2010 = &office2010s[salt_pos];
+    keepass_t *keepass = &keepasss[salt_pos];
 
-    snprintf (out_buf, len-1, "%s*%u*%u*%u*%u*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x%08x%08x%08x", SIGNATURE_OFFICE2010, 2010, 100000, 128, 16,
+    u32 version     = (u32) keepass->version;
+    u32 rounds      = salt.salt_iter;
+    u32 algorithm   = (u32) keepass->algorithm;
+    u32 keyfile_len = (u32) keepass->keyfile_len;
 
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      office2010->encryptedVerifier[0],
-      office2010->encryptedVerifier[1],
-      office2010->encryptedVerifier[2],
-      office2010->encryptedVerifier[3],
-      office2010->encryptedVerifierHash[0],
-      office2010->encryptedVerifierHash[1],
-      office2010->encryptedVerifierHash[2],
-      office2010->encryptedVerifierHash[3],
-      office2010->encryptedVerifierHash[4],
-      office2010->encryptedVerifierHash[5],
-      office2010->encryptedVerifierHash[6],
-      office2010->encryptedVerifierHash[7]);
-  }
-  else if (hash_mode == 9600)
-  {
-    office2013_t *office2013s = (office2013_t *) data.esalts_buf;
+    u32 *ptr_final_random_seed  = (u32 *) keepass->final_random_seed ;
+    u32 *ptr_transf_random_seed = (u32 *) keepass->transf_random_seed ;
+    u32 *ptr_enc_iv             = (u32 *) keepass->enc_iv ;
+    u32 *ptr_contents_hash      = (u32 *) keepass->contents_hash ;
+    u32 *ptr_keyfile            = (u32 *) keepass->keyfile ;
 
-    office2013_t *office2013 = &office2013s[salt_pos];
+    /* specific to version 1 */
+    u32 contents_len;
+    u32 *ptr_contents;
 
-    snprintf (out_buf, len-1, "%s*%u*%u*%u*%u*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x%08x%08x%08x", SIGNATURE_OFFICE2013, 2013, 100000, 256, 16,
+    /* specific to version 2 */
+    u32 expected_bytes_len;
+    u32 *ptr_expected_bytes;
 
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      office2013->encryptedVerifier[0],
-      office2013->encryptedVerifier[1],
-      office2013->encryptedVerifier[2],
-      office2013->encryptedVerifier[3],
-      office2013->encryptedVerifierHash[0],
-      office2013->encryptedVerifierHash[1],
-      office2013->encryptedVerifierHash[2],
-      office2013->encryptedVerifierHash[3],
-      office2013->encryptedVerifierHash[4],
-      office2013->encryptedVerifierHash[5],
-      office2013->encryptedVerifierHash[6],
-      office2013->encryptedVerifierHash[7]);
-  }
-  else if (hash_mode == 9700)
-  {
-    oldoffice01_t *oldoffice01s = (oldoffice01_t *) data.esalts_buf;
+    u32 final_random_seed_len;
+    u32 transf_random_seed_len;
+    u32 enc_iv_len;
+    u32 contents_hash_len;
 
-    oldoffice01_t *oldoffice01 = &oldoffice01s[salt_pos];
+    transf_random_seed_len = 8;
+    enc_iv_len             = 4;
+    contents_hash_len      = 8;
+    final_random_seed_len  = 8;
+
+    if (version == 1)
+      final_random_seed_len = 4;
+
+    snprintf (out_buf, len-1, "%s*%d*%d*%d",
+      SIGNATURE_KEEPASS,
+      version,
+      rounds,
+      algorithm);
+
+    char *ptr_data = out_buf;
+
+    ptr_data += strlen(out_buf);
+
+    *ptr_data = '*';
+    ptr_data++;
+
+    for (uint i = 0; i < final_random_seed_len; i++, ptr_data += 8)
+      sprintf (ptr_data, "%08x", ptr_final_random_seed[i]);
+
+    *ptr_data = '*';
+    ptr_data++;
+
+    for (uint i = 0; i < transf_random_seed_len; i++, ptr_data += 8)
+      sprintf (ptr_data, "%08x", ptr_transf_random_seed[i]);
+
+    *ptr_data = '*';
+    ptr_data++;
 
-    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x",
-      (oldoffice01->version == 0) ? SIGNATURE_OLDOFFICE0 : SIGNATURE_OLDOFFICE1,
-      byte_swap_32 (salt.salt_buf[0]),
-      byte_swap_32 (salt.salt_buf[1]),
-      byte_swap_32 (salt.salt_buf[2]),
-      byte_swap_32 (salt.salt_buf[3]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[0]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[1]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[2]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[3]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[0]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[1]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[2]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[3]));
-  }
-  else if (hash_mode == 9710)
-  {
-    oldoffice01_t *oldoffice01s = (oldoffice01_t *) data.esalts_buf;
+    for (uint i = 0; i < enc_iv_len; i++, ptr_data += 8)
+      sprintf (ptr_data, "%08x", ptr_enc_iv[i]);
 
-    oldoffice01_t *oldoffice01 = &oldoffice01s[salt_pos];
+    *ptr_data = '*';
+    ptr_data++;
 
-    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x",
-      (oldoffice01->version == 0) ? SIGNATURE_OLDOFFICE0 : SIGNATURE_OLDOFFICE1,
-      byte_swap_32 (salt.salt_buf[0]),
-      byte_swap_32 (salt.salt_buf[1]),
-      byte_swap_32 (salt.salt_buf[2]),
-      byte_swap_32 (salt.salt_buf[3]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[0]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[1]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[2]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[3]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[0]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[1]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[2]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[3]));
-  }
-  else if (hash_mode == 9720)
-  {
-    oldoffice01_t *oldoffice01s = (oldoffice01_t *) data.esalts_buf;
+    if (version == 1)
+    {
+      contents_len = (u32)   keepass->contents_len;
+      ptr_contents = (u32 *) keepass->contents;
 
-    oldoffice01_t *oldoffice01 = &oldoffice01s[salt_pos];
+      for (uint i = 0; i < contents_hash_len; i++, ptr_data += 8)
+        sprintf (ptr_data, "%08x", ptr_contents_hash[i]);
 
-    u8 *rc4key = (u8 *) oldoffice01->rc4key;
+      *ptr_data = '*';
+      ptr_data++;
 
-    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x:%02x%02x%02x%02x%02x",
-      (oldoffice01->version == 0) ? SIGNATURE_OLDOFFICE0 : SIGNATURE_OLDOFFICE1,
-      byte_swap_32 (salt.salt_buf[0]),
-      byte_swap_32 (salt.salt_buf[1]),
-      byte_swap_32 (salt.salt_buf[2]),
-      byte_swap_32 (salt.salt_buf[3]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[0]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[1]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[2]),
-      byte_swap_32 (oldoffice01->encryptedVerifier[3]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[0]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[1]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[2]),
-      byte_swap_32 (oldoffice01->encryptedVerifierHash[3]),
-      rc4key[0],
-      rc4key[1],
-      rc4key[2],
-      rc4key[3],
-      rc4key[4]);
-  }
-  else if (hash_mode == 9800)
-  {
-    oldoffice34_t *oldoffice34s = (oldoffice34_t *) data.esalts_buf;
+      /* inline flag */
+      *ptr_data = '1';
+      ptr_data++;
 
-    oldoffice34_t *oldoffice34 = &oldoffice34s[salt_pos];
+      *ptr_data = '*';
+      ptr_data++;
 
-    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x",
-      (oldoffice34->version == 3) ? SIGNATURE_OLDOFFICE3 : SIGNATURE_OLDOFFICE4,
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      byte_swap_32 (oldoffice34->encryptedVerifier[0]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[1]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[2]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[3]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[0]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[1]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[2]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[3]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[4]));
-  }
-  else if (hash_mode == 9810)
-  {
-    oldoffice34_t *oldoffice34s = (oldoffice34_t *) data.esalts_buf;
+      char ptr_contents_len[10] = { 0 };
 
-    oldoffice34_t *oldoffice34 = &oldoffice34s[salt_pos];
+      sprintf ((char*) ptr_contents_len, "%d", contents_len);
 
-    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x",
-      (oldoffice34->version == 3) ? SIGNATURE_OLDOFFICE3 : SIGNATURE_OLDOFFICE4,
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      byte_swap_32 (oldoffice34->encryptedVerifier[0]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[1]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[2]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[3]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[0]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[1]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[2]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[3]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[4]));
-  }
-  else if (hash_mode == 9820)
-  {
-    oldoffice34_t *oldoffice34s = (oldoffice34_t *) data.esalts_buf;
+      sprintf (ptr_data, "%d", contents_len);
 
-    oldoffice34_t *oldoffice34 = &oldoffice34s[salt_pos];
+      ptr_data += strlen(ptr_contents_len);
 
-    u8 *rc4key = (u8 *) oldoffice34->rc4key;
+      *ptr_data = '*';
+      ptr_data++;
 
-    snprintf (out_buf, len-1, "%s*%08x%08x%08x%08x*%08x%08x%08x%08x*%08x%08x%08x%08x%08x:%02x%02x%02x%02x%02x",
-      (oldoffice34->version == 3) ? SIGNATURE_OLDOFFICE3 : SIGNATURE_OLDOFFICE4,
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      byte_swap_32 (oldoffice34->encryptedVerifier[0]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[1]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[2]),
-      byte_swap_32 (oldoffice34->encryptedVerifier[3]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[0]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[1]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[2]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[3]),
-      byte_swap_32 (oldoffice34->encryptedVerifierHash[4]),
-      rc4key[0],
-      rc4key[1],
-      rc4key[2],
-      rc4key[3],
-      rc4key[4]);
-  }
-  else if (hash_mode == 10000)
-  {
-    // salt
+      for (uint i = 0; i < contents_len / 4; i++, ptr_data += 8)
+        sprintf (ptr_data, "%08x", ptr_contents[i]);
+    }
+    else if (version == 2)
+    {
+      expected_bytes_len = 8;
+      ptr_expected_bytes = (u32 *) keepass->expected_bytes ;
 
-    pbkdf2_sha256_t *pbkdf2_sha256s = (pbkdf2_sha256_t *) data.esalts_buf;
+      for (uint i = 0; i < expected_bytes_len; i++, ptr_data += 8)
+        sprintf (ptr_data, "%08x", ptr_expected_bytes[i]);
 
-    pbkdf2_sha256_t *pbkdf2_sha256  = &pbkdf2_sha256s[salt_pos];
+      *ptr_data = '*';
+      ptr_data++;
 
-    unsigned char *salt_buf_ptr = (unsigned char *) pbkdf2_sha256->salt_buf;
+      for (uint i = 0; i < contents_hash_len; i++, ptr_data += 8)
+        sprintf (ptr_data, "%08x", ptr_contents_hash[i]);
+    }
+    if (keyfile_len)
+    {
+      *ptr_data = '*';
+      ptr_data++;
 
-    // hash
+      /* inline flag */
+      *ptr_data = '1';
+      ptr_data++;
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
-    digest_buf[2] = byte_swap_32 (digest_buf[2]);
-    digest_buf[3] = byte_swap_32 (digest_buf[3]);
-    digest_buf[4] = byte_swap_32 (digest_buf[4]);
-    digest_buf[5] = byte_swap_32 (digest_buf[5]);
-    digest_buf[6] = byte_swap_32 (digest_buf[6]);
-    digest_buf[7] = byte_swap_32 (digest_buf[7]);
-    digest_buf[8] = 0; // needed for base64_encode ()
+      *ptr_data = '*';
+      ptr_data++;
 
-    char tmp_buf[64] = { 0 };
+      sprintf (ptr_data, "%d", keyfile_len);
 
-    base64_encode (int_to_base64, (const u8 *) digest_buf, 32, (u8 *) tmp_buf);
+      ptr_data += 2;
 
-    // output
+      *ptr_data = '*';
+      ptr_data++;
 
-    snprintf (out_buf, len-1, "%s%i$%s$%s", SIGNATURE_DJANGOPBKDF2, salt.salt_iter + 1, salt_buf_ptr, tmp_buf);
+      for (uint i = 0; i < 8; i++, ptr_data += 8)
+        sprintf (ptr_data, "%08x", ptr_keyfile[i]);
+    }
   }
-  else if (hash_mode == 10100)
+  else if (hash_mode == 13500)
   {
-    snprintf (out_buf, len-1, "%08x%08x:%u:%u:%08x%08x%08x%08x",
+    pstoken_t *pstokens = (pstoken_t *) data.esalts_buf;
+
+    pstoken_t *pstoken = &pstokens[salt_pos];
+
+    const u32 salt_len = (pstoken->salt_len > 512) ? 512 : pstoken->salt_len;
+
+    char pstoken_tmp[1024 + 1] = { 0 };
+
+    for (uint i = 0, j = 0; i < salt_len; i += 1, j += 2)
+    {
+      const u8 *ptr = (const u8 *) pstoken->salt_buf;
+
+      sprintf (pstoken_tmp + j, "%02x", ptr[i]);
+    }
+
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x:%s",
       digest_buf[0],
       digest_buf[1],
-      2,
-      4,
-      byte_swap_32 (salt.salt_buf[0]),
-      byte_swap_32 (salt.salt_buf[1]),
-      byte_swap_32 (salt.salt_buf[2]),
-      byte_swap_32 (salt.salt_buf[3]));
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4],
+      pstoken_tmp);
   }
-  else if (hash_mode == 10200)
+  else if (hash_mode == 13600)
   {
-    cram_md5_t *cram_md5s = (cram_md5_t *) data.esalts_buf;
+    zip2_t *zip2s = (zip2_t *) data.esalts_buf;
 
-    cram_md5_t *cram_md5 = &cram_md5s[salt_pos];
+    zip2_t *zip2 = &zip2s[salt_pos];
 
-    // challenge
+    const u32 salt_len = zip2->salt_len;
 
-    char challenge[100] = { 0 };
+    char salt_tmp[32 + 1] = { 0 };
 
-    base64_encode (int_to_base64, (const u8 *) salt.salt_buf, salt.salt_len, (u8 *) challenge);
+    for (uint i = 0, j = 0; i < salt_len; i += 1, j += 2)
+    {
+      const u8 *ptr = (const u8 *) zip2->salt_buf;
 
-    // response
+      sprintf (salt_tmp + j, "%02x", ptr[i]);
+    }
+
+    const u32 data_len = zip2->data_len;
+
+    char data_tmp[8192 + 1] = { 0 };
+
+    for (uint i = 0, j = 0; i < data_len; i += 1, j += 2)
+    {
+      const u8 *ptr = (const u8 *) zip2->data_buf;
+
+      sprintf (data_tmp + j, "%02x", ptr[i]);
+    }
 
-    char tmp_buf[100] = { 0 };
+    const u32 auth_len = zip2->auth_len;
 
-    uint tmp_len = snprintf (tmp_buf, 100, "%s %08x%08x%08x%08x",
-      (char *) cram_md5->user,
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3]);
+    char auth_tmp[20 + 1] = { 0 };
 
-    char response[100] = { 0 };
+    for (uint i = 0, j = 0; i < auth_len; i += 1, j += 2)
+    {
+      const u8 *ptr = (const u8 *) zip2->auth_buf;
 
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, tmp_len, (u8 *) response);
+      sprintf (auth_tmp + j, "%02x", ptr[i]);
+    }
 
-    snprintf (out_buf, len-1, "%s%s$%s", SIGNATURE_CRAM_MD5, challenge, response);
+    snprintf (out_buf, 255, "%s*%u*%u*%u*%s*%x*%u*%s*%s*%s",
+      SIGNATURE_ZIP2_START,
+      zip2->type,
+      zip2->mode,
+      zip2->magic,
+      salt_tmp,
+      zip2->verify_bytes,
+      zip2->compress_length,
+      data_tmp,
+      auth_tmp,
+      SIGNATURE_ZIP2_STOP);
   }
-  else if (hash_mode == 10300)
+  else if ((hash_mode >= 13700) && (hash_mode <= 13799))
   {
-    char tmp_buf[100] = { 0 };
-
-    memcpy (tmp_buf +  0, digest_buf, 20);
-    memcpy (tmp_buf + 20, salt.salt_buf, salt.salt_len);
-
-    uint tmp_len = 20 + salt.salt_len;
+    snprintf (out_buf, len-1, "%s", hashfile);
+  }
+  else if (hash_mode == 13800)
+  {
+    win8phone_t *esalts = (win8phone_t *) data.esalts_buf;
 
-    // base64 encode it
+    win8phone_t *esalt = &esalts[salt_pos];
 
-    char base64_encoded[100] = { 0 };
+    char buf[256 + 1] = { 0 };
 
-    base64_encode (int_to_base64, (const u8 *) tmp_buf, tmp_len, (u8 *) base64_encoded);
+    for (int i = 0, j = 0; i < 32; i += 1, j += 8)
+    {
+      sprintf (buf + j, "%08x", esalt->salt_buf[i]);
+    }
 
-    snprintf (out_buf, len-1, "%s%i}%s", SIGNATURE_SAPH_SHA1, salt.salt_iter + 1, base64_encoded);
+    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x:%s",
+      digest_buf[0],
+      digest_buf[1],
+      digest_buf[2],
+      digest_buf[3],
+      digest_buf[4],
+      digest_buf[5],
+      digest_buf[6],
+      digest_buf[7],
+      buf);
   }
-  else if (hash_mode == 10400)
+  else
   {
-    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
+    if (hash_type == HASH_TYPE_MD4)
+    {
+      snprintf (out_buf, 255, "%08x%08x%08x%08x",
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3]);
+    }
+    else if (hash_type == HASH_TYPE_MD5)
+    {
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x",
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3]);
+    }
+    else if (hash_type == HASH_TYPE_SHA1)
+    {
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3],
+        digest_buf[4]);
+    }
+    else if (hash_type == HASH_TYPE_SHA256)
+    {
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x",
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3],
+        digest_buf[4],
+        digest_buf[5],
+        digest_buf[6],
+        digest_buf[7]);
+    }
+    else if (hash_type == HASH_TYPE_SHA384)
+    {
+      uint *ptr = digest_buf;
 
-    pdf_t *pdf = &pdfs[salt_pos];
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+        ptr[ 1], ptr[ 0],
+        ptr[ 3], ptr[ 2],
+        ptr[ 5], ptr[ 4],
+        ptr[ 7], ptr[ 6],
+        ptr[ 9], ptr[ 8],
+        ptr[11], ptr[10]);
+    }
+    else if (hash_type == HASH_TYPE_SHA512)
+    {
+      uint *ptr = digest_buf;
 
-    snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+        ptr[ 1], ptr[ 0],
+        ptr[ 3], ptr[ 2],
+        ptr[ 5], ptr[ 4],
+        ptr[ 7], ptr[ 6],
+        ptr[ 9], ptr[ 8],
+        ptr[11], ptr[10],
+        ptr[13], ptr[12],
+        ptr[15], ptr[14]);
+    }
+    else if (hash_type == HASH_TYPE_LM)
+    {
+      snprintf (out_buf, len-1, "%08x%08x",
+        digest_buf[0],
+        digest_buf[1]);
+    }
+    else if (hash_type == HASH_TYPE_ORACLEH)
+    {
+      snprintf (out_buf, len-1, "%08X%08X",
+        digest_buf[0],
+        digest_buf[1]);
+    }
+    else if (hash_type == HASH_TYPE_BCRYPT)
+    {
+      base64_encode (int_to_bf64, (const u8 *) salt.salt_buf, 16, (u8 *) tmp_buf + 0);
+      base64_encode (int_to_bf64, (const u8 *) digest_buf,    23, (u8 *) tmp_buf + 22);
 
-      pdf->V,
-      pdf->R,
-      40,
-      pdf->P,
-      pdf->enc_md,
-      pdf->id_len,
-      byte_swap_32 (pdf->id_buf[0]),
-      byte_swap_32 (pdf->id_buf[1]),
-      byte_swap_32 (pdf->id_buf[2]),
-      byte_swap_32 (pdf->id_buf[3]),
-      pdf->u_len,
-      byte_swap_32 (pdf->u_buf[0]),
-      byte_swap_32 (pdf->u_buf[1]),
-      byte_swap_32 (pdf->u_buf[2]),
-      byte_swap_32 (pdf->u_buf[3]),
-      byte_swap_32 (pdf->u_buf[4]),
-      byte_swap_32 (pdf->u_buf[5]),
-      byte_swap_32 (pdf->u_buf[6]),
-      byte_swap_32 (pdf->u_buf[7]),
-      pdf->o_len,
-      byte_swap_32 (pdf->o_buf[0]),
-      byte_swap_32 (pdf->o_buf[1]),
-      byte_swap_32 (pdf->o_buf[2]),
-      byte_swap_32 (pdf->o_buf[3]),
-      byte_swap_32 (pdf->o_buf[4]),
-      byte_swap_32 (pdf->o_buf[5]),
-      byte_swap_32 (pdf->o_buf[6]),
-      byte_swap_32 (pdf->o_buf[7])
-    );
-  }
-  else if (hash_mode == 10410)
-  {
-    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
+      tmp_buf[22 + 31] = 0; // base64_encode wants to pad
 
-    pdf_t *pdf = &pdfs[salt_pos];
+      snprintf (out_buf, len-1, "%s$%s", (char *) salt.salt_sign, tmp_buf);
+    }
+    else if (hash_type == HASH_TYPE_KECCAK)
+    {
+      uint *ptr = digest_buf;
 
-    snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+        ptr[ 1], ptr[ 0],
+        ptr[ 3], ptr[ 2],
+        ptr[ 5], ptr[ 4],
+        ptr[ 7], ptr[ 6],
+        ptr[ 9], ptr[ 8],
+        ptr[11], ptr[10],
+        ptr[13], ptr[12],
+        ptr[15], ptr[14],
+        ptr[17], ptr[16],
+        ptr[19], ptr[18],
+        ptr[21], ptr[20],
+        ptr[23], ptr[22],
+        ptr[25], ptr[24],
+        ptr[27], ptr[26],
+        ptr[29], ptr[28],
+        ptr[31], ptr[30],
+        ptr[33], ptr[32],
+        ptr[35], ptr[34],
+        ptr[37], ptr[36],
+        ptr[39], ptr[38],
+        ptr[41], ptr[30],
+        ptr[43], ptr[42],
+        ptr[45], ptr[44],
+        ptr[47], ptr[46],
+        ptr[49], ptr[48]
+      );
 
-      pdf->V,
-      pdf->R,
-      40,
-      pdf->P,
-      pdf->enc_md,
-      pdf->id_len,
-      byte_swap_32 (pdf->id_buf[0]),
-      byte_swap_32 (pdf->id_buf[1]),
-      byte_swap_32 (pdf->id_buf[2]),
-      byte_swap_32 (pdf->id_buf[3]),
-      pdf->u_len,
-      byte_swap_32 (pdf->u_buf[0]),
-      byte_swap_32 (pdf->u_buf[1]),
-      byte_swap_32 (pdf->u_buf[2]),
-      byte_swap_32 (pdf->u_buf[3]),
-      byte_swap_32 (pdf->u_buf[4]),
-      byte_swap_32 (pdf->u_buf[5]),
-      byte_swap_32 (pdf->u_buf[6]),
-      byte_swap_32 (pdf->u_buf[7]),
-      pdf->o_len,
-      byte_swap_32 (pdf->o_buf[0]),
-      byte_swap_32 (pdf->o_buf[1]),
-      byte_swap_32 (pdf->o_buf[2]),
-      byte_swap_32 (pdf->o_buf[3]),
-      byte_swap_32 (pdf->o_buf[4]),
-      byte_swap_32 (pdf->o_buf[5]),
-      byte_swap_32 (pdf->o_buf[6]),
-      byte_swap_32 (pdf->o_buf[7])
-    );
-  }
-  else if (hash_mode == 10420)
-  {
-    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
+      out_buf[salt.keccak_mdlen * 2] = 0;
+    }
+    else if (hash_type == HASH_TYPE_RIPEMD160)
+    {
+      snprintf (out_buf, 255, "%08x%08x%08x%08x%08x",
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3],
+        digest_buf[4]);
+    }
+    else if (hash_type == HASH_TYPE_WHIRLPOOL)
+    {
+      digest_buf[ 0] = digest_buf[ 0];
+      digest_buf[ 1] = digest_buf[ 1];
+      digest_buf[ 2] = digest_buf[ 2];
+      digest_buf[ 3] = digest_buf[ 3];
+      digest_buf[ 4] = digest_buf[ 4];
+      digest_buf[ 5] = digest_buf[ 5];
+      digest_buf[ 6] = digest_buf[ 6];
+      digest_buf[ 7] = digest_buf[ 7];
+      digest_buf[ 8] = digest_buf[ 8];
+      digest_buf[ 9] = digest_buf[ 9];
+      digest_buf[10] = digest_buf[10];
+      digest_buf[11] = digest_buf[11];
+      digest_buf[12] = digest_buf[12];
+      digest_buf[13] = digest_buf[13];
+      digest_buf[14] = digest_buf[14];
+      digest_buf[15] = digest_buf[15];
 
-    pdf_t *pdf = &pdfs[salt_pos];
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
+        digest_buf[ 0],
+        digest_buf[ 1],
+        digest_buf[ 2],
+        digest_buf[ 3],
+        digest_buf[ 4],
+        digest_buf[ 5],
+        digest_buf[ 6],
+        digest_buf[ 7],
+        digest_buf[ 8],
+        digest_buf[ 9],
+        digest_buf[10],
+        digest_buf[11],
+        digest_buf[12],
+        digest_buf[13],
+        digest_buf[14],
+        digest_buf[15]);
+    }
+    else if (hash_type == HASH_TYPE_GOST)
+    {
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x",
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3],
+        digest_buf[4],
+        digest_buf[5],
+        digest_buf[6],
+        digest_buf[7]);
+    }
+    else if (hash_type == HASH_TYPE_MYSQL)
+    {
+      snprintf (out_buf, len-1, "%08x%08x",
+        digest_buf[0],
+        digest_buf[1]);
+    }
+    else if (hash_type == HASH_TYPE_LOTUS5)
+    {
+      snprintf (out_buf, len-1, "%08x%08x%08x%08x",
+        digest_buf[0],
+        digest_buf[1],
+        digest_buf[2],
+        digest_buf[3]);
+    }
+    else if (hash_type == HASH_TYPE_LOTUS6)
+    {
+      digest_buf[ 0] = byte_swap_32 (digest_buf[ 0]);
+      digest_buf[ 1] = byte_swap_32 (digest_buf[ 1]);
+      digest_buf[ 2] = byte_swap_32 (digest_buf[ 2]);
+      digest_buf[ 3] = byte_swap_32 (digest_buf[ 3]);
 
-    u8 *rc4key = (u8 *) pdf->rc4key;
+      char buf[16] = { 0 };
 
-    snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x:%02x%02x%02x%02x%02x",
+      memcpy (buf + 0, salt.salt_buf, 5);
+      memcpy (buf + 5, digest_buf, 9);
 
-      pdf->V,
-      pdf->R,
-      40,
-      pdf->P,
-      pdf->enc_md,
-      pdf->id_len,
-      byte_swap_32 (pdf->id_buf[0]),
-      byte_swap_32 (pdf->id_buf[1]),
-      byte_swap_32 (pdf->id_buf[2]),
-      byte_swap_32 (pdf->id_buf[3]),
-      pdf->u_len,
-      byte_swap_32 (pdf->u_buf[0]),
-      byte_swap_32 (pdf->u_buf[1]),
-      byte_swap_32 (pdf->u_buf[2]),
-      byte_swap_32 (pdf->u_buf[3]),
-      byte_swap_32 (pdf->u_buf[4]),
-      byte_swap_32 (pdf->u_buf[5]),
-      byte_swap_32 (pdf->u_buf[6]),
-      byte_swap_32 (pdf->u_buf[7]),
-      pdf->o_len,
-      byte_swap_32 (pdf->o_buf[0]),
-      byte_swap_32 (pdf->o_buf[1]),
-      byte_swap_32 (pdf->o_buf[2]),
-      byte_swap_32 (pdf->o_buf[3]),
-      byte_swap_32 (pdf->o_buf[4]),
-      byte_swap_32 (pdf->o_buf[5]),
-      byte_swap_32 (pdf->o_buf[6]),
-      byte_swap_32 (pdf->o_buf[7]),
-      rc4key[0],
-      rc4key[1],
-      rc4key[2],
-      rc4key[3],
-      rc4key[4]
-    );
-  }
-  else if (hash_mode == 10500)
-  {
-    pdf_t *pdfs = (pdf_t *) data.esalts_buf;
+      buf[3] -= -4;
 
-    pdf_t *pdf = &pdfs[salt_pos];
+      base64_encode (int_to_lotus64, (const u8 *) buf, 14, (u8 *) tmp_buf);
 
-    if (pdf->id_len == 32)
-    {
-      snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
+      tmp_buf[18] = salt.salt_buf_pc[7];
+      tmp_buf[19] = 0;
 
-        pdf->V,
-        pdf->R,
-        128,
-        pdf->P,
-        pdf->enc_md,
-        pdf->id_len,
-        byte_swap_32 (pdf->id_buf[0]),
-        byte_swap_32 (pdf->id_buf[1]),
-        byte_swap_32 (pdf->id_buf[2]),
-        byte_swap_32 (pdf->id_buf[3]),
-        byte_swap_32 (pdf->id_buf[4]),
-        byte_swap_32 (pdf->id_buf[5]),
-        byte_swap_32 (pdf->id_buf[6]),
-        byte_swap_32 (pdf->id_buf[7]),
-        pdf->u_len,
-        byte_swap_32 (pdf->u_buf[0]),
-        byte_swap_32 (pdf->u_buf[1]),
-        byte_swap_32 (pdf->u_buf[2]),
-        byte_swap_32 (pdf->u_buf[3]),
-        byte_swap_32 (pdf->u_buf[4]),
-        byte_swap_32 (pdf->u_buf[5]),
-        byte_swap_32 (pdf->u_buf[6]),
-        byte_swap_32 (pdf->u_buf[7]),
-        pdf->o_len,
-        byte_swap_32 (pdf->o_buf[0]),
-        byte_swap_32 (pdf->o_buf[1]),
-        byte_swap_32 (pdf->o_buf[2]),
-        byte_swap_32 (pdf->o_buf[3]),
-        byte_swap_32 (pdf->o_buf[4]),
-        byte_swap_32 (pdf->o_buf[5]),
-        byte_swap_32 (pdf->o_buf[6]),
-        byte_swap_32 (pdf->o_buf[7])
-      );
+      snprintf (out_buf, len-1, "(G%s)", tmp_buf);
     }
-    else
+    else if (hash_type == HASH_TYPE_LOTUS8)
     {
-      snprintf (out_buf, len-1, "$pdf$%d*%d*%d*%d*%d*%d*%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x*%d*%08x%08x%08x%08x%08x%08x%08x%08x",
+      char buf[52] = { 0 };
 
-        pdf->V,
-        pdf->R,
-        128,
-        pdf->P,
-        pdf->enc_md,
-        pdf->id_len,
-        byte_swap_32 (pdf->id_buf[0]),
-        byte_swap_32 (pdf->id_buf[1]),
-        byte_swap_32 (pdf->id_buf[2]),
-        byte_swap_32 (pdf->id_buf[3]),
-        pdf->u_len,
-        byte_swap_32 (pdf->u_buf[0]),
-        byte_swap_32 (pdf->u_buf[1]),
-        byte_swap_32 (pdf->u_buf[2]),
-        byte_swap_32 (pdf->u_buf[3]),
-        byte_swap_32 (pdf->u_buf[4]),
-        byte_swap_32 (pdf->u_buf[5]),
-        byte_swap_32 (pdf->u_buf[6]),
-        byte_swap_32 (pdf->u_buf[7]),
-        pdf->o_len,
-        byte_swap_32 (pdf->o_buf[0]),
-        byte_swap_32 (pdf->o_buf[1]),
-        byte_swap_32 (pdf->o_buf[2]),
-        byte_swap_32 (pdf->o_buf[3]),
-        byte_swap_32 (pdf->o_buf[4]),
-        byte_swap_32 (pdf->o_buf[5]),
-        byte_swap_32 (pdf->o_buf[6]),
-        byte_swap_32 (pdf->o_buf[7])
-      );
-    }
-  }
-  else if (hash_mode == 10600)
-  {
-    uint digest_idx = salt.digests_offset + digest_pos;
+      // salt
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+      memcpy (buf + 0, salt.salt_buf, 16);
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
-  }
-  else if (hash_mode == 10700)
-  {
-    uint digest_idx = salt.digests_offset + digest_pos;
+      buf[3] -= -4;
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+      // iteration
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
-  }
-  else if (hash_mode == 10900)
-  {
-    uint digest_idx = salt.digests_offset + digest_pos;
+      snprintf (buf + 16, 11, "%010i", salt.salt_iter + 1);
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+      // chars
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
-  }
-  else if (hash_mode == 11100)
-  {
-    u32 salt_challenge = salt.salt_buf[0];
+      buf[26] = salt.salt_buf_pc[0];
+      buf[27] = salt.salt_buf_pc[1];
 
-    salt_challenge = byte_swap_32 (salt_challenge);
+      // digest
 
-    unsigned char *user_name = (unsigned char *) (salt.salt_buf + 1);
+      memcpy (buf + 28, digest_buf, 8);
 
-    snprintf (out_buf, len-1, "%s%s*%08x*%08x%08x%08x%08x",
-        SIGNATURE_POSTGRESQL_AUTH,
-        user_name,
-        salt_challenge,
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3]);
-  }
-  else if (hash_mode == 11200)
-  {
-    snprintf (out_buf, len-1, "%s%s*%08x%08x%08x%08x%08x",
-        SIGNATURE_MYSQL_AUTH,
-        (unsigned char *) salt.salt_buf,
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3],
-        digest_buf[4]);
+      base64_encode (int_to_lotus64, (const u8 *) buf, 36, (u8 *) tmp_buf);
+
+      tmp_buf[49] = 0;
+
+      snprintf (out_buf, len-1, "(H%s)", tmp_buf);
+    }
+    else if (hash_type == HASH_TYPE_CRC32)
+    {
+      snprintf (out_buf, len-1, "%08x", byte_swap_32 (digest_buf[0]));
+    }
   }
-  else if (hash_mode == 11300)
+
+  if (salt_type == SALT_TYPE_INTERN)
   {
-    bitcoin_wallet_t *bitcoin_wallets = (bitcoin_wallet_t *) data.esalts_buf;
+    size_t pos = strlen (out_buf);
 
-    bitcoin_wallet_t *bitcoin_wallet = &bitcoin_wallets[salt_pos];
+    out_buf[pos] = data.separator;
 
-    const uint cry_master_len = bitcoin_wallet->cry_master_len;
-    const uint ckey_len       = bitcoin_wallet->ckey_len;
-    const uint public_key_len = bitcoin_wallet->public_key_len;
+    char *ptr = (char *) salt.salt_buf;
 
-    char *cry_master_buf = (char *) mymalloc ((cry_master_len * 2) + 1);
-    char *ckey_buf       = (char *) mymalloc ((ckey_len * 2)       + 1);
-    char *public_key_buf = (char *) mymalloc ((public_key_len * 2) + 1);
+    memcpy (out_buf + pos + 1, ptr, salt.salt_len);
 
-    for (uint i = 0, j = 0; i < cry_master_len; i += 1, j += 2)
-    {
-      const u8 *ptr = (const u8 *) bitcoin_wallet->cry_master_buf;
+    out_buf[pos + 1 + salt.salt_len] = 0;
+  }
+}
 
-      sprintf (cry_master_buf + j, "%02x", ptr[i]);
-    }
+void to_hccap_t (hccap_t *hccap, uint salt_pos, uint digest_pos)
+{
+  memset (hccap, 0, sizeof (hccap_t));
 
-    for (uint i = 0, j = 0; i < ckey_len; i += 1, j += 2)
-    {
-      const u8 *ptr = (const u8 *) bitcoin_wallet->ckey_buf;
+  salt_t *salt = &data.salts_buf[salt_pos];
 
-      sprintf (ckey_buf + j, "%02x", ptr[i]);
-    }
+  memcpy (hccap->essid, salt->salt_buf, salt->salt_len);
 
-    for (uint i = 0, j = 0; i < public_key_len; i += 1, j += 2)
-    {
-      const u8 *ptr = (const u8 *) bitcoin_wallet->public_key_buf;
+  wpa_t *wpas = (wpa_t *) data.esalts_buf;
+  wpa_t *wpa  = &wpas[salt_pos];
 
-      sprintf (public_key_buf + j, "%02x", ptr[i]);
-    }
+  hccap->keyver = wpa->keyver;
 
-    snprintf (out_buf, len-1, "%s%d$%s$%d$%s$%d$%d$%s$%d$%s",
-      SIGNATURE_BITCOIN_WALLET,
-      cry_master_len * 2,
-      cry_master_buf,
-      salt.salt_len,
-      (unsigned char *) salt.salt_buf,
-      salt.salt_iter + 1,
-      ckey_len * 2,
-      ckey_buf,
-      public_key_len * 2,
-      public_key_buf
-    );
+  hccap->eapol_size = wpa->eapol_size;
 
-    free (cry_master_buf);
-    free (ckey_buf);
-    free (public_key_buf);
-  }
-  else if (hash_mode == 11400)
+  if (wpa->keyver != 1)
   {
-    uint digest_idx = salt.digests_offset + digest_pos;
+    uint eapol_tmp[64] = { 0 };
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+    for (uint i = 0; i < 64; i++)
+    {
+      eapol_tmp[i] = byte_swap_32 (wpa->eapol[i]);
+    }
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
+    memcpy (hccap->eapol, eapol_tmp, wpa->eapol_size);
   }
-  else if (hash_mode == 11600)
+  else
   {
-    seven_zip_t *seven_zips = (seven_zip_t *) data.esalts_buf;
+    memcpy (hccap->eapol, wpa->eapol, wpa->eapol_size);
+  }
 
-    seven_zip_t *seven_zip = &seven_zips[salt_pos];
+  memcpy (hccap->mac1,   wpa->orig_mac1,    6);
+  memcpy (hccap->mac2,   wpa->orig_mac2,    6);
+  memcpy (hccap->nonce1, wpa->orig_nonce1, 32);
+  memcpy (hccap->nonce2, wpa->orig_nonce2, 32);
 
-    const uint data_len = seven_zip->data_len;
+  char *digests_buf_ptr = (char *) data.digests_buf;
 
-    char *data_buf = (char *) mymalloc ((data_len * 2) + 1);
+  uint dgst_size = data.dgst_size;
 
-    for (uint i = 0, j = 0; i < data_len; i += 1, j += 2)
-    {
-      const u8 *ptr = (const u8 *) seven_zip->data_buf;
+  uint *digest_ptr = (uint *) (digests_buf_ptr + (data.salts_buf[salt_pos].digests_offset * dgst_size) + (digest_pos * dgst_size));
 
-      sprintf (data_buf + j, "%02x", ptr[i]);
-    }
+  if (wpa->keyver != 1)
+  {
+    uint digest_tmp[4] = { 0 };
 
-    snprintf (out_buf, len-1, "%s%u$%u$%u$%s$%u$%08x%08x%08x%08x$%u$%u$%u$%s",
-      SIGNATURE_SEVEN_ZIP,
-      0,
-      salt.salt_sign[0],
-      0,
-      (char *) seven_zip->salt_buf,
-      seven_zip->iv_len,
-      seven_zip->iv_buf[0],
-      seven_zip->iv_buf[1],
-      seven_zip->iv_buf[2],
-      seven_zip->iv_buf[3],
-      seven_zip->crc,
-      seven_zip->data_len,
-      seven_zip->unpack_size,
-      data_buf);
+    digest_tmp[0] = byte_swap_32 (digest_ptr[0]);
+    digest_tmp[1] = byte_swap_32 (digest_ptr[1]);
+    digest_tmp[2] = byte_swap_32 (digest_ptr[2]);
+    digest_tmp[3] = byte_swap_32 (digest_ptr[3]);
 
-    free (data_buf);
+    memcpy (hccap->keymic, digest_tmp, 16);
   }
-  else if (hash_mode == 11700)
+  else
   {
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x",
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4],
-      digest_buf[5],
-      digest_buf[6],
-      digest_buf[7]);
+    memcpy (hccap->keymic, digest_ptr, 16);
   }
-  else if (hash_mode == 11800)
+}
+
+void SuspendThreads ()
+{
+  if (data.devices_status != STATUS_RUNNING) return;
+
+  hc_timer_set (&data.timer_paused);
+
+  data.devices_status = STATUS_PAUSED;
+
+  log_info ("Paused");
+}
+
+void ResumeThreads ()
+{
+  if (data.devices_status != STATUS_PAUSED) return;
+
+  double ms_paused;
+
+  hc_timer_get (data.timer_paused, ms_paused);
+
+  data.ms_paused += ms_paused;
+
+  data.devices_status = STATUS_RUNNING;
+
+  log_info ("Resumed");
+}
+
+void bypass ()
+{
+  data.devices_status = STATUS_BYPASS;
+
+  log_info ("Next dictionary / mask in queue selected, bypassing current one");
+}
+
+void stop_at_checkpoint ()
+{
+  if (data.devices_status != STATUS_STOP_AT_CHECKPOINT)
   {
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-      digest_buf[ 0],
-      digest_buf[ 1],
-      digest_buf[ 2],
-      digest_buf[ 3],
-      digest_buf[ 4],
-      digest_buf[ 5],
-      digest_buf[ 6],
-      digest_buf[ 7],
-      digest_buf[ 8],
-      digest_buf[ 9],
-      digest_buf[10],
-      digest_buf[11],
-      digest_buf[12],
-      digest_buf[13],
-      digest_buf[14],
-      digest_buf[15]);
+    if (data.devices_status != STATUS_RUNNING) return;
   }
-  else if (hash_mode == 11900)
-  {
-    uint digest_idx = salt.digests_offset + digest_pos;
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+  // this feature only makes sense if --restore-disable was not specified
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
-  }
-  else if (hash_mode == 12000)
+  if (data.restore_disable == 1)
   {
-    uint digest_idx = salt.digests_offset + digest_pos;
-
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+    log_info ("WARNING: This feature is disabled when --restore-disable is specified");
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
+    return;
   }
-  else if (hash_mode == 12100)
-  {
-    uint digest_idx = salt.digests_offset + digest_pos;
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+  // check if monitoring of Restore Point updates should be enabled or disabled
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
-  }
-  else if (hash_mode == 12200)
+  if (data.devices_status != STATUS_STOP_AT_CHECKPOINT)
   {
-    uint *ptr_digest = digest_buf;
-    uint *ptr_salt   = salt.salt_buf;
+    data.devices_status = STATUS_STOP_AT_CHECKPOINT;
 
-    snprintf (out_buf, len-1, "%s0$1$%08x%08x$%08x%08x",
-      SIGNATURE_ECRYPTFS,
-      ptr_salt[0],
-      ptr_salt[1],
-      ptr_digest[0],
-      ptr_digest[1]);
+    // save the current restore point value
+
+    data.checkpoint_cur_words = get_lowest_words_done ();
+
+    log_info ("Checkpoint enabled: Will quit at next Restore Point update");
   }
-  else if (hash_mode == 12300)
+  else
   {
-    uint *ptr_digest = digest_buf;
-    uint *ptr_salt   = salt.salt_buf;
+    data.devices_status = STATUS_RUNNING;
 
-    snprintf (out_buf, len-1, "%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X%08X",
-      ptr_digest[ 0], ptr_digest[ 1],
-      ptr_digest[ 2], ptr_digest[ 3],
-      ptr_digest[ 4], ptr_digest[ 5],
-      ptr_digest[ 6], ptr_digest[ 7],
-      ptr_digest[ 8], ptr_digest[ 9],
-      ptr_digest[10], ptr_digest[11],
-      ptr_digest[12], ptr_digest[13],
-      ptr_digest[14], ptr_digest[15],
-      ptr_salt[0],
-      ptr_salt[1],
-      ptr_salt[2],
-      ptr_salt[3]);
+    // reset the global value for checkpoint checks
+
+    data.checkpoint_cur_words = 0;
+
+    log_info ("Checkpoint disabled: Restore Point updates will no longer be monitored");
   }
-  else if (hash_mode == 12400)
-  {
-    // encode iteration count
+}
 
-    char salt_iter[5] = { 0 };
+void myabort ()
+{
+  data.devices_status = STATUS_ABORTED;
+}
+
+void myquit ()
+{
+  data.devices_status = STATUS_QUIT;
+}
 
-    salt_iter[0] = int_to_itoa64 ((salt.salt_iter      ) & 0x3f);
-    salt_iter[1] = int_to_itoa64 ((salt.salt_iter >>  6) & 0x3f);
-    salt_iter[2] = int_to_itoa64 ((salt.salt_iter >> 12) & 0x3f);
-    salt_iter[3] = int_to_itoa64 ((salt.salt_iter >> 18) & 0x3f);
-    salt_iter[4] = 0;
+void naive_replace (char *s, const u8 key_char, const u8 replace_char)
+{
+  const size_t len = strlen (s);
 
-    // encode salt
+  for (size_t in = 0; in < len; in++)
+  {
+    const u8 c = s[in];
 
-    ptr_salt[0] = int_to_itoa64 ((salt.salt_buf[0]      ) & 0x3f);
-    ptr_salt[1] = int_to_itoa64 ((salt.salt_buf[0] >>  6) & 0x3f);
-    ptr_salt[2] = int_to_itoa64 ((salt.salt_buf[0] >> 12) & 0x3f);
-    ptr_salt[3] = int_to_itoa64 ((salt.salt_buf[0] >> 18) & 0x3f);
-    ptr_salt[4] = 0;
+    if (c == key_char)
+    {
+      s[in] = replace_char;
+    }
+  }
+}
 
-    // encode digest
+void naive_escape (char *s, size_t s_max, const u8 key_char, const u8 escape_char)
+{
+  char s_escaped[1024] = { 0 };
 
-    memset (tmp_buf, 0, sizeof (tmp_buf));
+  size_t s_escaped_max = sizeof (s_escaped);
 
-    digest_buf[0] = byte_swap_32 (digest_buf[0]);
-    digest_buf[1] = byte_swap_32 (digest_buf[1]);
+  const size_t len = strlen (s);
 
-    memcpy (tmp_buf, digest_buf, 8);
+  for (size_t in = 0, out = 0; in < len; in++, out++)
+  {
+    const u8 c = s[in];
 
-    base64_encode (int_to_itoa64, (const u8 *) tmp_buf, 8, (u8 *) ptr_plain);
+    if (c == key_char)
+    {
+      s_escaped[out] = escape_char;
 
-    ptr_plain[11] = 0;
+      out++;
+    }
 
-    // fill the resulting buffer
+    if (out == s_escaped_max - 2) break;
 
-    snprintf (out_buf, len - 1, "_%s%s%s", salt_iter, ptr_salt, ptr_plain);
-  }
-  else if (hash_mode == 12500)
-  {
-    snprintf (out_buf, len - 1, "%s*0*%08x%08x*%08x%08x%08x%08x",
-      SIGNATURE_RAR3,
-      byte_swap_32 (salt.salt_buf[0]),
-      byte_swap_32 (salt.salt_buf[1]),
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      salt.salt_buf[4],
-      salt.salt_buf[5]);
-  }
-  else if (hash_mode == 12600)
-  {
-    snprintf (out_buf, len - 1, "%08x%08x%08x%08x%08x%08x%08x%08x",
-      digest_buf[0] + salt.salt_buf_pc[0],
-      digest_buf[1] + salt.salt_buf_pc[1],
-      digest_buf[2] + salt.salt_buf_pc[2],
-      digest_buf[3] + salt.salt_buf_pc[3],
-      digest_buf[4] + salt.salt_buf_pc[4],
-      digest_buf[5] + salt.salt_buf_pc[5],
-      digest_buf[6] + salt.salt_buf_pc[6],
-      digest_buf[7] + salt.salt_buf_pc[7]);
+    s_escaped[out] = c;
   }
-  else if (hash_mode == 12700)
-  {
-    uint digest_idx = salt.digests_offset + digest_pos;
 
-    hashinfo_t **hashinfo_ptr = data.hash_info;
-    char        *hash_buf     = hashinfo_ptr[digest_idx]->orighash;
+  strncpy (s, s_escaped, s_max - 1);
+}
 
-    snprintf (out_buf, len-1, "%s", hash_buf);
-  }
-  else if (hash_mode == 12800)
-  {
-    const u8 *ptr = (const u8 *) salt.salt_buf;
+void load_kernel (const char *kernel_file, int num_devices, size_t *kernel_lengths, const u8 **kernel_sources)
+{
+  FILE *fp = fopen (kernel_file, "rb");
 
-    snprintf (out_buf, len-1, "%s,%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x,%d,%08x%08x%08x%08x%08x%08x%08x%08x",
-      SIGNATURE_MS_DRSR,
-      ptr[0],
-      ptr[1],
-      ptr[2],
-      ptr[3],
-      ptr[4],
-      ptr[5],
-      ptr[6],
-      ptr[7],
-      ptr[8],
-      ptr[9],
-      salt.salt_iter + 1,
-      byte_swap_32 (digest_buf[0]),
-      byte_swap_32 (digest_buf[1]),
-      byte_swap_32 (digest_buf[2]),
-      byte_swap_32 (digest_buf[3]),
-      byte_swap_32 (digest_buf[4]),
-      byte_swap_32 (digest_buf[5]),
-      byte_swap_32 (digest_buf[6]),
-      byte_swap_32 (digest_buf[7])
-    );
-  }
-  else if (hash_mode == 12900)
-  {
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-      salt.salt_buf[ 4],
-      salt.salt_buf[ 5],
-      salt.salt_buf[ 6],
-      salt.salt_buf[ 7],
-      salt.salt_buf[ 8],
-      salt.salt_buf[ 9],
-      salt.salt_buf[10],
-      salt.salt_buf[11],
-      byte_swap_32 (digest_buf[0]),
-      byte_swap_32 (digest_buf[1]),
-      byte_swap_32 (digest_buf[2]),
-      byte_swap_32 (digest_buf[3]),
-      byte_swap_32 (digest_buf[4]),
-      byte_swap_32 (digest_buf[5]),
-      byte_swap_32 (digest_buf[6]),
-      byte_swap_32 (digest_buf[7]),
-      salt.salt_buf[ 0],
-      salt.salt_buf[ 1],
-      salt.salt_buf[ 2],
-      salt.salt_buf[ 3]
-    );
-  }
-  else if (hash_mode == 13000)
+  if (fp != NULL)
   {
-    rar5_t *rar5s = (rar5_t *) data.esalts_buf;
+    struct stat st;
 
-    rar5_t *rar5 = &rar5s[salt_pos];
+    memset (&st, 0, sizeof (st));
 
-    snprintf (out_buf, len-1, "$rar5$16$%08x%08x%08x%08x$%u$%08x%08x%08x%08x$8$%08x%08x",
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      salt.salt_sign[0],
-      rar5->iv[0],
-      rar5->iv[1],
-      rar5->iv[2],
-      rar5->iv[3],
-      byte_swap_32 (digest_buf[0]),
-      byte_swap_32 (digest_buf[1])
-    );
-  }
-  else if (hash_mode == 13100)
-  {
-    krb5tgs_t *krb5tgss = (krb5tgs_t *) data.esalts_buf;
+    stat (kernel_file, &st);
 
-    krb5tgs_t *krb5tgs = &krb5tgss[salt_pos];
+    u8 *buf = (u8 *) mymalloc (st.st_size + 1);
 
-    u8 *ptr_checksum  = (u8 *) krb5tgs->checksum;
-    u8 *ptr_edata2 = (u8 *) krb5tgs->edata2;
+    size_t num_read = fread (buf, sizeof (u8), st.st_size, fp);
 
-    char data[2560 * 4 * 2] = { 0 };
+    if (num_read != (size_t) st.st_size)
+    {
+      log_error ("ERROR: %s: %s", kernel_file, strerror (errno));
 
-    char *ptr_data = data;
+      exit (-1);
+    }
 
-    for (uint i = 0; i < 16; i++, ptr_data += 2)
-      sprintf (ptr_data, "%02x", ptr_checksum[i]);
+    fclose (fp);
 
-    /* skip '$' */
-    ptr_data++;
+    buf[st.st_size] = 0;
 
-    for (uint i = 0; i < krb5tgs->edata2_len; i++, ptr_data += 2)
-      sprintf (ptr_data, "%02x", ptr_edata2[i]);
+    for (int i = 0; i < num_devices; i++)
+    {
+      kernel_lengths[i] = (size_t) st.st_size;
 
-    snprintf (out_buf, len-1, "%s$%s$%s$%s",
-      SIGNATURE_KRB5TGS,
-      (char *) krb5tgs->account_info,
-      data,
-      data + 33);
-  }
-  else if (hash_mode == 13200)
-  {
-    snprintf (out_buf, len-1, "%s*%d*%08x%08x%08x%08x*%08x%08x%08x%08x%08x%08x",
-      SIGNATURE_AXCRYPT,
-      salt.salt_iter,
-      salt.salt_buf[0],
-      salt.salt_buf[1],
-      salt.salt_buf[2],
-      salt.salt_buf[3],
-      salt.salt_buf[4],
-      salt.salt_buf[5],
-      salt.salt_buf[6],
-      salt.salt_buf[7],
-      salt.salt_buf[8],
-      salt.salt_buf[9]);
+      kernel_sources[i] = buf;
+    }
   }
-  else if (hash_mode == 13300)
+  else
   {
-    snprintf (out_buf, len-1, "%s$%08x%08x%08x%08x",
-      SIGNATURE_AXCRYPT_SHA1,
-              digest_buf[0],
-              digest_buf[1],
-              digest_buf[2],
-              digest_buf[3]);
+    log_error ("ERROR: %s: %s", kernel_file, strerror (errno));
+
+    exit (-1);
   }
-  else if (hash_mode == 13400)
+
+  return;
+}
+
+void writeProgramBin (char *dst, u8 *binary, size_t binary_size)
+{
+  if (binary_size > 0)
   {
-    keepass_t *keepasss = (keepass_t *) data.esalts_buf;
+    // devices with the same checksum are initialized in parallel and may write the same cached kernel
+    // so write to a private temporary file and rename it, a reader never sees a partially written kernel
 
-    keepass_t *keepass = &keepasss[salt_pos];
+    char tmp[256] = { 0 };
 
-    u32 version     = (u32) keepass->version;
-    u32 rounds      = salt.salt_iter;
-    u32 algorithm   = (u32) keepass->algorithm;
-    u32 keyfile_len = (u32) keepass->keyfile_len;
+    snprintf (tmp, sizeof (tmp) - 1, "%s.%u.%p", dst, (uint) getpid (), (void *) binary);
 
-    u32 *ptr_final_random_seed  = (u32 *) keepass->final_random_seed ;
-    u32 *ptr_transf_random_seed = (u32 *) keepass->transf_random_seed ;
-    u32 *ptr_enc_iv             = (u32 *) keepass->enc_iv ;
-    u32 *ptr_contents_hash      = (u32 *) keepass->contents_hash ;
-    u32 *ptr_keyfile            = (u32 *) keepass->keyfile ;
+    FILE *fp = fopen (tmp, "wb");
 
-    /* specific to version 1 */
-    u32 contents_len;
-    u32 *ptr_contents;
+    if (fp == NULL) return;
 
-    /* specific to version 2 */
-    u32 expected_bytes_len;
-    u32 *ptr_expected_bytes;
+    lock_file (fp);
+    fwrite (binary, sizeof (u8), binary_size, fp);
 
-    u32 final_random_seed_len;
-    u32 transf_random_seed_len;
-    u32 enc_iv_len;
-    u32 contents_hash_len;
+    fflush (fp);
+    fclose (fp);
+
+    #ifdef _WIN
+    unlink (dst);
+    #endif
+
+    if (rename (tmp, dst) == -1) unlink (tmp);
+  }
+}
 
-    transf_random_seed_len = 8;
-    enc_iv_len             = 4;
-    contents_hash_len      = 8;
-    final_random_seed_len  = 8;
+/**
+ * restore
+ */
 
-    if (version == 1)
-      final_random_seed_len = 4;
+restore_data_t *init_restore (int argc, char **argv)
+{
+  restore_data_t *rd = (restore_data_t *) mymalloc (sizeof (restore_data_t));
 
-    snprintf (out_buf, len-1, "%s*%d*%d*%d",
-      SIGNATURE_KEEPASS,
-      version,
-      rounds,
-      algorithm);
+  if (data.restore_disable == 0)
+  {
+    FILE *fp = fopen (data.eff_restore_file, "rb");
 
-    char *ptr_data = out_buf;
+    if (fp)
+    {
+      size_t nread = fread (rd, sizeof (restore_data_t), 1, fp);
 
-    ptr_data += strlen(out_buf);
+      if (nread != 1)
+      {
+        log_error ("ERROR: Cannot read %s", data.eff_restore_file);
 
-    *ptr_data = '*';
-    ptr_data++;
+        exit (-1);
+      }
 
-    for (uint i = 0; i < final_random_seed_len; i++, ptr_data += 8)
-      sprintf (ptr_data, "%08x", ptr_final_random_seed[i]);
+      fclose (fp);
 
-    *ptr_data = '*';
-    ptr_data++;
+      if (rd->pid)
+      {
+        char *pidbin = (char *) mymalloc (HCBUFSIZ);
 
-    for (uint i = 0; i < transf_random_seed_len; i++, ptr_data += 8)
-      sprintf (ptr_data, "%08x", ptr_transf_random_seed[i]);
+        int pidbin_len = -1;
 
-    *ptr_data = '*';
-    ptr_data++;
+        #ifdef _POSIX
+        snprintf (pidbin, HCBUFSIZ - 1, "/proc/%d/cmdline", rd->pid);
 
-    for (uint i = 0; i < enc_iv_len; i++, ptr_data += 8)
-      sprintf (ptr_data, "%08x", ptr_enc_iv[i]);
+        FILE *fd = fopen (pidbin, "rb");
 
-    *ptr_data = '*';
-    ptr_data++;
+        if (fd)
+        {
+          pidbin_len = fread (pidbin, 1, HCBUFSIZ, fd);
 
-    if (version == 1)
-    {
-      contents_len = (u32)   keepass->contents_len;
-      ptr_contents = (u32 *) keepass->contents;
+          pidbin[pidbin_len] = 0;
 
-      for (uint i = 0; i < contents_hash_len; i++, ptr_data += 8)
-        sprintf (ptr_data, "%08x", ptr_contents_hash[i]);
+          fclose (fd);
 
-      *ptr_data = '*';
-      ptr_data++;
+          char *argv0_r = strrchr (argv[0], '/');
 
-      /* inline flag */
-      *ptr_data = '1';
-      ptr_data++;
+          char *pidbin_r = strrchr (pidbin, '/');
 
-      *ptr_data = '*';
-      ptr_data++;
+          if (argv0_r == NULL) argv0_r = argv[0];
 
-      char ptr_contents_len[10] = { 0 };
+          if (pidbin_r == NULL) pidbin_r = pidbin;
 
-      sprintf ((char*) ptr_contents_len, "%d", contents_len);
+          if (strcmp (argv0_r, pidbin_r) == 0)
+          {
+            log_error ("ERROR: Already an instance %s running on pid %d", pidbin, rd->pid);
 
-      sprintf (ptr_data, "%d", contents_len);
+            exit (-1);
+          }
+        }
 
-      ptr_data += strlen(ptr_contents_len);
+        #elif _WIN
+        HANDLE hProcess = OpenProcess (PROCESS_ALL_ACCESS, FALSE, rd->pid);
 
-      *ptr_data = '*';
-      ptr_data++;
+        char *pidbin2 = (char *) mymalloc (HCBUFSIZ);
 
-      for (uint i = 0; i < contents_len / 4; i++, ptr_data += 8)
-        sprintf (ptr_data, "%08x", ptr_contents[i]);
-    }
-    else if (version == 2)
-    {
-      expected_bytes_len = 8;
-      ptr_expected_bytes = (u32 *) keepass->expected_bytes ;
+        int pidbin2_len = -1;
 
-      for (uint i = 0; i < expected_bytes_len; i++, ptr_data += 8)
-        sprintf (ptr_data, "%08x", ptr_expected_bytes[i]);
+        pidbin_len = GetModuleFileName (NULL, pidbin, HCBUFSIZ);
+        pidbin2_len = GetModuleFileNameEx (hProcess, NULL, pidbin2, HCBUFSIZ);
 
-      *ptr_data = '*';
-      ptr_data++;
+        pidbin[pidbin_len] = 0;
+        pidbin2[pidbin2_len] = 0;
 
-      for (uint i = 0; i < contents_hash_len; i++, ptr_data += 8)
-        sprintf (ptr_data, "%08x", ptr_contents_hash[i]);
-    }
-    if (keyfile_len)
-    {
-      *ptr_data = '*';
-      ptr_data++;
+        if (pidbin2_len)
+        {
+          if (strcmp (pidbin, pidbin2) == 0)
+          {
+            log_error ("ERROR: Already an instance %s running on pid %d", pidbin2, rd->pid);
 
-      /* inline flag */
-      *ptr_data = '1';
-      ptr_data++;
+            exit (-1);
+          }
+        }
 
-      *ptr_data = '*';
-      ptr_data++;
+        myfree (pidbin2);
 
-      sprintf (ptr_data, "%d", keyfile_len);
+        #endif
 
-      ptr_data += 2;
+        myfree (pidbin);
+      }
 
-      *ptr_data = '*';
-      ptr_data++;
+      if (rd->version_bin < RESTORE_MIN)
+      {
+        log_error ("ERROR: Cannot use outdated %s. Please remove it.", data.eff_restore_file);
 
-      for (uint i = 0; i < 8; i++, ptr_data += 8)
-        sprintf (ptr_data, "%08x", ptr_keyfile[i]);
+        exit (-1);
+      }
     }
   }
-  else if (hash_mode == 13500)
+
+  memset (rd, 0, sizeof (restore_data_t));
+
+  rd->version_bin = VERSION_BIN;
+
+  #ifdef _POSIX
+  rd->pid = getpid ();
+  #elif _WIN
+  rd->pid = GetCurrentProcessId ();
+  #endif
+
+  if (getcwd (rd->cwd, 255) == NULL)
   {
-    pstoken_t *pstokens = (pstoken_t *) data.esalts_buf;
+    myfree (rd);
 
-    pstoken_t *pstoken = &pstokens[salt_pos];
+    return (NULL);
+  }
 
-    const u32 salt_len = (pstoken->salt_len > 512) ? 512 : pstoken->salt_len;
+  rd->argc = argc;
+  rd->argv = argv;
 
-    char pstoken_tmp[1024 + 1] = { 0 };
+  return (rd);
+}
 
-    for (uint i = 0, j = 0; i < salt_len; i += 1, j += 2)
-    {
-      const u8 *ptr = (const u8 *) pstoken->salt_buf;
+void read_restore (const char *eff_restore_file, restore_data_t *rd)
+{
+  FILE *fp = fopen (eff_restore_file, "rb");
 
-      sprintf (pstoken_tmp + j, "%02x", ptr[i]);
-    }
+  if (fp == NULL)
+  {
+    log_error ("ERROR: Restore file '%s': %s", eff_restore_file, strerror (errno));
 
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x:%s",
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4],
-      pstoken_tmp);
+    exit (-1);
   }
-  else if (hash_mode == 13600)
+
+  if (fread (rd, sizeof (restore_data_t), 1, fp) != 1)
   {
-    zip2_t *zip2s = (zip2_t *) data.esalts_buf;
+    log_error ("ERROR: Can't read %s", eff_restore_file);
 
-    zip2_t *zip2 = &zip2s[salt_pos];
+    exit (-1);
+  }
 
-    const u32 salt_len = zip2->salt_len;
+  rd->argv = (char **) mycalloc (rd->argc, sizeof (char *));
 
-    char salt_tmp[32 + 1] = { 0 };
+  char *buf = (char *) mymalloc (HCBUFSIZ);
 
-    for (uint i = 0, j = 0; i < salt_len; i += 1, j += 2)
+  for (uint i = 0; i < rd->argc; i++)
+  {
+    if (fgets (buf, HCBUFSIZ - 1, fp) == NULL)
     {
-      const u8 *ptr = (const u8 *) zip2->salt_buf;
+      log_error ("ERROR: Can't read %s", eff_restore_file);
 
-      sprintf (salt_tmp + j, "%02x", ptr[i]);
+      exit (-1);
     }
 
-    const u32 data_len = zip2->data_len;
-
-    char data_tmp[8192 + 1] = { 0 };
+    size_t len = strlen (buf);
 
-    for (uint i = 0, j = 0; i < data_len; i += 1, j += 2)
-    {
-      const u8 *ptr = (const u8 *) zip2->data_buf;
+    if (len) buf[len - 1] = 0;
 
-      sprintf (data_tmp + j, "%02x", ptr[i]);
-    }
+    rd->argv[i] = mystrdup (buf);
+  }
 
-    const u32 auth_len = zip2->auth_len;
+  myfree (buf);
 
-    char auth_tmp[20 + 1] = { 0 };
+  fclose (fp);
 
-    for (uint i = 0, j = 0; i < auth_len; i += 1, j += 2)
-    {
-      const u8 *ptr = (const u8 *) zip2->auth_buf;
+  log_info ("INFO: Changing current working directory to the path found within the .restore file: '%s'", rd->cwd);
 
-      sprintf (auth_tmp + j, "%02x", ptr[i]);
-    }
+  if (chdir (rd->cwd))
+  {
+    log_error ("ERROR: The directory '%s' does not exist. It is needed to restore (--restore) the session.\n"
+               "       You could either create this directory (or link it) or update the .restore file using e.g. the analyze_hc_restore.pl tool:\n"
+               "       https://github.com/philsmd/analyze_hc_restore\n"
+               "       The directory must be relative to (or contain) all files/folders mentioned within the command line.", rd->cwd);
 
-    snprintf (out_buf, 255, "%s*%u*%u*%u*%s*%x*%u*%s*%s*%s",
-      SIGNATURE_ZIP2_START,
-      zip2->type,
-      zip2->mode,
-      zip2->magic,
-      salt_tmp,
-      zip2->verify_bytes,
-      zip2->compress_length,
-      data_tmp,
-      auth_tmp,
-      SIGNATURE_ZIP2_STOP);
+    exit (-1);
   }
-  else if ((hash_mode >= 13700) && (hash_mode <= 13799))
+}
+
+u64 get_lowest_words_done ()
+{
+  u64 words_cur = -1;
+
+  for (uint device_id = 0; device_id < data.devices_cnt; device_id++)
   {
-    snprintf (out_buf, len-1, "%s", hashfile);
+    hc_device_param_t *device_param = &data.devices_param[device_id];
+
+    if (device_param->skipped) continue;
+
+    const u64 words_done = device_param->words_done;
+
+    if (words_done < words_cur) words_cur = words_done;
   }
-  else if (hash_mode == 13800)
-  {
-    win8phone_t *esalts = (win8phone_t *) data.esalts_buf;
 
-    win8phone_t *esalt = &esalts[salt_pos];
+  // It's possible that a device's workload isn't finished right after a restore-case.
+  // In that case, this function would return 0 and overwrite the real restore point
+  // There's also data.words_cur which is set to rd->words_cur but it changes while
+  // the attack is running therefore we should stick to rd->words_cur.
+  // Note that -s influences rd->words_cur we should keep a close look on that.
 
-    char buf[256 + 1] = { 0 };
+  if (words_cur < data.rd->words_cur) words_cur = data.rd->words_cur;
 
-    for (int i = 0, j = 0; i < 32; i += 1, j += 8)
-    {
-      sprintf (buf + j, "%08x", esalt->salt_buf[i]);
-    }
+  return words_cur;
+}
 
-    snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x:%s",
-      digest_buf[0],
-      digest_buf[1],
-      digest_buf[2],
-      digest_buf[3],
-      digest_buf[4],
-      digest_buf[5],
-      digest_buf[6],
-      digest_buf[7],
-      buf);
-  }
-  else
-  {
-    if (hash_type == HASH_TYPE_MD4)
-    {
-      snprintf (out_buf, 255, "%08x%08x%08x%08x",
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3]);
-    }
-    else if (hash_type == HASH_TYPE_MD5)
-    {
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x",
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3]);
-    }
-    else if (hash_type == HASH_TYPE_SHA1)
-    {
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x",
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3],
-        digest_buf[4]);
-    }
-    else if (hash_type == HASH_TYPE_SHA256)
-    {
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x",
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3],
-        digest_buf[4],
-        digest_buf[5],
-        digest_buf[6],
-        digest_buf[7]);
-    }
-    else if (hash_type == HASH_TYPE_SHA384)
-    {
-      uint *ptr = digest_buf;
+void write_restore (const char *new_restore_file, restore_data_t *rd)
+{
+  u64 words_cur = get_lowest_words_done ();
 
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-        ptr[ 1], ptr[ 0],
-        ptr[ 3], ptr[ 2],
-        ptr[ 5], ptr[ 4],
-        ptr[ 7], ptr[ 6],
-        ptr[ 9], ptr[ 8],
-        ptr[11], ptr[10]);
-    }
-    else if (hash_type == HASH_TYPE_SHA512)
-    {
-      uint *ptr = digest_buf;
+  rd->words_cur = words_cur;
 
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-        ptr[ 1], ptr[ 0],
-        ptr[ 3], ptr[ 2],
-        ptr[ 5], ptr[ 4],
-        ptr[ 7], ptr[ 6],
-        ptr[ 9], ptr[ 8],
-        ptr[11], ptr[10],
-        ptr[13], ptr[12],
-        ptr[15], ptr[14]);
-    }
-    else if (hash_type == HASH_TYPE_LM)
-    {
-      snprintf (out_buf, len-1, "%08x%08x",
-        digest_buf[0],
-        digest_buf[1]);
-    }
-    else if (hash_type == HASH_TYPE_ORACLEH)
-    {
-      snprintf (out_buf, len-1, "%08X%08X",
-        digest_buf[0],
-        digest_buf[1]);
-    }
-    else if (hash_type == HASH_TYPE_BCRYPT)
-    {
-      base64_encode (int_to_bf64, (const u8 *) salt.salt_buf, 16, (u8 *) tmp_buf + 0);
-      base64_encode (int_to_bf64, (const u8 *) digest_buf,    23, (u8 *) tmp_buf + 22);
+  FILE *fp = fopen (new_restore_file, "wb");
 
-      tmp_buf[22 + 31] = 0; // base64_encode wants to pad
+  if (fp == NULL)
+  {
+    log_error ("ERROR: %s: %s", new_restore_file, strerror (errno));
 
-      snprintf (out_buf, len-1, "%s$%s", (char *) salt.salt_sign, tmp_buf);
-    }
-    else if (hash_type == HASH_TYPE_KECCAK)
-    {
-      uint *ptr = digest_buf;
+    exit (-1);
+  }
 
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-        ptr[ 1], ptr[ 0],
-        ptr[ 3], ptr[ 2],
-        ptr[ 5], ptr[ 4],
-        ptr[ 7], ptr[ 6],
-        ptr[ 9], ptr[ 8],
-        ptr[11], ptr[10],
-        ptr[13], ptr[12],
-        ptr[15], ptr[14],
-        ptr[17], ptr[16],
-        ptr[19], ptr[18],
-        ptr[21], ptr[20],
-        ptr[23], ptr[22],
-        ptr[25], ptr[24],
-        ptr[27], ptr[26],
-        ptr[29], ptr[28],
-        ptr[31], ptr[30],
-        ptr[33], ptr[32],
-        ptr[35], ptr[34],
-        ptr[37], ptr[36],
-        ptr[39], ptr[38],
-        ptr[41], ptr[30],
-        ptr[43], ptr[42],
-        ptr[45], ptr[44],
-        ptr[47], ptr[46],
-        ptr[49], ptr[48]
-      );
+  if (setvbuf (fp, NULL, _IONBF, 0))
+  {
+    log_error ("ERROR: setvbuf file '%s': %s", new_restore_file, strerror (errno));
 
-      out_buf[salt.keccak_mdlen * 2] = 0;
-    }
-    else if (hash_type == HASH_TYPE_RIPEMD160)
-    {
-      snprintf (out_buf, 255, "%08x%08x%08x%08x%08x",
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3],
-        digest_buf[4]);
-    }
-    else if (hash_type == HASH_TYPE_WHIRLPOOL)
-    {
-      digest_buf[ 0] = digest_buf[ 0];
-      digest_buf[ 1] = digest_buf[ 1];
-      digest_buf[ 2] = digest_buf[ 2];
-      digest_buf[ 3] = digest_buf[ 3];
-      digest_buf[ 4] = digest_buf[ 4];
-      digest_buf[ 5] = digest_buf[ 5];
-      digest_buf[ 6] = digest_buf[ 6];
-      digest_buf[ 7] = digest_buf[ 7];
-      digest_buf[ 8] = digest_buf[ 8];
-      digest_buf[ 9] = digest_buf[ 9];
-      digest_buf[10] = digest_buf[10];
-      digest_buf[11] = digest_buf[11];
-      digest_buf[12] = digest_buf[12];
-      digest_buf[13] = digest_buf[13];
-      digest_buf[14] = digest_buf[14];
-      digest_buf[15] = digest_buf[15];
+    exit (-1);
+  }
 
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x%08x",
-        digest_buf[ 0],
-        digest_buf[ 1],
-        digest_buf[ 2],
-        digest_buf[ 3],
-        digest_buf[ 4],
-        digest_buf[ 5],
-        digest_buf[ 6],
-        digest_buf[ 7],
-        digest_buf[ 8],
-        digest_buf[ 9],
-        digest_buf[10],
-        digest_buf[11],
-        digest_buf[12],
-        digest_buf[13],
-        digest_buf[14],
-        digest_buf[15]);
-    }
-    else if (hash_type == HASH_TYPE_GOST)
-    {
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x%08x%08x%08x%08x",
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3],
-        digest_buf[4],
-        digest_buf[5],
-        digest_buf[6],
-        digest_buf[7]);
-    }
-    else if (hash_type == HASH_TYPE_MYSQL)
-    {
-      snprintf (out_buf, len-1, "%08x%08x",
-        digest_buf[0],
-        digest_buf[1]);
-    }
-    else if (hash_type == HASH_TYPE_LOTUS5)
-    {
-      snprintf (out_buf, len-1, "%08x%08x%08x%08x",
-        digest_buf[0],
-        digest_buf[1],
-        digest_buf[2],
-        digest_buf[3]);
-    }
-    else if (hash_type == HASH_TYPE_LOTUS6)
-    {
-      digest_buf[ 0] = byte_swap_32 (digest_buf[ 0]);
-      digest_buf[ 1] = byte_swap_32 (digest_buf[ 1]);
-      digest_buf[ 2] = byte_swap_32 (digest_buf[ 2]);
-      digest_buf[ 3] = byte_swap_32 (digest_buf[ 3]);
+  fwrite (rd, sizeof (restore_data_t), 1, fp);
 
-      char buf[16] = { 0 };
+  for (uint i = 0; i < rd->argc; i++)
+  {
+    fprintf (fp, "%s", rd->argv[i]);
+    fputc ('\n', fp);
+  }
 
-      memcpy (buf + 0, salt.salt_buf, 5);
-      memcpy (buf + 5, digest_buf, 9);
+  fflush (fp);
 
-      buf[3] -= -4;
+  fsync (fileno (fp));
+
+  fclose (fp);
+}
+
+void cycle_restore ()
+{
+  const char *eff_restore_file = data.eff_restore_file;
+  const char *new_restore_file = data.new_restore_file;
 
-      base64_encode (int_to_lotus64, (const u8 *) buf, 14, (u8 *) tmp_buf);
+  restore_data_t *rd = data.rd;
 
-      tmp_buf[18] = salt.salt_buf_pc[7];
-      tmp_buf[19] = 0;
+  write_restore (new_restore_file, rd);
 
-      snprintf (out_buf, len-1, "(G%s)", tmp_buf);
-    }
-    else if (hash_type == HASH_TYPE_LOTUS8)
-    {
-      char buf[52] = { 0 };
+  struct stat st;
 
-      // salt
+  memset (&st, 0, sizeof(st));
 
-      memcpy (buf + 0, salt.salt_buf, 16);
+  if (stat (eff_restore_file, &st) == 0)
+  {
+    if (unlink (eff_restore_file))
+    {
+      log_info ("WARN: Unlink file '%s': %s", eff_restore_file, strerror (errno));
+    }
+  }
 
-      buf[3] -= -4;
+  if (rename (new_restore_file, eff_restore_file))
+  {
+    log_info ("WARN: Rename file '%s' to '%s': %s", new_restore_file, eff_restore_file, strerror (errno));
+  }
+}
 
-      // iteration
+void check_checkpoint ()
+{
+  // if (data.restore_disable == 1) break;  (this is already implied by previous checks)
 
-      snprintf (buf + 16, 11, "%010i", salt.salt_iter + 1);
+  u64 words_cur = get_lowest_words_done ();
 
-      // chars
+  if (words_cur != data.checkpoint_cur_words)
+  {
+    myabort ();
+  }
+}
 
-      buf[26] = salt.salt_buf_pc[0];
-      buf[27] = salt.salt_buf_pc[1];
+/**
+ * tuning db
+ */
 
-      // digest
+void tuning_db_destroy (tuning_db_t *tuning_db)
+{
+  int i;
 
-      memcpy (buf + 28, digest_buf, 8);
+  for (i = 0; i < tuning_db->alias_cnt; i++)
+  {
+    tuning_db_alias_t *alias = &tuning_db->alias_buf[i];
 
-      base64_encode (int_to_lotus64, (const u8 *) buf, 36, (u8 *) tmp_buf);
+    myfree (alias->device_name);
+    myfree (alias->alias_name);
+  }
 
-      tmp_buf[49] = 0;
+  for (i = 0; i < tuning_db->entry_cnt; i++)
+  {
+    tuning_db_entry_t *entry = &tuning_db->entry_buf[i];
 
-      snprintf (out_buf, len-1, "(H%s)", tmp_buf);
-    }
-    else if (hash_type == HASH_TYPE_CRC32)
-    {
-      snprintf (out_buf, len-1, "%08x", byte_swap_32 (digest_buf[0]));
-    }
+    myfree (entry->device_name);
   }
 
-  if (salt_type == SALT_TYPE_INTERN)
+  for (i = 0; i < tuning_db->learned_cnt; i++)
   {
-    size_t pos = strlen (out_buf);
-
-    out_buf[pos] = data.separator;
+    tuning_db_learned_t *learned = &tuning_db->learned_buf[i];
 
-    char *ptr = (char *) salt.salt_buf;
+    myfree (learned->device_name);
+  }
 
-    memcpy (out_buf + pos + 1, ptr, salt.salt_len);
+  myfree (tuning_db->alias_buf);
+  myfree (tuning_db->entry_buf);
+  myfree (tuning_db->learned_buf);
 
-    out_buf[pos + 1 + salt.salt_len] = 0;
-  }
+  myfree (tuning_db);
 }
 
-void to_hccap_t (hccap_t *hccap, uint salt_pos, uint digest_pos)
+tuning_db_t *tuning_db_alloc (FILE *fp)
 {
-  memset (hccap, 0, sizeof (hccap_t));
+  tuning_db_t *tuning_db = (tuning_db_t *) mymalloc (sizeof (tuning_db_t));
 
-  salt_t *salt = &data.salts_buf[salt_pos];
+  int num_lines = count_lines (fp);
 
-  memcpy (hccap->essid, salt->salt_buf, salt->salt_len);
+  // a bit over-allocated
 
-  wpa_t *wpas = (wpa_t *) data.esalts_buf;
-  wpa_t *wpa  = &wpas[salt_pos];
+  tuning_db->alias_buf = (tuning_db_alias_t *) mycalloc (num_lines + 1, sizeof (tuning_db_alias_t));
+  tuning_db->alias_cnt = 0;
 
-  hccap->keyver = wpa->keyver;
+  tuning_db->entry_buf = (tuning_db_entry_t *) mycalloc (num_lines + 1, sizeof (tuning_db_entry_t));
+  tuning_db->entry_cnt = 0;
 
-  hccap->eapol_size = wpa->eapol_size;
+  tuning_db->learned_buf = NULL;
+  tuning_db->learned_cnt = 0;
 
-  if (wpa->keyver != 1)
-  {
-    uint eapol_tmp[64] = { 0 };
+  return tuning_db;
+}
 
-    for (uint i = 0; i < 64; i++)
-    {
-      eapol_tmp[i] = byte_swap_32 (wpa->eapol[i]);
-    }
+tuning_db_t *tuning_db_init (const char *tuning_db_file)
+{
+  FILE *fp = fopen (tuning_db_file, "rb");
 
-    memcpy (hccap->eapol, eapol_tmp, wpa->eapol_size);
-  }
-  else
+  if (fp == NULL)
   {
-    memcpy (hccap->eapol, wpa->eapol, wpa->eapol_size);
+    log_error ("%s: %s", tuning_db_file, strerror (errno));
+
+    exit (-1);
   }
 
-  memcpy (hccap->mac1,   wpa->orig_mac1,    6);
-  memcpy (hccap->mac2,   wpa->orig_mac2,    6);
-  memcpy (hccap->nonce1, wpa->orig_nonce1, 32);
-  memcpy (hccap->nonce2, wpa->orig_nonce2, 32);
+  tuning_db_t *tuning_db = tuning_db_alloc (fp);
 
-  char *digests_buf_ptr = (char *) data.digests_buf;
+  rewind (fp);
 
-  uint dgst_size = data.dgst_size;
+  int line_num = 0;
 
-  uint *digest_ptr = (uint *) (digests_buf_ptr + (data.salts_buf[salt_pos].digests_offset * dgst_size) + (digest_pos * dgst_size));
+  char *buf = (char *) mymalloc (HCBUFSIZ);
 
-  if (wpa->keyver != 1)
+  while (!feof (fp))
   {
-    uint digest_tmp[4] = { 0 };
+    char *line_buf = fgets (buf, HCBUFSIZ - 1, fp);
 
-    digest_tmp[0] = byte_swap_32 (digest_ptr[0]);
-    digest_tmp[1] = byte_swap_32 (digest_ptr[1]);
-    digest_tmp[2] = byte_swap_32 (digest_ptr[2]);
-    digest_tmp[3] = byte_swap_32 (digest_ptr[3]);
+    if (line_buf == NULL) break;
 
-    memcpy (hccap->keymic, digest_tmp, 16);
-  }
-  else
-  {
-    memcpy (hccap->keymic, digest_ptr, 16);
-  }
-}
+    line_num++;
 
-void SuspendThreads ()
-{
-  if (data.devices_status != STATUS_RUNNING) return;
+    const int line_len = in_superchop (line_buf);
 
-  hc_timer_set (&data.timer_paused);
+    if (line_len == 0) continue;
 
-  data.devices_status = STATUS_PAUSED;
+    if (line_buf[0] == '#') continue;
 
-  log_info ("Paused");
-}
+    // start processing
 
-void ResumeThreads ()
-{
-  if (data.devices_status != STATUS_PAUSED) return;
+    char *token_ptr[7] = { NULL };
 
-  double ms_paused;
+    int token_cnt = 0;
 
-  hc_timer_get (data.timer_paused, ms_paused);
+    char *next = strtok (line_buf, "\t ");
 
-  data.ms_paused += ms_paused;
+    token_ptr[token_cnt] = next;
 
-  data.devices_status = STATUS_RUNNING;
+    token_cnt++;
 
-  log_info ("Resumed");
-}
+    while ((next = strtok (NULL, "\t ")) != NULL)
+    {
+      token_ptr[token_cnt] = next;
 
-void bypass ()
-{
-  data.devices_status = STATUS_BYPASS;
+      token_cnt++;
+    }
 
-  log_info ("Next dictionary / mask in queue selected, bypassing current one");
-}
+    if (token_cnt == 2)
+    {
+      char *device_name = token_ptr[0];
+      char *alias_name  = token_ptr[1];
 
-void stop_at_checkpoint ()
-{
-  if (data.devices_status != STATUS_STOP_AT_CHECKPOINT)
-  {
-    if (data.devices_status != STATUS_RUNNING) return;
-  }
+      tuning_db_alias_t *alias = &tuning_db->alias_buf[tuning_db->alias_cnt];
 
-  // this feature only makes sense if --restore-disable was not specified
+      alias->device_name = mystrdup (device_name);
+      alias->alias_name  = mystrdup (alias_name);
+
+      tuning_db->alias_cnt++;
+    }
+    else if (token_cnt == 6)
+    {
+      if ((token_ptr[1][0] != '0') &&
+          (token_ptr[1][0] != '1') &&
+          (token_ptr[1][0] != '3') &&
+          (token_ptr[1][0] != '*'))
+      {
+        log_info ("WARNING: Tuning-db: Invalid attack_mode '%c' in Line '%u'", token_ptr[1][0], line_num);
+
+        continue;
+      }
+
+      if ((token_ptr[3][0] != '1') &&
+          (token_ptr[3][0] != '2') &&
+          (token_ptr[3][0] != '4') &&
+          (token_ptr[3][0] != '8') &&
+          (token_ptr[3][0] != 'N'))
+      {
+        log_info ("WARNING: Tuning-db: Invalid vector_width '%c' in Line '%u'", token_ptr[3][0], line_num);
+
+        continue;
+      }
+
+      char *device_name = token_ptr[0];
+
+      int attack_mode      = -1;
+      int hash_type        = -1;
+      int vector_width     = -1;
+      int kernel_accel     = -1;
+      int kernel_loops     = -1;
+
+      if (token_ptr[1][0] != '*') attack_mode      = atoi (token_ptr[1]);
+      if (token_ptr[2][0] != '*') hash_type        = atoi (token_ptr[2]);
+      if (token_ptr[3][0] != 'N') vector_width     = atoi (token_ptr[3]);
+
+      if (token_ptr[4][0] != 'A')
+      {
+        kernel_accel = atoi (token_ptr[4]);
+
+        if ((kernel_accel < 1) || (kernel_accel > 1024))
+        {
+          log_info ("WARNING: Tuning-db: Invalid kernel_accel '%d' in Line '%u'", kernel_accel, line_num);
+
+          continue;
+        }
+      }
+      else
+      {
+        kernel_accel = 0;
+      }
+
+      if (token_ptr[5][0] != 'A')
+      {
+        kernel_loops = atoi (token_ptr[5]);
+
+        if ((kernel_loops < 1) || (kernel_loops > 1024))
+        {
+          log_info ("WARNING: Tuning-db: Invalid kernel_loops '%d' in Line '%u'", kernel_loops, line_num);
+
+          continue;
+        }
+      }
+      else
+      {
+        kernel_loops = 0;
+      }
 
-  if (data.restore_disable == 1)
-  {
-    log_info ("WARNING: This feature is disabled when --restore-disable is specified");
+      tuning_db_entry_t *entry = &tuning_db->entry_buf[tuning_db->entry_cnt];
 
-    return;
-  }
+      entry->device_name  = mystrdup (device_name);
+      entry->attack_mode  = attack_mode;
+      entry->hash_type    = hash_type;
+      entry->vector_width = vector_width;
+      entry->kernel_accel = kernel_accel;
+      entry->kernel_loops = kernel_loops;
 
-  // check if monitoring of Restore Point updates should be enabled or disabled
+      tuning_db->entry_cnt++;
+    }
+    else
+    {
+      log_info ("WARNING: Tuning-db: Invalid number of token in Line '%u'", line_num);
 
-  if (data.devices_status != STATUS_STOP_AT_CHECKPOINT)
-  {
-    data.devices_status = STATUS_STOP_AT_CHECKPOINT;
+      continue;
+    }
+  }
 
-    // save the current restore point value
+  myfree (buf);
 
-    data.checkpoint_cur_words = get_lowest_words_done ();
+  fclose (fp);
 
-    log_info ("Checkpoint enabled: Will quit at next Restore Point update");
-  }
-  else
-  {
-    data.devices_status = STATUS_RUNNING;
+  // todo: print loaded 'cnt' message
 
-    // reset the global value for checkpoint checks
+  // sort the database
 
-    data.checkpoint_cur_words = 0;
+  qsort (tuning_db->alias_buf, tuning_db->alias_cnt, sizeof (tuning_db_alias_t), sort_by_tuning_db_alias);
+  qsort (tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
 
-    log_info ("Checkpoint disabled: Restore Point updates will no longer be monitored");
-  }
+  return tuning_db;
 }
 
-void myabort ()
+tuning_db_entry_t *tuning_db_search (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type)
 {
-  data.devices_status = STATUS_ABORTED;
-}
+  static tuning_db_entry_t s;
 
-void myquit ()
-{
-  data.devices_status = STATUS_QUIT;
-}
+  // first we need to convert all spaces in the device_name to underscore
 
-void naive_replace (char *s, const u8 key_char, const u8 replace_char)
-{
-  const size_t len = strlen (s);
+  char *device_name_nospace = strdup (device_param->device_name);
 
-  for (size_t in = 0; in < len; in++)
-  {
-    const u8 c = s[in];
+  int device_name_length = strlen (device_name_nospace);
 
-    if (c == key_char)
-    {
-      s[in] = replace_char;
-    }
+  int i;
+
+  for (i = 0; i < device_name_length; i++)
+  {
+    if (device_name_nospace[i] == ' ') device_name_nospace[i] = '_';
   }
-}
 
-void naive_escape (char *s, size_t s_max, const u8 key_char, const u8 escape_char)
-{
-  char s_escaped[1024] = { 0 };
+  // find out if there's an alias configured
 
-  size_t s_escaped_max = sizeof (s_escaped);
+  tuning_db_alias_t a;
 
-  const size_t len = strlen (s);
+  a.device_name = device_name_nospace;
 
-  for (size_t in = 0, out = 0; in < len; in++, out++)
-  {
-    const u8 c = s[in];
+  tuning_db_alias_t *alias = bsearch (&a, tuning_db->alias_buf, tuning_db->alias_cnt, sizeof (tuning_db_alias_t), sort_by_tuning_db_alias);
 
-    if (c == key_char)
-    {
-      s_escaped[out] = escape_char;
+  char *alias_name = (alias == NULL) ? NULL : alias->alias_name;
 
-      out++;
-    }
+  // attack-mode 6 and 7 are attack-mode 1 basically
 
-    if (out == s_escaped_max - 2) break;
+  if (attack_mode == 6) attack_mode = 1;
+  if (attack_mode == 7) attack_mode = 1;
 
-    s_escaped[out] = c;
-  }
+  // bsearch is not ideal but fast enough
 
-  strncpy (s, s_escaped, s_max - 1);
-}
+  s.device_name = device_name_nospace;
+  s.attack_mode = attack_mode;
+  s.hash_type   = hash_type;
 
-void load_kernel (const char *kernel_file, int num_devices, size_t *kernel_lengths, const u8 **kernel_sources)
-{
-  FILE *fp = fopen (kernel_file, "rb");
+  tuning_db_entry_t *entry = NULL;
 
-  if (fp != NULL)
-  {
-    struct stat st;
+  // this will produce all 2^3 combinations required
 
-    memset (&st, 0, sizeof (st));
+  for (i = 0; i < 8; i++)
+  {
+    s.device_name = (i & 1) ? "*" : device_name_nospace;
+    s.attack_mode = (i & 2) ?  -1 : attack_mode;
+    s.hash_type   = (i & 4) ?  -1 : hash_type;
 
-    stat (kernel_file, &st);
+    entry = bsearch (&s, tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
 
-    u8 *buf = (u8 *) mymalloc (st.st_size + 1);
+    if (entry != NULL) break;
 
-    size_t num_read = fread (buf, sizeof (u8), st.st_size, fp);
+    // in non-wildcard mode do some additional checks:
 
-    if (num_read != (size_t) st.st_size)
+    if ((i & 1) == 0)
     {
-      log_error ("ERROR: %s: %s", kernel_file, strerror (errno));
+      // in case we have an alias-name
 
-      exit (-1);
-    }
+      if (alias_name != NULL)
+      {
+        s.device_name = alias_name;
 
-    fclose (fp);
+        entry = bsearch (&s, tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
 
-    buf[st.st_size] = 0;
+        if (entry != NULL) break;
+      }
 
-    for (int i = 0; i < num_devices; i++)
-    {
-      kernel_lengths[i] = (size_t) st.st_size;
+      // or by device type
 
-      kernel_sources[i] = buf;
-    }
-  }
-  else
-  {
-    log_error ("ERROR: %s: %s", kernel_file, strerror (errno));
+      if (device_param->device_type & CL_DEVICE_TYPE_CPU)
+      {
+        s.device_name = "DEVICE_TYPE_CPU";
+      }
+      else if (device_param->device_type & CL_DEVICE_TYPE_GPU)
+      {
+        s.device_name = "DEVICE_TYPE_GPU";
+      }
+      else if (device_param->device_type & CL_DEVICE_TYPE_ACCELERATOR)
+      {
+        s.device_name = "DEVICE_TYPE_ACCELERATOR";
+      }
 
-    exit (-1);
-  }
+      entry = bsearch (&s, tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
 
-  return;
-}
+      if (entry != NULL) break;
+    }
+  }
 
-void writeProgramBin (char *dst, u8 *binary, size_t binary_size)
-{
-  if (binary_size > 0)
-  {
-    FILE *fp = fopen (dst, "wb");
+  // free converted device_name
 
-    lock_file (fp);
-    fwrite (binary, sizeof (u8), binary_size, fp);
+  myfree (device_name_nospace);
 
-    fflush (fp);
-    fclose (fp);
-  }
+  return entry;
 }
 
 /**
- * restore
+ * learned tuning db
  */
 
-restore_data_t *init_restore (int argc, char **argv)
+static char *tuning_db_device_name_nospace (const char *device_name)
 {
-  restore_data_t *rd = (restore_data_t *) mymalloc (sizeof (restore_data_t));
-
-  if (data.restore_disable == 0)
-  {
-    FILE *fp = fopen (data.eff_restore_file, "rb");
+  char *device_name_nospace = mystrdup (device_name);
 
-    if (fp)
-    {
-      size_t nread = fread (rd, sizeof (restore_data_t), 1, fp);
+  const int device_name_length = strlen (device_name_nospace);
 
-      if (nread != 1)
-      {
-        log_error ("ERROR: Cannot read %s", data.eff_restore_file);
+  for (int i = 0; i < device_name_length; i++)
+  {
+    if (device_name_nospace[i] == ' ') device_name_nospace[i] = '_';
+  }
 
-        exit (-1);
-      }
+  return device_name_nospace;
+}
 
-      fclose (fp);
+void tuning_db_learned_load (tuning_db_t *tuning_db, const char *learned_file, const uint max_age)
+{
+  FILE *fp = fopen (learned_file, "rb");
 
-      if (rd->pid)
-      {
-        char *pidbin = (char *) mymalloc (HCBUFSIZ);
+  // no learned results yet is not an error
 
-        int pidbin_len = -1;
+  if (fp == NULL) return;
 
-        #ifdef _POSIX
-        snprintf (pidbin, HCBUFSIZ - 1, "/proc/%d/cmdline", rd->pid);
+  const int num_lines = count_lines (fp);
 
-        FILE *fd = fopen (pidbin, "rb");
+  rewind (fp);
 
-        if (fd)
-        {
-          pidbin_len = fread (pidbin, 1, HCBUFSIZ, fd);
+  tuning_db->learned_buf = (tuning_db_learned_t *) mycalloc (num_lines + 1, sizeof (tuning_db_learned_t));
+  tuning_db->learned_cnt = 0;
 
-          pidbin[pidbin_len] = 0;
+  const u64 now = (u64) time (NULL);
 
-          fclose (fd);
+  int line_num = 0;
 
-          char *argv0_r = strrchr (argv[0], '/');
+  char *buf = (char *) mymalloc (HCBUFSIZ);
 
-          char *pidbin_r = strrchr (pidbin, '/');
+  while (!feof (fp))
+  {
+    char *line_buf = fgets (buf, HCBUFSIZ - 1, fp);
 
-          if (argv0_r == NULL) argv0_r = argv[0];
+    if (line_buf == NULL) break;
 
-          if (pidbin_r == NULL) pidbin_r = pidbin;
+    line_num++;
 
-          if (strcmp (argv0_r, pidbin_r) == 0)
-          {
-            log_error ("ERROR: Already an instance %s running on pid %d", pidbin, rd->pid);
+    const int line_len = in_superchop (line_buf);
 
-            exit (-1);
-          }
-        }
+    // a different signature means the file was written by an incompatible version, start from scratch
 
-        #elif _WIN
-        HANDLE hProcess = OpenProcess (PROCESS_ALL_ACCESS, FALSE, rd->pid);
+    if (line_num == 1)
+    {
+      if (strcmp (line_buf, TUNING_DB_LEARNED_SIGNATURE) != 0) break;
 
-        char *pidbin2 = (char *) mymalloc (HCBUFSIZ);
+      continue;
+    }
 
-        int pidbin2_len = -1;
+    if (line_len == 0) continue;
 
-        pidbin_len = GetModuleFileName (NULL, pidbin, HCBUFSIZ);
-        pidbin2_len = GetModuleFileNameEx (hProcess, NULL, pidbin2, HCBUFSIZ);
+    if (line_buf[0] == '#') continue;
 
-        pidbin[pidbin_len] = 0;
-        pidbin2[pidbin2_len] = 0;
+    char *token_ptr[13] = { NULL };
 
-        if (pidbin2_len)
-        {
-          if (strcmp (pidbin, pidbin2) == 0)
-          {
-            log_error ("ERROR: Already an instance %s running on pid %d", pidbin2, rd->pid);
+    int token_cnt = 0;
 
-            exit (-1);
-          }
-        }
+    char *next = strtok (line_buf, "\t");
 
-        myfree (pidbin2);
+    while ((next != NULL) && (token_cnt < 13))
+    {
+      token_ptr[token_cnt] = next;
 
-        #endif
+      token_cnt++;
 
-        myfree (pidbin);
-      }
+      next = strtok (NULL, "\t");
+    }
 
-      if (rd->version_bin < RESTORE_MIN)
-      {
-        log_error ("ERROR: Cannot use outdated %s. Please remove it.", data.eff_restore_file);
+    if ((token_cnt != 13) || (next != NULL))
+    {
+      log_info ("WARNING: Learned tuning-db: Invalid number of token in Line '%u'", line_num);
 
-        exit (-1);
-      }
+      continue;
     }
-  }
 
-  memset (rd, 0, sizeof (restore_data_t));
+    tuning_db_learned_t *learned = &tuning_db->learned_buf[tuning_db->learned_cnt];
 
-  rd->version_bin = VERSION_BIN;
+    learned->attack_mode      = atoi (token_ptr[2]);
+    learned->hash_type        = atoi (token_ptr[3]);
+    learned->vector_width     = atoi (token_ptr[4]);
+    learned->workload_profile = atoi (token_ptr[5]);
+    learned->mem_item         = strtoull (token_ptr[6],  NULL, 10);
+    learned->mem_tmto         = atoi (token_ptr[7]);
+    learned->kernel_accel     = atoi (token_ptr[8]);
+    learned->kernel_loops     = atoi (token_ptr[9]);
+    learned->exec_ms          = atof (token_ptr[10]);
+    learned->speed            = strtoull (token_ptr[11], NULL, 10);
+    learned->timestamp        = strtoull (token_ptr[12], NULL, 10);
 
-  #ifdef _POSIX
-  rd->pid = getpid ();
-  #elif _WIN
-  rd->pid = GetCurrentProcessId ();
-  #endif
+    if ((learned->kernel_accel < 1) || (learned->kernel_accel > 1024)) continue;
+    if ((learned->kernel_loops < 1) || (learned->kernel_loops > 1024)) continue;
 
-  if (getcwd (rd->cwd, 255) == NULL)
-  {
-    myfree (rd);
+    if ((learned->mem_tmto < 0) || (learned->mem_tmto > 31)) continue;
 
-    return (NULL);
-  }
+    if (learned->exec_ms <= 0) continue;
 
-  rd->argc = argc;
-  rd->argv = argv;
+    // entries older than max_age days are dropped, they will be measured again and replaced on next save
 
-  return (rd);
-}
+    if (max_age)
+    {
+      if ((learned->timestamp + (u64) max_age * 24 * 60 * 60) < now) continue;
+    }
 
-void read_restore (const char *eff_restore_file, restore_data_t *rd)
-{
-  FILE *fp = fopen (eff_restore_file, "rb");
+    strncpy (learned->device_name_chksum, token_ptr[0], sizeof (learned->device_name_chksum) - 1);
 
-  if (fp == NULL)
-  {
-    log_error ("ERROR: Restore file '%s': %s", eff_restore_file, strerror (errno));
+    learned->device_name = mystrdup (token_ptr[1]);
 
-    exit (-1);
+    tuning_db->learned_cnt++;
   }
 
-  if (fread (rd, sizeof (restore_data_t), 1, fp) != 1)
-  {
-    log_error ("ERROR: Can't read %s", eff_restore_file);
+  myfree (buf);
 
-    exit (-1);
-  }
+  fclose (fp);
+}
 
-  rd->argv = (char **) mycalloc (rd->argc, sizeof (char *));
+int tuning_db_learned_save (tuning_db_t *tuning_db, const char *learned_file)
+{
+  char learned_file_tmp[256] = { 0 };
 
-  char *buf = (char *) mymalloc (HCBUFSIZ);
+  snprintf (learned_file_tmp, sizeof (learned_file_tmp) - 1, "%s.tmp", learned_file);
 
-  for (uint i = 0; i < rd->argc; i++)
+  FILE *fp = fopen (learned_file_tmp, "wb");
+
+  if (fp == NULL)
   {
-    if (fgets (buf, HCBUFSIZ - 1, fp) == NULL)
-    {
-      log_error ("ERROR: Can't read %s", eff_restore_file);
+    log_info ("WARNING: %s: %s", learned_file_tmp, strerror (errno));
 
-      exit (-1);
-    }
+    return -1;
+  }
 
-    size_t len = strlen (buf);
+  fprintf (fp, "%s\n", TUNING_DB_LEARNED_SIGNATURE);
+  fprintf (fp, "# device_name_chksum, device_name, attack_mode, hash_type, vector_width, workload_profile, mem_item, mem_tmto, kernel_accel, kernel_loops, exec_ms, speed, timestamp\n");
 
-    if (len) buf[len - 1] = 0;
+  for (int i = 0; i < tuning_db->learned_cnt; i++)
+  {
+    tuning_db_learned_t *learned = &tuning_db->learned_buf[i];
 
-    rd->argv[i] = mystrdup (buf);
+    fprintf (fp, "%s\t%s\t%d\t%d\t%d\t%d\t%llu\t%d\t%d\t%d\t%.3f\t%llu\t%llu\n",
+      learned->device_name_chksum,
+      learned->device_name,
+      learned->attack_mode,
+      learned->hash_type,
+      learned->vector_width,
+      learned->workload_profile,
+      (unsigned long long int) learned->mem_item,
+      learned->mem_tmto,
+      learned->kernel_accel,
+      learned->kernel_loops,
+      learned->exec_ms,
+      (unsigned long long int) learned->speed,
+      (unsigned long long int) learned->timestamp);
   }
 
-  myfree (buf);
-
   fclose (fp);
 
-  log_info ("INFO: Changing current working directory to the path found within the .restore file: '%s'", rd->cwd);
+  // replace the old file in one step so that concurrent sessions never read a partial file
 
-  if (chdir (rd->cwd))
+  #ifdef _WIN
+  unlink (learned_file);
+  #endif
+
+  if (rename (learned_file_tmp, learned_file) == -1)
   {
-    log_error ("ERROR: The directory '%s' does not exist. It is needed to restore (--restore) the session.\n"
-               "       You could either create this directory (or link it) or update the .restore file using e.g. the analyze_hc_restore.pl tool:\n"
-               "       https://github.com/philsmd/analyze_hc_restore\n"
-               "       The directory must be relative to (or contain) all files/folders mentioned within the command line.", rd->cwd);
+    log_info ("WARNING: %s: %s", learned_file, strerror (errno));
 
-    exit (-1);
+    unlink (learned_file_tmp);
+
+    return -1;
   }
+
+  return 0;
 }
 
-u64 get_lowest_words_done ()
+tuning_db_learned_t *tuning_db_learned_search (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type, int workload_profile)
 {
-  u64 words_cur = -1;
+  return tuning_db_learned_search_plan (tuning_db, device_param, attack_mode, hash_type, workload_profile, device_param->mem_item, device_param->scrypt_tmto_final);
+}
 
-  for (uint device_id = 0; device_id < data.devices_cnt; device_id++)
+tuning_db_learned_t *tuning_db_learned_search_plan (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type, int workload_profile, const u64 mem_item, const int mem_tmto)
+{
+  // attack-mode 6 and 7 are attack-mode 1 basically
+
+  if (attack_mode == 6) attack_mode = 1;
+  if (attack_mode == 7) attack_mode = 1;
+
+  // the checksum covers device name, device version, driver version, vector width and the build time
+  // so any driver or binary update invalidates the learned entries automatically
+
+  for (int i = 0; i < tuning_db->learned_cnt; i++)
   {
-    hc_device_param_t *device_param = &data.devices_param[device_id];
+    tuning_db_learned_t *learned = &tuning_db->learned_buf[i];
 
-    if (device_param->skipped) continue;
+    if (learned->attack_mode      != attack_mode)                         continue;
+    if (learned->hash_type        != hash_type)                           continue;
+    if (learned->vector_width     != (int) device_param->vector_width)    continue;
+    if (learned->workload_profile != workload_profile)                    continue;
 
-    const u64 words_done = device_param->words_done;
+    // memory-hard hash-modes are learned per memory size and TMTO, each TMTO needs different tuning
 
-    if (words_done < words_cur) words_cur = words_done;
-  }
+    if (learned->mem_item         != mem_item)                            continue;
+    if (learned->mem_tmto         != mem_tmto)                            continue;
 
-  // It's possible that a device's workload isn't finished right after a restore-case.
-  // In that case, this function would return 0 and overwrite the real restore point
-  // There's also data.words_cur which is set to rd->words_cur but it changes while
-  // the attack is running therefore we should stick to rd->words_cur.
-  // Note that -s influences rd->words_cur we should keep a close look on that.
+    if (strcmp (learned->device_name_chksum, device_param->device_name_chksum) != 0) continue;
 
-  if (words_cur < data.rd->words_cur) words_cur = data.rd->words_cur;
+    return learned;
+  }
 
-  return words_cur;
+  return NULL;
 }
 
-void write_restore (const char *new_restore_file, restore_data_t *rd)
+void tuning_db_learned_update (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type, int workload_profile, const double exec_ms)
 {
-  u64 words_cur = get_lowest_words_done ();
+  tuning_db_learned_t *learned = tuning_db_learned_search (tuning_db, device_param, attack_mode, hash_type, workload_profile);
 
-  rd->words_cur = words_cur;
+  if (learned == NULL)
+  {
+    tuning_db->learned_buf = (tuning_db_learned_t *) myrealloc (tuning_db->learned_buf, tuning_db->learned_cnt * sizeof (tuning_db_learned_t), sizeof (tuning_db_learned_t));
 
-  FILE *fp = fopen (new_restore_file, "wb");
+    learned = &tuning_db->learned_buf[tuning_db->learned_cnt];
 
-  if (fp == NULL)
-  {
-    log_error ("ERROR: %s: %s", new_restore_file, strerror (errno));
+    tuning_db->learned_cnt++;
 
-    exit (-1);
-  }
+    strncpy (learned->device_name_chksum, device_param->device_name_chksum, sizeof (learned->device_name_chksum) - 1);
 
-  if (setvbuf (fp, NULL, _IONBF, 0))
-  {
-    log_error ("ERROR: setvbuf file '%s': %s", new_restore_file, strerror (errno));
+    learned->device_name = tuning_db_device_name_nospace (device_param->device_name);
 
-    exit (-1);
+    learned->attack_mode      = ((attack_mode == 6) || (attack_mode == 7)) ? 1 : attack_mode;
+    learned->hash_type        = hash_type;
+    learned->vector_width     = device_param->vector_width;
+    learned->workload_profile = workload_profile;
+    learned->mem_item         = device_param->mem_item;
+    learned->mem_tmto         = device_param->scrypt_tmto_final;
   }
 
-  fwrite (rd, sizeof (restore_data_t), 1, fp);
+  learned->kernel_accel = device_param->kernel_accel;
+  learned->kernel_loops = device_param->kernel_loops;
+  learned->exec_ms      = exec_ms;
+  learned->speed        = (u64) ((double) device_param->kernel_power * device_param->kernel_loops * 1000 / exec_ms);
+  learned->timestamp    = (u64) time (NULL);
+}
 
-  for (uint i = 0; i < rd->argc; i++)
+void tuning_db_learned_export (tuning_db_t *tuning_db, FILE *fp)
+{
+  fprintf (fp, "#\n");
+  fprintf (fp, "# Exported from the learned tuning-db, can be appended to %s\n", TUNING_DB_FILE);
+  fprintf (fp, "#\n");
+
+  for (int i = 0; i < tuning_db->learned_cnt; i++)
   {
-    fprintf (fp, "%s", rd->argv[i]);
-    fputc ('\n', fp);
-  }
+    tuning_db_learned_t *learned = &tuning_db->learned_buf[i];
 
-  fflush (fp);
+    // the same device model can appear with different checksums (driver, build), only the newest result is exported
 
-  fsync (fileno (fp));
+    int newer = 0;
 
-  fclose (fp);
-}
+    for (int j = 0; j < tuning_db->learned_cnt; j++)
+    {
+      tuning_db_learned_t *other = &tuning_db->learned_buf[j];
 
-void cycle_restore ()
-{
-  const char *eff_restore_file = data.eff_restore_file;
-  const char *new_restore_file = data.new_restore_file;
+      if (j == i) continue;
 
-  restore_data_t *rd = data.rd;
+      if (other->attack_mode  != learned->attack_mode)  continue;
+      if (other->hash_type    != learned->hash_type)    continue;
+      if (other->vector_width != learned->vector_width) continue;
 
-  write_restore (new_restore_file, rd);
+      if (strcmp (other->device_name, learned->device_name) != 0) continue;
 
-  struct stat st;
+      // of the TMTO candidates of a memory-hard hash-mode only the fastest one is exported
 
-  memset (&st, 0, sizeof(st));
+      if ((other->mem_item == learned->mem_item) && (other->mem_tmto != learned->mem_tmto))
+      {
+        if ((other->speed > learned->speed) || ((other->speed == learned->speed) && (j > i))) newer = 1;
 
-  if (stat (eff_restore_file, &st) == 0)
-  {
-    if (unlink (eff_restore_file))
-    {
-      log_info ("WARN: Unlink file '%s': %s", eff_restore_file, strerror (errno));
+        continue;
+      }
+
+      if ((other->timestamp > learned->timestamp) || ((other->timestamp == learned->timestamp) && (j > i))) newer = 1;
     }
-  }
 
-  if (rename (new_restore_file, eff_restore_file))
-  {
-    log_info ("WARN: Rename file '%s' to '%s': %s", new_restore_file, eff_restore_file, strerror (errno));
-  }
-}
+    if (newer == 1) continue;
 
-void check_checkpoint ()
-{
-  // if (data.restore_disable == 1) break;  (this is already implied by previous checks)
+    // the tuning-db kernel_loops are defined for workload profile 3 and scaled down for profile 1 and 2
 
-  u64 words_cur = get_lowest_words_done ();
+    int kernel_loops = learned->kernel_loops;
 
-  if (words_cur != data.checkpoint_cur_words)
-  {
-    myabort ();
+    if (learned->workload_profile == 1) kernel_loops *= 8;
+    if (learned->workload_profile == 2) kernel_loops *= 4;
+
+    kernel_loops = MIN (kernel_loops, 1024);
+
+    fprintf (fp, "%-47s %-7d %-7d %-7d %-7d %d\n",
+      learned->device_name,
+      learned->attack_mode,
+      learned->hash_type,
+      learned->vector_width,
+      learned->kernel_accel,
+      kernel_loops);
   }
 }
 
 /**
- * tuning db
+ * rule stats
  */
 
-void tuning_db_destroy (tuning_db_t *tuning_db)
+static int sort_by_rule_stat (const void *v1, const void *v2)
 {
-  int i;
-
-  for (i = 0; i < tuning_db->alias_cnt; i++)
-  {
-    tuning_db_alias_t *alias = &tuning_db->alias_buf[i];
-
-    myfree (alias->device_name);
-    myfree (alias->alias_name);
-  }
-
-  for (i = 0; i < tuning_db->entry_cnt; i++)
-  {
-    tuning_db_entry_t *entry = &tuning_db->entry_buf[i];
-
-    myfree (entry->device_name);
-  }
+  const rule_stat_t *s1 = (const rule_stat_t *) v1;
+  const rule_stat_t *s2 = (const rule_stat_t *) v2;
 
-  myfree (tuning_db->alias_buf);
-  myfree (tuning_db->entry_buf);
-
-  myfree (tuning_db);
+  return strcmp (s1->rule_buf, s2->rule_buf);
 }
 
-tuning_db_t *tuning_db_alloc (FILE *fp)
+static int sort_by_rule_stat_yield (const void *v1, const void *v2)
 {
-  tuning_db_t *tuning_db = (tuning_db_t *) mymalloc (sizeof (tuning_db_t));
+  const rule_stat_t *s1 = *((const rule_stat_t **) v1);
+  const rule_stat_t *s2 = *((const rule_stat_t **) v2);
 
-  int num_lines = count_lines (fp);
+  // cracks per candidate, compared cross-multiplied to avoid the division
 
-  // a bit over-allocated
+  const double y1 = (double) s1->hits * (double) s2->tested;
+  const double y2 = (double) s2->hits * (double) s1->tested;
 
-  tuning_db->alias_buf = (tuning_db_alias_t *) mycalloc (num_lines + 1, sizeof (tuning_db_alias_t));
-  tuning_db->alias_cnt = 0;
+  if (y1 > y2) return -1;
+  if (y1 < y2) return  1;
 
-  tuning_db->entry_buf = (tuning_db_entry_t *) mycalloc (num_lines + 1, sizeof (tuning_db_entry_t));
-  tuning_db->entry_cnt = 0;
+  if (s1->hits > s2->hits) return -1;
+  if (s1->hits < s2->hits) return  1;
 
-  return tuning_db;
+  return strcmp (s1->rule_buf, s2->rule_buf);
 }
 
-tuning_db_t *tuning_db_init (const char *tuning_db_file)
+void rule_stats_load (rule_stats_t *rule_stats, const char *rule_stats_file)
 {
-  FILE *fp = fopen (tuning_db_file, "rb");
+  FILE *fp = fopen (rule_stats_file, "rb");
 
-  if (fp == NULL)
-  {
-    log_error ("%s: %s", tuning_db_file, strerror (errno));
+  // no stats yet is not an error
 
-    exit (-1);
-  }
+  if (fp == NULL) return;
 
-  tuning_db_t *tuning_db = tuning_db_alloc (fp);
+  const int num_lines = count_lines (fp);
 
   rewind (fp);
 
+  rule_stats->stat_buf = (rule_stat_t *) mycalloc (num_lines + 1, sizeof (rule_stat_t));
+  rule_stats->stat_cnt = 0;
+
   int line_num = 0;
 
   char *buf = (char *) mymalloc (HCBUFSIZ);
@@ -9737,234 +12048,195 @@ tuning_db_t *tuning_db_init (const char *tuning_db_file)
 
     const int line_len = in_superchop (line_buf);
 
-    if (line_len == 0) continue;
-
-    if (line_buf[0] == '#') continue;
-
-    // start processing
-
-    char *token_ptr[7] = { NULL };
-
-    int token_cnt = 0;
-
-    char *next = strtok (line_buf, "\t ");
-
-    token_ptr[token_cnt] = next;
-
-    token_cnt++;
-
-    while ((next = strtok (NULL, "\t ")) != NULL)
+    if (line_num == 1)
     {
-      token_ptr[token_cnt] = next;
+      if (strcmp (line_buf, RULE_STATS_SIGNATURE) != 0) break;
 
-      token_cnt++;
+      continue;
     }
 
-    if (token_cnt == 2)
-    {
-      char *device_name = token_ptr[0];
-      char *alias_name  = token_ptr[1];
-
-      tuning_db_alias_t *alias = &tuning_db->alias_buf[tuning_db->alias_cnt];
-
-      alias->device_name = mystrdup (device_name);
-      alias->alias_name  = mystrdup (alias_name);
+    if (line_len == 0) continue;
 
-      tuning_db->alias_cnt++;
-    }
-    else if (token_cnt == 6)
-    {
-      if ((token_ptr[1][0] != '0') &&
-          (token_ptr[1][0] != '1') &&
-          (token_ptr[1][0] != '3') &&
-          (token_ptr[1][0] != '*'))
-      {
-        log_info ("WARNING: Tuning-db: Invalid attack_mode '%c' in Line '%u'", token_ptr[1][0], line_num);
+    if (line_buf[0] == '#') continue;
 
-        continue;
-      }
+    // the rule itself can contain tabs, so only the first two are separators
 
-      if ((token_ptr[3][0] != '1') &&
-          (token_ptr[3][0] != '2') &&
-          (token_ptr[3][0] != '4') &&
-          (token_ptr[3][0] != '8') &&
-          (token_ptr[3][0] != 'N'))
-      {
-        log_info ("WARNING: Tuning-db: Invalid vector_width '%c' in Line '%u'", token_ptr[3][0], line_num);
+    char *tested_pos = strchr (line_buf, '\t');
 
-        continue;
-      }
+    if (tested_pos == NULL) continue;
 
-      char *device_name = token_ptr[0];
+    tested_pos++;
 
-      int attack_mode      = -1;
-      int hash_type        = -1;
-      int vector_width     = -1;
-      int kernel_accel     = -1;
-      int kernel_loops     = -1;
+    char *rule_pos = strchr (tested_pos, '\t');
 
-      if (token_ptr[1][0] != '*') attack_mode      = atoi (token_ptr[1]);
-      if (token_ptr[2][0] != '*') hash_type        = atoi (token_ptr[2]);
-      if (token_ptr[3][0] != 'N') vector_width     = atoi (token_ptr[3]);
+    if (rule_pos == NULL) continue;
 
-      if (token_ptr[4][0] != 'A')
-      {
-        kernel_accel = atoi (token_ptr[4]);
+    rule_pos++;
 
-        if ((kernel_accel < 1) || (kernel_accel > 1024))
-        {
-          log_info ("WARNING: Tuning-db: Invalid kernel_accel '%d' in Line '%u'", kernel_accel, line_num);
+    if (*rule_pos == 0) continue;
 
-          continue;
-        }
-      }
-      else
-      {
-        kernel_accel = 0;
-      }
+    rule_stat_t *rule_stat = &rule_stats->stat_buf[rule_stats->stat_cnt];
 
-      if (token_ptr[5][0] != 'A')
-      {
-        kernel_loops = atoi (token_ptr[5]);
+    rule_stat->hits     = strtoull (line_buf,   NULL, 10);
+    rule_stat->tested   = strtoull (tested_pos, NULL, 10);
+    rule_stat->rule_buf = mystrdup (rule_pos);
 
-        if ((kernel_loops < 1) || (kernel_loops > 1024))
-        {
-          log_info ("WARNING: Tuning-db: Invalid kernel_loops '%d' in Line '%u'", kernel_loops, line_num);
+    rule_stats->stat_cnt++;
+  }
 
-          continue;
-        }
-      }
-      else
-      {
-        kernel_loops = 0;
-      }
+  myfree (buf);
 
-      tuning_db_entry_t *entry = &tuning_db->entry_buf[tuning_db->entry_cnt];
+  fclose (fp);
 
-      entry->device_name  = mystrdup (device_name);
-      entry->attack_mode  = attack_mode;
-      entry->hash_type    = hash_type;
-      entry->vector_width = vector_width;
-      entry->kernel_accel = kernel_accel;
-      entry->kernel_loops = kernel_loops;
+  qsort (rule_stats->stat_buf, rule_stats->stat_cnt, sizeof (rule_stat_t), sort_by_rule_stat);
+}
 
-      tuning_db->entry_cnt++;
-    }
-    else
-    {
-      log_info ("WARNING: Tuning-db: Invalid number of token in Line '%u'", line_num);
+int rule_stats_save (rule_stats_t *rule_stats, const char *rule_stats_file)
+{
+  char rule_stats_file_tmp[256] = { 0 };
 
-      continue;
-    }
+  snprintf (rule_stats_file_tmp, sizeof (rule_stats_file_tmp) - 1, "%s.tmp", rule_stats_file);
+
+  FILE *fp = fopen (rule_stats_file_tmp, "wb");
+
+  if (fp == NULL)
+  {
+    log_info ("WARNING: %s: %s", rule_stats_file_tmp, strerror (errno));
+
+    return -1;
   }
 
-  myfree (buf);
+  fprintf (fp, "%s\n", RULE_STATS_SIGNATURE);
+  fprintf (fp, "# cracks, candidates, rule\n");
+
+  for (uint i = 0; i < rule_stats->stat_cnt; i++)
+  {
+    rule_stat_t *rule_stat = &rule_stats->stat_buf[i];
+
+    fprintf (fp, "%llu\t%llu\t%s\n", (unsigned long long int) rule_stat->hits, (unsigned long long int) rule_stat->tested, rule_stat->rule_buf);
+  }
 
   fclose (fp);
 
-  // todo: print loaded 'cnt' message
+  #ifdef _WIN
+  unlink (rule_stats_file);
+  #endif
 
-  // sort the database
+  if (rename (rule_stats_file_tmp, rule_stats_file) == -1)
+  {
+    log_info ("WARNING: %s: %s", rule_stats_file, strerror (errno));
 
-  qsort (tuning_db->alias_buf, tuning_db->alias_cnt, sizeof (tuning_db_alias_t), sort_by_tuning_db_alias);
-  qsort (tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
+    unlink (rule_stats_file_tmp);
 
-  return tuning_db;
+    return -1;
+  }
+
+  return 0;
 }
 
-tuning_db_entry_t *tuning_db_search (tuning_db_t *tuning_db, hc_device_param_t *device_param, int attack_mode, int hash_type)
+void rule_stats_update (rule_stats_t *rule_stats, kernel_rule_t *kernel_rules_buf, const uint kernel_rules_cnt, u64 *rule_hits, u64 *rule_tested)
 {
-  static tuning_db_entry_t s;
+  const uint sorted_cnt = rule_stats->stat_cnt;
 
-  // first we need to convert all spaces in the device_name to underscore
+  char rule_buf[BLOCK_SIZE];
 
-  char *device_name_nospace = strdup (device_param->device_name);
+  for (uint i = 0; i < kernel_rules_cnt; i++)
+  {
+    if ((rule_hits[i] == 0) && (rule_tested[i] == 0)) continue;
 
-  int device_name_length = strlen (device_name_nospace);
+    memset (rule_buf, 0, sizeof (rule_buf));
 
-  int i;
+    const int rule_len = kernel_rule_to_cpu_rule (rule_buf, &kernel_rules_buf[i]);
 
-  for (i = 0; i < device_name_length; i++)
-  {
-    if (device_name_nospace[i] == ' ') device_name_nospace[i] = '_';
-  }
+    if (rule_len == -1) continue;
 
-  // find out if there's an alias configured
+    rule_buf[rule_len] = 0; // the conversion leaves a trailing separator behind
 
-  tuning_db_alias_t a;
+    rule_stat_t key;
 
-  a.device_name = device_name_nospace;
+    key.rule_buf = rule_buf;
 
-  tuning_db_alias_t *alias = bsearch (&a, tuning_db->alias_buf, tuning_db->alias_cnt, sizeof (tuning_db_alias_t), sort_by_tuning_db_alias);
+    rule_stat_t *rule_stat = (rule_stat_t *) bsearch (&key, rule_stats->stat_buf, sorted_cnt, sizeof (rule_stat_t), sort_by_rule_stat);
 
-  char *alias_name = (alias == NULL) ? NULL : alias->alias_name;
+    if (rule_stat == NULL)
+    {
+      rule_stats->stat_buf = (rule_stat_t *) myrealloc (rule_stats->stat_buf, rule_stats->stat_cnt * sizeof (rule_stat_t), sizeof (rule_stat_t));
 
-  // attack-mode 6 and 7 are attack-mode 1 basically
+      rule_stat = &rule_stats->stat_buf[rule_stats->stat_cnt];
 
-  if (attack_mode == 6) attack_mode = 1;
-  if (attack_mode == 7) attack_mode = 1;
+      rule_stat->rule_buf = mystrdup (rule_buf);
 
-  // bsearch is not ideal but fast enough
+      rule_stats->stat_cnt++;
+    }
 
-  s.device_name = device_name_nospace;
-  s.attack_mode = attack_mode;
-  s.hash_type   = hash_type;
+    rule_stat->hits   += rule_hits[i];
+    rule_stat->tested += rule_tested[i];
 
-  tuning_db_entry_t *entry = NULL;
+    rule_hits[i]   = 0;
+    rule_tested[i] = 0;
+  }
 
-  // this will produce all 2^3 combinations required
+  if (rule_stats->stat_cnt == sorted_cnt) return;
 
-  for (i = 0; i < 8; i++)
-  {
-    s.device_name = (i & 1) ? "*" : device_name_nospace;
-    s.attack_mode = (i & 2) ?  -1 : attack_mode;
-    s.hash_type   = (i & 4) ?  -1 : hash_type;
+  qsort (rule_stats->stat_buf, rule_stats->stat_cnt, sizeof (rule_stat_t), sort_by_rule_stat);
 
-    entry = bsearch (&s, tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
+  // generated rules (-g) are not unique, fold duplicates so the next bsearch () stays unambiguous
 
-    if (entry != NULL) break;
+  uint uniq_cnt = 0;
 
-    // in non-wildcard mode do some additional checks:
+  for (uint i = 0; i < rule_stats->stat_cnt; i++)
+  {
+    rule_stat_t *rule_stat = &rule_stats->stat_buf[i];
 
-    if ((i & 1) == 0)
+    if ((uniq_cnt > 0) && (strcmp (rule_stats->stat_buf[uniq_cnt - 1].rule_buf, rule_stat->rule_buf) == 0))
     {
-      // in case we have an alias-name
+      rule_stats->stat_buf[uniq_cnt - 1].hits   += rule_stat->hits;
+      rule_stats->stat_buf[uniq_cnt - 1].tested += rule_stat->tested;
 
-      if (alias_name != NULL)
-      {
-        s.device_name = alias_name;
+      myfree (rule_stat->rule_buf);
 
-        entry = bsearch (&s, tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
+      continue;
+    }
 
-        if (entry != NULL) break;
-      }
+    rule_stats->stat_buf[uniq_cnt] = *rule_stat;
 
-      // or by device type
+    uniq_cnt++;
+  }
 
-      if (device_param->device_type & CL_DEVICE_TYPE_CPU)
-      {
-        s.device_name = "DEVICE_TYPE_CPU";
-      }
-      else if (device_param->device_type & CL_DEVICE_TYPE_GPU)
-      {
-        s.device_name = "DEVICE_TYPE_GPU";
-      }
-      else if (device_param->device_type & CL_DEVICE_TYPE_ACCELERATOR)
-      {
-        s.device_name = "DEVICE_TYPE_ACCELERATOR";
-      }
+  rule_stats->stat_cnt = uniq_cnt;
+}
 
-      entry = bsearch (&s, tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
+void rule_stats_print (rule_stats_t *rule_stats, FILE *fp, const uint top)
+{
+  rule_stat_t **sorted = (rule_stat_t **) mycalloc (rule_stats->stat_cnt + 1, sizeof (rule_stat_t *));
 
-      if (entry != NULL) break;
-    }
+  for (uint i = 0; i < rule_stats->stat_cnt; i++) sorted[i] = &rule_stats->stat_buf[i];
+
+  qsort (sorted, rule_stats->stat_cnt, sizeof (rule_stat_t *), sort_by_rule_stat_yield);
+
+  const uint export_cnt = ((top > 0) && (top < rule_stats->stat_cnt)) ? top : rule_stats->stat_cnt;
+
+  fprintf (fp, "#\n");
+  fprintf (fp, "# Exported from rule stats, %u of %u rules sorted by cracks per candidate\n", export_cnt, rule_stats->stat_cnt);
+  fprintf (fp, "#\n");
+
+  for (uint i = 0; i < export_cnt; i++)
+  {
+    fprintf (fp, "%s\n", sorted[i]->rule_buf);
   }
 
-  // free converted device_name
+  myfree (sorted);
+}
 
-  myfree (device_name_nospace);
+void rule_stats_destroy (rule_stats_t *rule_stats)
+{
+  for (uint i = 0; i < rule_stats->stat_cnt; i++)
+  {
+    myfree (rule_stats->stat_buf[i].rule_buf);
+  }
 
-  return entry;
+  myfree (rule_stats->stat_buf);
+  myfree (rule_stats);
 }
 
 /**
@@ -9986,18 +12258,7 @@ uint parse_and_store_salt (char *out, char *in, uint salt_len)
   {
     if ((salt_len % 2) == 0)
     {
-      u32 new_salt_len = salt_len / 2;
-
-      for (uint i = 0, j = 0; i < new_salt_len; i += 1, j += 2)
-      {
-        u8 p0 = tmp[j + 0];
-        u8 p1 = tmp[j + 1];
-
-        tmp[i]  = hex_convert (p1) << 0;
-        tmp[i] |= hex_convert (p0) << 4;
-      }
-
-      salt_len = new_salt_len;
+      salt_len = hex_decode (tmp, salt_len, tmp);
     }
     else
     {
@@ -11336,6 +13597,171 @@ void transform_netntlmv1_key (const u8 *nthash, u8 *key)
   key[7] |= 0x01;
 }
 
+/**
+ * netntlmv1 third key recovery: the third DES key only depends on the last two bytes of the NT hash
+ * the key schedules of all NETNTLMV1_KEYS keys are computed once, the search itself is split across threads
+ * if the same server challenge shows up again, which is typical for fixed-challenge captures, the ciphertexts of all keys
+ * under that challenge are kept in a lookup table, so the following hashes are a single probe
+ * parse_func () is never called from more than one thread at a time, the worker threads only share read-only data
+ */
+
+static u32 *netntlmv1_ks_buf   = NULL; // Kc[16] and Kd[16] per key
+static u32 *netntlmv1_ct_buf   = NULL; // ciphertext per key under netntlmv1_chall
+static u32 *netntlmv1_ct_table = NULL; // open addressing, key + 1
+
+static u32  netntlmv1_chall[2]   = { 0 };
+static uint netntlmv1_chall_seen = 0;
+
+static u32 netntlmv1_ct_hash (const u32 ct[2])
+{
+  return ((ct[0] ^ rotl32 (ct[1], 16)) * 0x9e3779b1) & ((NETNTLMV1_KEYS * 2) - 1);
+}
+
+static void *netntlmv1_thread (void *p)
+{
+  netntlmv1_worker_t *worker = (netntlmv1_worker_t *) p;
+
+  for (uint key = worker->key_start; key < worker->key_stop; key++)
+  {
+    // another thread found a smaller key already
+
+    if ((worker->ct_buf == NULL) && ((key & 0xff) == 0) && (*worker->key_found < key)) break;
+
+    u32 data3[2] = { worker->chall[0], worker->chall[1] };
+
+    _des_encrypt (data3, (u32 *) worker->ks_buf + (key * 32) + 0, (u32 *) worker->ks_buf + (key * 32) + 16, c_SPtrans);
+
+    if (worker->ct_buf != NULL)
+    {
+      worker->ct_buf[(key * 2) + 0] = data3[0];
+      worker->ct_buf[(key * 2) + 1] = data3[1];
+
+      continue;
+    }
+
+    if (data3[0] != worker->ct[0]) continue;
+    if (data3[1] != worker->ct[1]) continue;
+
+    worker->key_pos = key;
+
+    if (key < *worker->key_found) *worker->key_found = key;
+
+    break;
+  }
+
+  return NULL;
+}
+
+static int netntlmv1_find_key3 (const u32 chall[2], const u32 ct[2])
+{
+  if (netntlmv1_ks_buf == NULL)
+  {
+    netntlmv1_ks_buf = (u32 *) mymalloc (NETNTLMV1_KEYS * 32 * sizeof (u32));
+
+    for (uint key = 0; key < NETNTLMV1_KEYS; key++)
+    {
+      uint key_md4[2] = { key, 0 };
+      uint key_des[2] = { 0, 0 };
+
+      transform_netntlmv1_key ((u8 *) key_md4, (u8 *) key_des);
+
+      _des_keysetup (key_des, netntlmv1_ks_buf + (key * 32) + 0, netntlmv1_ks_buf + (key * 32) + 16, c_skb);
+    }
+  }
+
+  const int chall_same = (chall[0] == netntlmv1_chall[0]) && (chall[1] == netntlmv1_chall[1]);
+
+  if (chall_same == 0)
+  {
+    netntlmv1_chall[0] = chall[0];
+    netntlmv1_chall[1] = chall[1];
+
+    netntlmv1_chall_seen = 0;
+  }
+
+  netntlmv1_chall_seen++;
+
+  if (netntlmv1_chall_seen == 2)
+  {
+    if (netntlmv1_ct_buf == NULL)
+    {
+      netntlmv1_ct_buf   = (u32 *) mymalloc (NETNTLMV1_KEYS * 2 * sizeof (u32));
+      netntlmv1_ct_table = (u32 *) mymalloc (NETNTLMV1_KEYS * 2 * sizeof (u32));
+    }
+  }
+
+  const int build_table = (netntlmv1_chall_seen == 2);
+
+  if (netntlmv1_chall_seen <= 2)
+  {
+    const uint threads_cnt = MIN (get_cpu_cnt (), NETNTLMV1_THREADS_MAX);
+
+    const uint key_step = (NETNTLMV1_KEYS + threads_cnt - 1) / threads_cnt;
+
+    volatile uint key_found = NETNTLMV1_KEYS;
+
+    netntlmv1_worker_t workers[NETNTLMV1_THREADS_MAX];
+
+    hc_thread_t threads[NETNTLMV1_THREADS_MAX];
+
+    for (uint thread_id = 0; thread_id < threads_cnt; thread_id++)
+    {
+      netntlmv1_worker_t *worker = &workers[thread_id];
+
+      worker->ks_buf    = netntlmv1_ks_buf;
+      worker->chall     = chall;
+      worker->ct        = ct;
+      worker->ct_buf    = (build_table) ? netntlmv1_ct_buf : NULL;
+      worker->key_start = MIN (thread_id * key_step, NETNTLMV1_KEYS);
+      worker->key_stop  = MIN (worker->key_start + key_step, NETNTLMV1_KEYS);
+      worker->key_pos   = NETNTLMV1_KEYS;
+      worker->key_found = &key_found;
+
+      hc_thread_create (threads[thread_id], netntlmv1_thread, worker);
+    }
+
+    hc_thread_wait (threads_cnt, threads);
+
+    if (build_table == 0)
+    {
+      uint key_pos = NETNTLMV1_KEYS;
+
+      for (uint thread_id = 0; thread_id < threads_cnt; thread_id++)
+      {
+        key_pos = MIN (key_pos, workers[thread_id].key_pos);
+      }
+
+      return (key_pos == NETNTLMV1_KEYS) ? -1 : (int) key_pos;
+    }
+
+    // inserted in key order, so a lookup finds the smallest key first, same as the linear search
+
+    memset (netntlmv1_ct_table, 0, NETNTLMV1_KEYS * 2 * sizeof (u32));
+
+    for (uint key = 0; key < NETNTLMV1_KEYS; key++)
+    {
+      u32 pos = netntlmv1_ct_hash (netntlmv1_ct_buf + (key * 2));
+
+      while (netntlmv1_ct_table[pos]) pos = (pos + 1) & ((NETNTLMV1_KEYS * 2) - 1);
+
+      netntlmv1_ct_table[pos] = key + 1;
+    }
+  }
+
+  u32 pos = netntlmv1_ct_hash (ct);
+
+  while (netntlmv1_ct_table[pos])
+  {
+    const uint key = netntlmv1_ct_table[pos] - 1;
+
+    if ((netntlmv1_ct_buf[(key * 2) + 0] == ct[0]) && (netntlmv1_ct_buf[(key * 2) + 1] == ct[1])) return (int) key;
+
+    pos = (pos + 1) & ((NETNTLMV1_KEYS * 2) - 1);
+  }
+
+  return -1;
+}
+
 int netntlmv1_parse_hash (char *input_buf, uint input_len, hash_t *hash_buf)
 {
   if ((input_len < DISPLAY_LEN_MIN_5500) || (input_len > DISPLAY_LEN_MAX_5500)) return (PARSER_GLOBAL_LENGTH);
@@ -11523,30 +13949,13 @@ int netntlmv1_parse_hash (char *input_buf, uint input_len, hash_t *hash_buf)
 
   /* precompute netntlmv1 exploit start */
 
-  for (uint i = 0; i < 0x10000; i++)
-  {
-    uint key_md4[2] = { i, 0 };
-    uint key_des[2] = { 0, 0 };
-
-    transform_netntlmv1_key ((u8 *) key_md4, (u8 *) key_des);
+  const int key_pos = netntlmv1_find_key3 (salt->salt_buf, digest_tmp);
 
-    uint Kc[16] = { 0 };
-    uint Kd[16] = { 0 };
-
-    _des_keysetup (key_des, Kc, Kd, c_skb);
-
-    uint data3[2] = { salt->salt_buf[0], salt->salt_buf[1] };
-
-    _des_encrypt (data3, Kc, Kd, c_SPtrans);
-
-    if (data3[0] != digest_tmp[0]) continue;
-    if (data3[1] != digest_tmp[1]) continue;
-
-    salt->salt_buf[2] = i;
+  if (key_pos != -1)
+  {
+    salt->salt_buf[2] = key_pos;
 
     salt->salt_len = 24;
-
-    break;
   }
 
   salt->salt_buf_pc[0] = digest_tmp[0];
@@ -0,0 +1,1076 @@
+/**
+ * Author......: Jens Steube <jens.steube@gmail.com>
+ * License.....: MIT
+ *
+ * Host-side microbenchmark harness, built and run by "make bench".
+ *
+ * Times the hot host code paths (hash parsing, hex decoding, wordlist segmentation,
+ * CPU rule engine, bitmap generation, hash dedupe, potfile loading,
+ * markov/mask candidate generation, output formatting and the host hook pool)
+ * without any OpenCL device, and prints the results as JSON on stdout.
+ *
+ * hashcat.c is included directly so its static functions can be called
+ * without exporting them from the main binary.
+ */
+
+#define main hashcat_main
+#include "hashcat.c"
+#undef main
+
+#define BENCH_MIN_MS        500
+#define BENCH_WORDLIST      "example.dict"
+#define BENCH_RULES         "rules/best64.rule"
+#define BENCH_MASK          "?l?l?l?l?d?d?d?d"
+#define BENCH_DIGESTS       100000
+#define BENCH_PARSE_LOOPS   10000
+#define BENCH_RULE_WORDS    10000
+#define BENCH_GEN_LOOPS     100000
+#define BENCH_BITMAP_BITS   18
+#define BENCH_HOOK_CNT      4096
+#define BENCH_HOOK_SIZE     4096
+
+typedef u64 (*bench_func_t) (void *);
+
+static double bench_min_ms = BENCH_MIN_MS;
+
+static uint bench_results_cnt = 0;
+
+/**
+ * runner
+ */
+
+static void bench_run (const char *name, const char *variant, bench_func_t func, void *ctx)
+{
+  u64 ops = 0;
+
+  double ms = 0;
+
+  hc_timer_t timer;
+
+  hc_timer_set (&timer);
+
+  do
+  {
+    ops += func (ctx);
+
+    hc_timer_get (timer, ms);
+
+  } while (ms < bench_min_ms);
+
+  const double ops_per_sec = (ms > 0) ? ((double) ops * 1000) / ms : 0;
+
+  if (bench_results_cnt) printf (",\n");
+
+  printf ("    { \"name\": \"%s\", \"variant\": \"%s\", \"ops\": %llu, \"ms\": %.3f, \"ops_per_sec\": %.1f }", name, variant, (unsigned long long int) ops, ms, ops_per_sec);
+
+  fflush (stdout);
+
+  bench_results_cnt++;
+}
+
+/**
+ * parse_func
+ */
+
+typedef struct
+{
+  uint  hash_mode;
+  int   (*parse_func) (char *, uint, hash_t *);
+  uint  dgst_size;
+  uint  esalt_size;
+  uint  opts_type;
+  char *example;
+
+} bench_parse_t;
+
+static bench_parse_t bench_parse_list[] =
+{
+  {     0, md5_parse_hash,           DGST_SIZE_4_4,  0,                        OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS14,                                           "8743b52063cd84097a65d1633f5c74f5" },
+  {    10, md5s_parse_hash,          DGST_SIZE_4_4,  0,                        OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_ST_ADD80 | OPTS_TYPE_ST_ADDBITS14,                                           "01dfae6e5d4d90d9892622325959afbe:7050461" },
+  {   100, sha1_parse_hash,          DGST_SIZE_4_5,  0,                        OPTS_TYPE_PT_GENERATE_BE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS15,                                           "b89eaac7e61417341b710b727768294d0e6a277b" },
+  {   101, sha1b64_parse_hash,       DGST_SIZE_4_5,  0,                        OPTS_TYPE_PT_GENERATE_BE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS15,                                           "{SHA}uJ6qx+YUFzQbcQtyd2gpTQ5qJ3s=" },
+  {   111, sha1b64s_parse_hash,      DGST_SIZE_4_5,  0,                        OPTS_TYPE_PT_GENERATE_BE | OPTS_TYPE_ST_ADD80 | OPTS_TYPE_ST_ADDBITS15,                                           "{SSHA}AZKja92fbuuB9SpRlHqaoXxbTc43Mzc2MDM1Ng==" },
+  {   400, phpass_parse_hash,        DGST_SIZE_4_4,  0,                        OPTS_TYPE_PT_GENERATE_LE,                                                                                         "$P$984478476IagS59wHZvyQMArzfx58u." },
+  {   500, md5crypt_parse_hash,      DGST_SIZE_4_4,  0,                        OPTS_TYPE_PT_GENERATE_LE,                                                                                         "$1$28772684$iEwNOgGugqO9.bIz5sk8k/" },
+  {  1000, md4_parse_hash,           DGST_SIZE_4_4,  0,                        OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS14 | OPTS_TYPE_PT_UNICODE,                    "b4b9b02e6f09a9bd760f388b67351e2b" },
+  {  1400, sha256_parse_hash,        DGST_SIZE_4_8,  0,                        OPTS_TYPE_PT_GENERATE_BE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS15,                                           "127e6fbfe24a750e72930c220a8e138275656b8e5d8f48a98c3c92df2caba935" },
+  {  1500, descrypt_parse_hash,      DGST_SIZE_4_4,  0,                        OPTS_TYPE_PT_GENERATE_LE,                                                                                         "48c/R8JAv757A" },
+  {  1700, sha512_parse_hash,        DGST_SIZE_8_8,  0,                        OPTS_TYPE_PT_GENERATE_BE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS15,                                           "82a9dda829eb7f8ffe9fbe49e45d47d2dad9664fbb7adf72492e3c81ebd3e29134d9bc12212bf83c6840f10e8246b9db54a4859b7ccd0123d86e5872c1e5082f" },
+  {  1711, sha512b64s_parse_hash,    DGST_SIZE_8_8,  0,                        OPTS_TYPE_PT_GENERATE_BE | OPTS_TYPE_ST_ADD80 | OPTS_TYPE_ST_ADDBITS15,                                           "{SSHA512}ALtwKGBdRgD+U0fPAy31C28RyKYx7+a8kmfksccsOeLknLHv2DBXYI7TDnTolQMBuPkWDISgZr2cHfnNPFjGZTEyNDU4OTkw" },
+  {  1800, sha512crypt_parse_hash,   DGST_SIZE_8_8,  0,                        OPTS_TYPE_PT_GENERATE_LE,                                                                                         "$6$52450745$k5ka2p8bFuSmoVT1tzOyyuaREkkKBcCNqoDKzYiJL9RaE8yMnPgh2XzzF0NDrUhgrcLwg78xs1w5pJiypEdFX/" },
+  {  3000, lm_parse_hash,            DGST_SIZE_4_4,  0,                        OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_PT_UPPER | OPTS_TYPE_PT_BITSLICE,                                            "299bd128c1101fd6" },
+  {  3200, bcrypt_parse_hash,        DGST_SIZE_4_6,  0,                        OPTS_TYPE_PT_GENERATE_LE,                                                                                         "$2a$05$LhayLxezLhK1LhWvKxCyLOj0j1u.Kj0jZ0pEmm134uzrQlFvQJLF6" },
+  {  5500, netntlmv1_parse_hash,     DGST_SIZE_4_4,  sizeof (netntlm_t),       OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS14 | OPTS_TYPE_PT_UNICODE | OPTS_TYPE_ST_HEX, "u4-netntlm::kNS:338d08f8e26de93300000000000000000000000000000000:9526fb8c23a90751cdd619b6cea564742e1e4bf33006ba41:cb8086049ec4736c" },
+  {  5600, netntlmv2_parse_hash,     DGST_SIZE_4_4,  sizeof (netntlm_t),       OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS14 | OPTS_TYPE_PT_UNICODE,                    "admin::N46iSNekpT:08ca45b7d7ea58ee:88dcbe4446168966a153a0064958dac6:5c7830315c7830310000000000000b45c67103d07d7b95acd12ffa11230e0000000052920b85f78d013c31cdb3b92f5d765c783030" },
+  {  7100, sha512osx_parse_hash,     DGST_SIZE_8_16, sizeof (pbkdf2_sha512_t), OPTS_TYPE_PT_GENERATE_LE,                                                                                         "$ml$35460$93a94bd24b5de64d79a5e49fa372827e739f4d7b6975c752c9a0ff1e5cf72e05$752351df64dd2ce9dc9c64a72ad91de6581a15c19176266b44d98919dfa81f0f96cbcb20a1ffb400718c20382030f637892f776627d34e021bad4f81b7de8222" },
+  {  7400, sha256crypt_parse_hash,   DGST_SIZE_4_8,  0,                        OPTS_TYPE_PT_GENERATE_LE,                                                                                         "$5$rounds=5000$GX7BopJZJxPc/KEK$le16UF8I2Anb.rOrn22AUPWvzUETDGefUmAV8AZkGcD" },
+  { 10900, pbkdf2_sha256_parse_hash, DGST_SIZE_4_32, sizeof (pbkdf2_sha256_t), OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_ST_BASE64 | OPTS_TYPE_HASH_COPY,                                             "sha256:1000:MTc3MTA0MTQwMjQxNzY=:PYjCU215Mi57AYPKva9j7mvF4Rc5bCnt" },
+};
+
+typedef struct
+{
+  bench_parse_t *parse;
+
+  char   *input_buf;
+  uint    input_len;
+
+  uint    loops;
+
+  hash_t  hash;
+
+} bench_parse_ctx_t;
+
+static u64 bench_parse_func (void *p)
+{
+  bench_parse_ctx_t *ctx = (bench_parse_ctx_t *) p;
+
+  for (uint i = 0; i < ctx->loops; i++)
+  {
+    memcpy (ctx->input_buf, ctx->parse->example, ctx->input_len);
+
+    ctx->parse->parse_func (ctx->input_buf, ctx->input_len, &ctx->hash);
+  }
+
+  return ctx->loops;
+}
+
+static void bench_parse_all ()
+{
+  const uint parse_cnt = sizeof (bench_parse_list) / sizeof (bench_parse_t);
+
+  for (uint parse_pos = 0; parse_pos < parse_cnt; parse_pos++)
+  {
+    bench_parse_t *parse = &bench_parse_list[parse_pos];
+
+    data.hash_mode = parse->hash_mode;
+    data.opts_type = parse->opts_type;
+
+    bench_parse_ctx_t ctx;
+
+    memset (&ctx, 0, sizeof (ctx));
+
+    ctx.parse     = parse;
+    ctx.input_len = strlen (parse->example);
+    ctx.input_buf = (char *) mymalloc (ctx.input_len + 1);
+
+    ctx.hash.digest = mymalloc (parse->dgst_size);
+    ctx.hash.salt   = (salt_t *) mymalloc (sizeof (salt_t));
+
+    if (parse->esalt_size) ctx.hash.esalt = mymalloc (parse->esalt_size);
+
+    memcpy (ctx.input_buf, parse->example, ctx.input_len);
+
+    const int parser_status = parse->parse_func (ctx.input_buf, ctx.input_len, &ctx.hash);
+
+    if (parser_status == PARSER_OK)
+    {
+      // some parsers are very slow (netntlmv1 recovers a DES key), size a round to roughly 1 ms
+
+      double ms = 0;
+
+      for (ctx.loops = 1; ctx.loops < BENCH_PARSE_LOOPS; ctx.loops *= 2)
+      {
+        hc_timer_t timer;
+
+        hc_timer_set (&timer);
+
+        bench_parse_func (&ctx);
+
+        hc_timer_get (timer, ms);
+
+        if (ms >= 1) break;
+      }
+
+      char variant[16] = { 0 };
+
+      snprintf (variant, sizeof (variant) - 1, "%u", parse->hash_mode);
+
+      bench_run ("parse_func", variant, bench_parse_func, &ctx);
+    }
+    else
+    {
+      log_error ("ERROR: hash-mode %u: %s", parse->hash_mode, strparser (parser_status));
+    }
+
+    myfree (ctx.input_buf);
+    myfree (ctx.hash.digest);
+    myfree (ctx.hash.salt);
+    myfree (ctx.hash.esalt);
+  }
+}
+
+/**
+ * hex_decode
+ */
+
+typedef struct
+{
+  u8  in_buf[128];
+  u8  out_buf[64];
+
+  u64 sum;
+
+} bench_decode_ctx_t;
+
+static u64 bench_decode_func (void *p)
+{
+  bench_decode_ctx_t *ctx = (bench_decode_ctx_t *) p;
+
+  for (uint i = 0; i < BENCH_PARSE_LOOPS; i++)
+  {
+    ctx->in_buf[i & 127] = "0123456789abcdef"[(i >> 7) & 15]; // still hex, but different every round
+
+    hex_decode (ctx->in_buf, sizeof (ctx->in_buf), ctx->out_buf);
+
+    ctx->sum += ctx->out_buf[i & 63];
+  }
+
+  return BENCH_PARSE_LOOPS;
+}
+
+static void bench_decode ()
+{
+  bench_decode_ctx_t ctx;
+
+  memset (&ctx, 0, sizeof (ctx));
+
+  for (uint i = 0; i < sizeof (ctx.in_buf); i++) ctx.in_buf[i] = "0123456789abcdef"[i & 15];
+
+  bench_run ("hex_decode", "128", bench_decode_func, &ctx);
+}
+
+/**
+ * load_segment + get_next_word
+ */
+
+typedef struct
+{
+  FILE      *fd;
+
+  wl_data_t *wl_data;
+
+  u64        words_cnt;
+
+} bench_wordlist_ctx_t;
+
+static u64 bench_wordlist_func (void *p)
+{
+  bench_wordlist_ctx_t *ctx = (bench_wordlist_ctx_t *) p;
+
+  wl_data_t *wl_data = ctx->wl_data;
+
+  rewind (ctx->fd);
+
+  wl_data->cnt = 0;
+  wl_data->pos = 0;
+
+  u64 bytes = 0;
+
+  for (u64 words_cur = 0; words_cur < ctx->words_cnt; words_cur++)
+  {
+    char *line_buf = NULL;
+    uint  line_len = 0;
+
+    get_next_word (wl_data, ctx->fd, &line_buf, &line_len);
+
+    bytes += line_len;
+  }
+
+  return (bytes) ? ctx->words_cnt : 0;
+}
+
+static void bench_wordlist (const char *wordlist)
+{
+  FILE *fd = fopen (wordlist, "rb");
+
+  if (fd == NULL)
+  {
+    log_error ("ERROR: %s: %s", wordlist, strerror (errno));
+
+    return;
+  }
+
+  wl_data_t *wl_data = (wl_data_t *) mymalloc (sizeof (wl_data_t));
+
+  const uint segment_size = SEGMENT_SIZE * 1024 * 1024;
+
+  wl_data->buf   = (char *) mymalloc (segment_size);
+  wl_data->avail = segment_size;
+  wl_data->incr  = segment_size;
+  wl_data->cnt   = 0;
+  wl_data->pos   = 0;
+
+  // count the words get_next_word () will hand out, it does not signal the end of the stream itself
+
+  u64 words_cnt = 0;
+
+  while (!feof (fd))
+  {
+    load_segment (wl_data, fd);
+
+    while (wl_data->pos < wl_data->cnt)
+    {
+      uint off;
+      uint len;
+
+      get_next_word_func (wl_data->buf + wl_data->pos, wl_data->cnt - wl_data->pos, &len, &off);
+
+      wl_data->pos += off;
+
+      if (len > PW_MAX) continue;
+
+      words_cnt++;
+    }
+  }
+
+  bench_wordlist_ctx_t ctx;
+
+  ctx.fd        = fd;
+  ctx.wl_data   = wl_data;
+  ctx.words_cnt = words_cnt;
+
+  bench_run ("get_next_word", "std", bench_wordlist_func, &ctx);
+
+  myfree (wl_data->buf);
+  myfree (wl_data);
+
+  fclose (fd);
+}
+
+/**
+ * apply_rules
+ */
+
+typedef struct
+{
+  kernel_rule_t *rules_buf;
+  uint           rules_cnt;
+
+  pw_t          *pws_buf;
+  uint           pws_cnt;
+
+} bench_rules_ctx_t;
+
+static u64 bench_rules_func (void *p)
+{
+  bench_rules_ctx_t *ctx = (bench_rules_ctx_t *) p;
+
+  u32 sum = 0;
+
+  for (uint pws_pos = 0; pws_pos < ctx->pws_cnt; pws_pos++)
+  {
+    const pw_t *pw = &ctx->pws_buf[pws_pos];
+
+    for (uint rules_pos = 0; rules_pos < ctx->rules_cnt; rules_pos++)
+    {
+      u32 plain_buf[16];
+
+      memcpy (plain_buf, pw->i, sizeof (plain_buf));
+
+      sum += apply_rules (ctx->rules_buf[rules_pos].cmds, &plain_buf[0], &plain_buf[4], pw->pw_len);
+    }
+  }
+
+  return (sum) ? (u64) ctx->pws_cnt * ctx->rules_cnt : 0;
+}
+
+static void bench_rules (const char *wordlist, const char *rp_file)
+{
+  FILE *fp = fopen (rp_file, "rb");
+
+  if (fp == NULL)
+  {
+    log_error ("ERROR: %s: %s", rp_file, strerror (errno));
+
+    return;
+  }
+
+  bench_rules_ctx_t ctx;
+
+  memset (&ctx, 0, sizeof (ctx));
+
+  uint rules_avail = 0;
+
+  char *rule_buf = (char *) mymalloc (HCBUFSIZ);
+
+  while (!feof (fp))
+  {
+    const int rule_len = fgetl (fp, rule_buf);
+
+    if (rule_len == 0) continue;
+
+    if (rule_buf[0] == '#') continue;
+
+    if (rules_avail == ctx.rules_cnt)
+    {
+      ctx.rules_buf = (kernel_rule_t *) myrealloc (ctx.rules_buf, rules_avail * sizeof (kernel_rule_t), INCR_RULES * sizeof (kernel_rule_t));
+
+      rules_avail += INCR_RULES;
+    }
+
+    if (cpu_rule_to_kernel_rule (rule_buf, rule_len, &ctx.rules_buf[ctx.rules_cnt]) == -1) continue;
+
+    ctx.rules_cnt++;
+  }
+
+  fclose (fp);
+
+  FILE *fd = fopen (wordlist, "rb");
+
+  if (fd == NULL)
+  {
+    log_error ("ERROR: %s: %s", wordlist, strerror (errno));
+
+    myfree (rule_buf);
+    myfree (ctx.rules_buf);
+
+    return;
+  }
+
+  ctx.pws_buf = (pw_t *) mycalloc (BENCH_RULE_WORDS, sizeof (pw_t));
+
+  while (!feof (fd) && (ctx.pws_cnt < BENCH_RULE_WORDS))
+  {
+    const int line_len = fgetl (fd, rule_buf);
+
+    if (line_len == 0) continue;
+
+    if (line_len > 31) continue;
+
+    pw_t *pw = &ctx.pws_buf[ctx.pws_cnt];
+
+    memcpy (pw->i, rule_buf, line_len);
+
+    pw->pw_len = line_len;
+
+    ctx.pws_cnt++;
+  }
+
+  fclose (fd);
+
+  if (ctx.rules_cnt && ctx.pws_cnt) bench_run ("apply_rules", "best64", bench_rules_func, &ctx);
+
+  myfree (ctx.pws_buf);
+  myfree (ctx.rules_buf);
+  myfree (rule_buf);
+}
+
+/**
+ * digests: generate_bitmaps, sort + dedupe, potfile load
+ */
+
+typedef struct
+{
+  uint  digests_cnt;
+  char *digests_buf;
+
+  hash_t *hashes_buf;
+  hash_t *hashes_tmp;
+
+  uint  bitmap_mask;
+  uint  bitmap_size;
+  uint *bitmap_a;
+  uint *bitmap_b;
+  uint *bitmap_c;
+  uint *bitmap_d;
+
+} bench_digests_ctx_t;
+
+static u64 bench_bitmaps_func (void *p)
+{
+  bench_digests_ctx_t *ctx = (bench_digests_ctx_t *) p;
+
+  generate_bitmaps (ctx->digests_cnt, DGST_SIZE_4_4, 0, ctx->digests_buf, ctx->bitmap_mask, ctx->bitmap_size, ctx->bitmap_a, ctx->bitmap_b, ctx->bitmap_c, ctx->bitmap_d, -1);
+
+  return ctx->digests_cnt;
+}
+
+static u64 bench_dedupe_func (void *p)
+{
+  bench_digests_ctx_t *ctx = (bench_digests_ctx_t *) p;
+
+  hash_t *hashes_buf = ctx->hashes_tmp;
+
+  memcpy (hashes_buf, ctx->hashes_buf, ctx->digests_cnt * sizeof (hash_t));
+
+  qsort (hashes_buf, ctx->digests_cnt, sizeof (hash_t), sort_by_hash_no_salt);
+
+  uint hashes_cnt = 1;
+
+  for (uint hashes_pos = 1; hashes_pos < ctx->digests_cnt; hashes_pos++)
+  {
+    if (data.sort_by_digest (hashes_buf[hashes_pos].digest, hashes_buf[hashes_pos - 1].digest) == 0) continue;
+
+    if (hashes_pos > hashes_cnt)
+    {
+      memcpy (&hashes_buf[hashes_cnt], &hashes_buf[hashes_pos], sizeof (hash_t));
+    }
+
+    hashes_cnt++;
+  }
+
+  return (hashes_cnt) ? ctx->digests_cnt : 0;
+}
+
+typedef struct
+{
+  FILE  *pot_fp;
+
+  uint   pot_avail;
+  pot_t *pot;
+
+} bench_potfile_ctx_t;
+
+static u64 bench_potfile_func (void *p)
+{
+  bench_potfile_ctx_t *ctx = (bench_potfile_ctx_t *) p;
+
+  rewind (ctx->pot_fp);
+
+  return potfile_show_load (ctx->pot_fp, ctx->pot, ctx->pot_avail, md5_parse_hash, 0, DGST_SIZE_4_4, 0, 0);
+}
+
+static void bench_digests ()
+{
+  data.hash_mode      = 0;
+  data.opts_type      = OPTS_TYPE_PT_GENERATE_LE | OPTS_TYPE_PT_ADD80 | OPTS_TYPE_PT_ADDBITS14;
+  data.isSalted       = 0;
+  data.dgst_size      = DGST_SIZE_4_4;
+  data.dgst_pos0      = 0;
+  data.dgst_pos1      = 3;
+  data.dgst_pos2      = 2;
+  data.dgst_pos3      = 1;
+  data.sort_by_digest = sort_by_digest_4_4;
+
+  bench_digests_ctx_t ctx;
+
+  memset (&ctx, 0, sizeof (ctx));
+
+  ctx.digests_cnt = BENCH_DIGESTS;
+  ctx.digests_buf = (char *) mymalloc (BENCH_DIGESTS * DGST_SIZE_4_4);
+
+  ctx.hashes_buf = (hash_t *) mycalloc (BENCH_DIGESTS, sizeof (hash_t));
+  ctx.hashes_tmp = (hash_t *) mycalloc (BENCH_DIGESTS, sizeof (hash_t));
+
+  srand (0x1337);
+
+  u32 *digests_ptr = (u32 *) ctx.digests_buf;
+
+  for (uint i = 0; i < BENCH_DIGESTS * 4; i++)
+  {
+    digests_ptr[i] = ((u32) rand () << 16) ^ (u32) rand ();
+  }
+
+  // every 16th digest is a duplicate so the dedupe loop has something to do
+
+  for (uint i = 16; i < BENCH_DIGESTS; i += 16)
+  {
+    memcpy (digests_ptr + (i * 4), digests_ptr + ((i - 1) * 4), DGST_SIZE_4_4);
+  }
+
+  for (uint i = 0; i < BENCH_DIGESTS; i++)
+  {
+    ctx.hashes_buf[i].digest = ctx.digests_buf + (i * DGST_SIZE_4_4);
+  }
+
+  ctx.bitmap_mask = (1u << BENCH_BITMAP_BITS) - 1;
+  ctx.bitmap_size = (1u << BENCH_BITMAP_BITS) * sizeof (uint);
+  ctx.bitmap_a    = (uint *) mymalloc (ctx.bitmap_size);
+  ctx.bitmap_b    = (uint *) mymalloc (ctx.bitmap_size);
+  ctx.bitmap_c    = (uint *) mymalloc (ctx.bitmap_size);
+  ctx.bitmap_d    = (uint *) mymalloc (ctx.bitmap_size);
+
+  bench_run ("generate_bitmaps", "4_4", bench_bitmaps_func, &ctx);
+
+  bench_run ("dedupe_hashes", "4_4", bench_dedupe_func, &ctx);
+
+  // potfile: the same digests in hex with a short plain each
+
+  bench_potfile_ctx_t pot_ctx;
+
+  memset (&pot_ctx, 0, sizeof (pot_ctx));
+
+  pot_ctx.pot_fp = tmpfile ();
+
+  if (pot_ctx.pot_fp == NULL)
+  {
+    log_error ("ERROR: tmpfile(): %s", strerror (errno));
+  }
+  else
+  {
+    for (uint i = 0; i < BENCH_DIGESTS; i++)
+    {
+      const u8 *digest = (const u8 *) (ctx.digests_buf + (i * DGST_SIZE_4_4));
+
+      for (uint j = 0; j < 16; j++) fprintf (pot_ctx.pot_fp, "%02x", digest[j]);
+
+      fprintf (pot_ctx.pot_fp, ":plain%u\n", i);
+    }
+
+    pot_ctx.pot_avail = BENCH_DIGESTS;
+    pot_ctx.pot       = (pot_t *) mycalloc (BENCH_DIGESTS, sizeof (pot_t));
+
+    for (uint i = 0; i < BENCH_DIGESTS; i++)
+    {
+      pot_ctx.pot[i].hash.digest = mymalloc (DGST_SIZE_4_4);
+    }
+
+    bench_run ("potfile_load", "0", bench_potfile_func, &pot_ctx);
+
+    for (uint i = 0; i < BENCH_DIGESTS; i++)
+    {
+      myfree (pot_ctx.pot[i].hash.digest);
+    }
+
+    myfree (pot_ctx.pot);
+
+    fclose (pot_ctx.pot_fp);
+  }
+
+  myfree (ctx.bitmap_a);
+  myfree (ctx.bitmap_b);
+  myfree (ctx.bitmap_c);
+  myfree (ctx.bitmap_d);
+  myfree (ctx.hashes_tmp);
+  myfree (ctx.hashes_buf);
+  myfree (ctx.digests_buf);
+}
+
+/**
+ * sp_exec / mp_exec
+ */
+
+typedef struct
+{
+  cs_t *css_buf;
+  uint  css_cnt;
+
+  cs_t *root_css_buf;
+  cs_t *markov_css_buf;
+
+  u64   combs_cnt;
+  u64   ctx;
+
+} bench_gen_ctx_t;
+
+static u64 bench_sp_exec_func (void *p)
+{
+  bench_gen_ctx_t *ctx = (bench_gen_ctx_t *) p;
+
+  char pw_buf[SP_PW_MAX + 1] = { 0 };
+
+  for (uint i = 0; i < BENCH_GEN_LOOPS; i++)
+  {
+    sp_exec (ctx->ctx, pw_buf, ctx->root_css_buf, ctx->markov_css_buf, 0, ctx->css_cnt);
+
+    ctx->ctx = (ctx->ctx + 1) % ctx->combs_cnt;
+  }
+
+  return (pw_buf[0]) ? BENCH_GEN_LOOPS : 0;
+}
+
+static u64 bench_mp_exec_func (void *p)
+{
+  bench_gen_ctx_t *ctx = (bench_gen_ctx_t *) p;
+
+  char pw_buf[SP_PW_MAX + 1] = { 0 };
+
+  for (uint i = 0; i < BENCH_GEN_LOOPS; i++)
+  {
+    mp_exec (ctx->ctx, pw_buf, ctx->css_buf, ctx->css_cnt);
+
+    ctx->ctx = (ctx->ctx + 1) % ctx->combs_cnt;
+  }
+
+  return (pw_buf[0]) ? BENCH_GEN_LOOPS : 0;
+}
+
+static void bench_gen (const char *wordlist)
+{
+  // the markov statistics are trained from the wordlist, so the harness does not depend on an installed hashcat.hcstat
+
+  char hcstat[256] = { 0 };
+
+  snprintf (hcstat, sizeof (hcstat) - 1, "hashcat_bench.%d.hcstat", getpid ());
+
+  char *train_files[1] = { (char *) wordlist };
+
+  if (sp_train (hcstat, train_files, 1, HCSTAT_TRAIN_ORDER, 0, ':') != 0)
+  {
+    unlink (hcstat);
+
+    return;
+  }
+
+  cs_t *mp_sys = (cs_t *) mycalloc (6, sizeof (cs_t));
+  cs_t *mp_usr = (cs_t *) mycalloc (4, sizeof (cs_t));
+
+  mp_setup_sys (mp_sys);
+
+  bench_gen_ctx_t ctx;
+
+  memset (&ctx, 0, sizeof (ctx));
+
+  char mask[] = BENCH_MASK;
+
+  ctx.css_buf = mp_gen_css (mask, strlen (mask), mp_sys, mp_usr, &ctx.css_cnt);
+
+  uint uniq_tbls[SP_PW_MAX][CHARSIZ] = { { 0 } };
+
+  mp_css_to_uniq_tbl (ctx.css_cnt, ctx.css_buf, uniq_tbls);
+
+  hcstat_table_t *root_table_buf   = (hcstat_table_t *) mycalloc (SP_ROOT_CNT,   sizeof (hcstat_table_t));
+  hcstat_table_t *markov_table_buf = (hcstat_table_t *) mycalloc (SP_MARKOV_CNT, sizeof (hcstat_table_t));
+
+  sp_setup_tbl (NULL, hcstat, 0, 0, root_table_buf, markov_table_buf);
+
+  unlink (hcstat);
+
+  ctx.root_css_buf   = (cs_t *) mycalloc (SP_PW_MAX,           sizeof (cs_t));
+  ctx.markov_css_buf = (cs_t *) mycalloc (SP_PW_MAX * CHARSIZ, sizeof (cs_t));
+
+  sp_tbl_to_css (root_table_buf, markov_table_buf, ctx.root_css_buf, ctx.markov_css_buf, CHARSIZ, uniq_tbls);
+
+  ctx.combs_cnt = sp_get_sum (0, ctx.css_cnt, ctx.root_css_buf);
+
+  bench_run ("sp_exec", mask, bench_sp_exec_func, &ctx);
+
+  ctx.ctx = 0;
+
+  bench_run ("mp_exec", mask, bench_mp_exec_func, &ctx);
+
+  myfree (root_table_buf);
+  myfree (markov_table_buf);
+  myfree (ctx.root_css_buf);
+  myfree (ctx.markov_css_buf);
+  myfree (ctx.css_buf);
+  myfree (mp_sys);
+  myfree (mp_usr);
+}
+
+/**
+ * format_output
+ */
+
+typedef struct
+{
+  FILE *out_fp;
+
+  char *out_buf;
+
+  u8   *plain_ptr;
+  uint  plain_len;
+
+  uint  outfile_format;
+
+} bench_output_ctx_t;
+
+static u64 bench_output_func (void *p)
+{
+  bench_output_ctx_t *ctx = (bench_output_ctx_t *) p;
+
+  data.outfile_format = ctx->outfile_format;
+
+  for (uint i = 0; i < BENCH_PARSE_LOOPS; i++)
+  {
+    format_output (ctx->out_fp, ctx->out_buf, ctx->plain_ptr, ctx->plain_len, i, NULL, 0);
+  }
+
+  return BENCH_PARSE_LOOPS;
+}
+
+static void bench_output ()
+{
+  FILE *out_fp = fopen ("/dev/null", "wb");
+
+  if (out_fp == NULL)
+  {
+    log_error ("ERROR: /dev/null: %s", strerror (errno));
+
+    return;
+  }
+
+  data.username = 0;
+
+  bench_output_ctx_t ctx;
+
+  ctx.out_fp    = out_fp;
+  ctx.out_buf   = "8743b52063cd84097a65d1633f5c74f5";
+  ctx.plain_ptr = (u8 *) "hashcat";
+  ctx.plain_len = 7;
+
+  ctx.outfile_format = OUTFILE_FMT_HASH | OUTFILE_FMT_PLAIN;
+
+  bench_run ("format_output", "hash:plain", bench_output_func, &ctx);
+
+  ctx.outfile_format = OUTFILE_FMT_HASH | OUTFILE_FMT_PLAIN | OUTFILE_FMT_HEXPLAIN | OUTFILE_FMT_CRACKPOS;
+
+  bench_run ("format_output", "hash:plain:hex_plain:crack_pos", bench_output_func, &ctx);
+
+  fclose (out_fp);
+}
+
+/**
+ * host hooks
+ *
+ * process_hooks () runs against an in-memory stand-in for the OpenCL queue: d_hooks is a host buffer,
+ * reads and writes are a memcpy and complete at once, so only the host side of the hook pool is measured
+ */
+
+static cl_int CL_API_CALL bench_clEnqueueReadBuffer (cl_command_queue command_queue, cl_mem buffer, cl_bool blocking_read, size_t offset, size_t cb, const void *ptr, cl_uint num_events_in_wait_list, const cl_event *event_wait_list, cl_event *event)
+{
+  (void) command_queue;
+  (void) blocking_read;
+  (void) num_events_in_wait_list;
+  (void) event_wait_list;
+
+  memcpy ((void *) ptr, (char *) buffer + offset, cb);
+
+  if (event != NULL) *event = (cl_event) buffer;
+
+  return CL_SUCCESS;
+}
+
+static cl_int CL_API_CALL bench_clEnqueueWriteBuffer (cl_command_queue command_queue, cl_mem buffer, cl_bool blocking_write, size_t offset, size_t cb, const void *ptr, cl_uint num_events_in_wait_list, const cl_event *event_wait_list, cl_event *event)
+{
+  (void) command_queue;
+  (void) blocking_write;
+  (void) num_events_in_wait_list;
+  (void) event_wait_list;
+
+  memcpy ((char *) buffer + offset, ptr, cb);
+
+  if (event != NULL) *event = (cl_event) buffer;
+
+  return CL_SUCCESS;
+}
+
+static cl_int CL_API_CALL bench_clFlush (cl_command_queue command_queue)
+{
+  (void) command_queue;
+
+  return CL_SUCCESS;
+}
+
+static cl_int CL_API_CALL bench_clWaitForEvents (cl_uint num_events, const cl_event *event_list)
+{
+  (void) num_events;
+  (void) event_list;
+
+  return CL_SUCCESS;
+}
+
+static cl_int CL_API_CALL bench_clReleaseEvent (cl_event event)
+{
+  (void) event;
+
+  return CL_SUCCESS;
+}
+
+static void bench_hook_func (void *hook, const salt_t *salt, const void *esalt)
+{
+  // stands in for the decompress and CRC check of an archive format: crc32 of the payload into the first 4 bytes
+
+  (void) esalt;
+
+  u8 *buf = (u8 *) hook;
+
+  uint crc = ~salt->salt_buf[0];
+
+  for (uint pos = 4; pos < BENCH_HOOK_SIZE; pos++)
+  {
+    crc = crc32tab[(crc ^ buf[pos]) & 0xff] ^ (crc >> 8);
+  }
+
+  memcpy (buf, &crc, 4);
+}
+
+typedef struct
+{
+  hc_device_param_t *device_param;
+
+  uint  hook_threads;
+
+} bench_hooks_ctx_t;
+
+static u64 bench_hooks_func (void *p)
+{
+  bench_hooks_ctx_t *ctx = (bench_hooks_ctx_t *) p;
+
+  hc_device_param_t *device_param = ctx->device_param;
+
+  if (ctx->hook_threads == 0)
+  {
+    // the blocking round trip choose_kernel () did before the hook pool
+
+    hc_clEnqueueReadBuffer (data.ocl, device_param->command_queue, device_param->d_hooks, CL_TRUE, 0, device_param->size_hooks, device_param->hooks_buf, 0, NULL, NULL);
+
+    for (uint gid = 0; gid < BENCH_HOOK_CNT; gid++)
+    {
+      bench_hook_func ((char *) device_param->hooks_buf + ((size_t) gid * BENCH_HOOK_SIZE), &data.salts_buf[0], NULL);
+    }
+
+    hc_clEnqueueWriteBuffer (data.ocl, device_param->command_queue, device_param->d_hooks, CL_TRUE, 0, device_param->size_hooks, device_param->hooks_buf, 0, NULL, NULL);
+  }
+  else
+  {
+    data.hook_threads = ctx->hook_threads;
+
+    process_hooks (device_param, bench_hook_func, BENCH_HOOK_CNT);
+  }
+
+  return BENCH_HOOK_CNT;
+}
+
+static void bench_hooks ()
+{
+  hc_opencl_lib_t ocl;
+
+  memset (&ocl, 0, sizeof (hc_opencl_lib_t));
+
+  ocl.clEnqueueReadBuffer  = bench_clEnqueueReadBuffer;
+  ocl.clEnqueueWriteBuffer = bench_clEnqueueWriteBuffer;
+  ocl.clFlush              = bench_clFlush;
+  ocl.clWaitForEvents      = bench_clWaitForEvents;
+  ocl.clReleaseEvent       = bench_clReleaseEvent;
+
+  salt_t salt;
+
+  memset (&salt, 0, sizeof (salt_t));
+
+  salt.salt_buf[0] = 0x12345678;
+
+  data.ocl        = &ocl;
+  data.salts_buf  = &salt;
+  data.esalt_size = 0;
+  data.hook_size  = BENCH_HOOK_SIZE;
+
+  const size_t size_hooks = (size_t) BENCH_HOOK_CNT * BENCH_HOOK_SIZE;
+
+  hc_device_param_t *device_param = (hc_device_param_t *) mycalloc (1, sizeof (hc_device_param_t));
+
+  u8 *device_buf = (u8 *) mymalloc (size_hooks);
+  u8 *serial_buf = (u8 *) mymalloc (size_hooks);
+
+  device_param->d_hooks    = (cl_mem) device_buf;
+  device_param->hooks_buf  = mymalloc (size_hooks);
+  device_param->size_hooks = size_hooks;
+
+  device_param->kernel_params_buf32[27] = 0;
+
+  bench_hooks_ctx_t ctx;
+
+  ctx.device_param = device_param;
+
+  const uint cpu_cnt = MIN (get_cpu_cnt (), HOOK_THREADS_MAX);
+
+  // the pool has to leave the same hooks in d_hooks as the serial loop, also with a thread count that does not divide the hooks evenly
+
+  for (size_t pos = 0; pos < size_hooks; pos++) device_buf[pos] = (u8) ((pos * 2654435761u) >> 24);
+
+  ctx.hook_threads = 0;
+
+  bench_hooks_func (&ctx);
+
+  memcpy (serial_buf, device_buf, size_hooks);
+
+  const uint check_threads[2] = { 3, cpu_cnt };
+
+  for (uint check_pos = 0; check_pos < 2; check_pos++)
+  {
+    for (size_t pos = 0; pos < size_hooks; pos++) device_buf[pos] = (u8) ((pos * 2654435761u) >> 24);
+
+    ctx.hook_threads = check_threads[check_pos];
+
+    bench_hooks_func (&ctx);
+
+    if (memcmp (serial_buf, device_buf, size_hooks) != 0)
+    {
+      log_error ("ERROR: process_hooks() with %u threads left different hooks than the serial loop", ctx.hook_threads);
+
+      exit (-1);
+    }
+  }
+
+  ctx.hook_threads = 0;
+
+  bench_run ("process_hooks", "serial", bench_hooks_func, &ctx);
+
+  ctx.hook_threads = 1;
+
+  bench_run ("process_hooks", "hook_threads=1", bench_hooks_func, &ctx);
+
+  if (cpu_cnt > 1)
+  {
+    char variant[32];
+
+    snprintf (variant, sizeof (variant) - 1, "hook_threads=%u", cpu_cnt);
+
+    ctx.hook_threads = cpu_cnt;
+
+    bench_run ("process_hooks", variant, bench_hooks_func, &ctx);
+  }
+
+  myfree (device_param->hooks_buf);
+  myfree (device_param);
+  myfree (device_buf);
+  myfree (serial_buf);
+
+  data.ocl       = NULL;
+  data.salts_buf = NULL;
+}
+
+/**
+ * main
+ */
+
+int main (int argc, char **argv)
+{
+  const char *wordlist = BENCH_WORDLIST;
+  const char *rp_file  = BENCH_RULES;
+
+  if (argc > 1) bench_min_ms = atof (argv[1]);
+  if (argc > 2) wordlist     = argv[2];
+  if (argc > 3) rp_file      = argv[3];
+
+  if (bench_min_ms <= 0)
+  {
+    fprintf (stderr, "Usage: %s [min_ms] [wordlist] [rulefile]\n", argv[0]);
+
+    return -1;
+  }
+
+  memset (&data, 0, sizeof (hc_global_data_t));
+
+  data.quiet     = 1;
+  data.separator = ':';
+
+  get_next_word_func = get_next_word_std;
+
+  printf ("{\n");
+  printf ("  \"version\": \"%s\",\n", VERSION_TAG);
+  printf ("  \"min_ms\": %.0f,\n", bench_min_ms);
+  printf ("  \"results\":\n");
+  printf ("  [\n");
+
+  bench_parse_all ();
+
+  bench_decode ();
+
+  bench_wordlist (wordlist);
+
+  bench_rules (wordlist, rp_file);
+
+  bench_digests ();
+
+  bench_gen (wordlist);
+
+  bench_output ();
+
+  bench_hooks ();
+
+  printf ("\n  ]\n");
+  printf ("}\n");
+
+  return 0;
+}